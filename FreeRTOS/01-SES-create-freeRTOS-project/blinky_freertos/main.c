@@ -1,5 +1,7 @@
 #include "FreeRTOS.h"
+#include "app_diag.h"
 #include "app_error.h"
+#include "hw_blink.h"
 #include "nordic_common.h"
 #include "nrf_drv_clock.h"
 #include "nrf_gpio.h"
@@ -22,6 +24,12 @@ TaskHandle_t led_task_handle;
 #define LED_ON_TIME  pdMS_TO_TICKS(100)
 #define LED_OFF_TIME pdMS_TO_TICKS(500)
 
+// 1 = the PWM blinks the LEDs from the same on/off delays, no LED task is
+// created and the CPU only wakes for other work, see common/hw_blink.h
+#ifndef LED_HW_BLINK
+#define LED_HW_BLINK 0
+#endif
+
 /**
  * @brief LED toggle task function, needed in Task Creation function
  * 
@@ -67,7 +75,9 @@ static void init_leds()
 
 int main(void) 
 {
+#if !LED_HW_BLINK
     BaseType_t err = pdPASS;
+#endif
     ret_code_t err_code;
 
     // static variable will exist before and after the function has executed
@@ -81,8 +91,30 @@ int main(void)
     err_code = nrf_drv_clock_init();
     APP_ERROR_CHECK(err_code);
 
+    // RAM report, heap trace and sleep profiler, see app_diag.h
+    if(!app_diag_init())
+    {
+        return -1;
+    }
+
     init_leds();
 
+#if LED_HW_BLINK
+    static const uint16_t* const leds_on_off_delays[4] =
+    {
+        led1_on_off_delays, led2_on_off_delays, led3_on_off_delays, led4_on_off_delays
+    };
+
+    // the PWM takes the pins over from the GPIO set up above
+    if(hw_blink_start(leds_on_off_delays, 4) != NRF_SUCCESS)
+    {
+        return -1;
+    }
+
+    // wakes per second of the LED tasks below, computed. The sleep profile
+    // measures them for both builds
+    hw_blink_report();
+#else
     // Task 1 has control Pin and Values for LED 1
     err = xTaskCreate(my_led_toggle_task_function,      // callback function
                         "LED1",                         // Task Name  
@@ -134,6 +166,10 @@ int main(void)
     {
         return -1;
     }
+#endif
+
+    // stack guard and RAM power-down, see app_diag.h
+    app_diag_before_scheduler();
 
     /* Activate deep sleep mode */
     SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
@@ -9,6 +9,11 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "nrf_drv_clock.h"
+#include "app_diag.h"
+#include "stack_guard_bench.h"
+
+// 1 = only run the stack guard against pattern check benchmark
+#define RUN_STACK_GUARD_BENCHMARK 0
 
 // for task reference
 TaskHandle_t task1_handle;
@@ -40,7 +45,23 @@ int main(void)
   /* Initialize clock driver for better time accuracy in FREERTOS */
   err_code = nrf_drv_clock_init();
   APP_ERROR_CHECK(err_code);
-  
+
+  // RAM report, heap trace and sleep profiler, see app_diag.h
+  if(!app_diag_init())
+  {
+    return -1;
+  }
+
+#if RUN_STACK_GUARD_BENCHMARK
+  task_err = stack_guard_bench_start();
+
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Bench create fail\r\n");
+    return -1;
+  }
+#else
   // task creation function
   // starts with 'x' means it returns BaseType_t value
   // which can be either pdPASS or pdFAIL
@@ -59,6 +80,10 @@ int main(void)
     printf("Task create fail\r\n");
     return -1;
   }
+#endif
+
+  // stack guard and RAM power-down, see app_diag.h
+  app_diag_before_scheduler();
 
   /* Activate deep sleep mode */
   SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
@@ -0,0 +1,154 @@
+/*
+  Per-switch cost of the MPU stack guard against the pattern check
+
+  - guard: stack_guard_switch() on two alternating stacks, what
+    traceTASK_SWITCHED_IN() adds to every switch
+  - pattern: the configCHECK_FOR_STACK_OVERFLOW 2 test of stack_macros.h,
+    four words at the stack bottom compared with the fill pattern, what
+    that method adds to every switch
+  - switch: a full context switch with the guard in place, two tasks
+    passing a notification back and forth
+
+  With BENCH_OVERFLOW 1 a task then recurses until it overflows, the guard
+  stops it at the first push below its stack.
+*/
+
+#include "stack_guard_bench.h"
+#include "task.h"
+#include "stack_guard.h"
+#include "cycle_counter.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+#if !STACK_GUARD_ENABLED
+#error "stack_guard_bench.c needs STACK_GUARD_ENABLED 1 in FreeRTOSConfig.h"
+#endif
+
+#define BENCH_COUNT       10000
+#define BENCH_SWITCHES    2000
+#define BENCH_OVERFLOW    0
+
+#define FILL_WORD         0xa5a5a5a5UL
+#define FAKE_STACK_WORDS  64
+
+#if STACK_GUARD_SIZE > FAKE_STACK_WORDS * 4
+#error "the guard must fit a fake stack"
+#endif
+
+// stand-ins for two task stacks, nothing runs on them. Aligned to the guard,
+// which then covers the first STACK_GUARD_SIZE bytes of each, wherever the
+// linker puts them
+static StackType_t m_fake_stacks[2][FAKE_STACK_WORDS] __attribute__((aligned(STACK_GUARD_SIZE)));
+
+static TaskHandle_t m_bench_task;
+static TaskHandle_t m_partner_task;
+
+// same test as taskCHECK_FOR_STACK_OVERFLOW() with method 2
+static bool pattern_intact(const volatile uint32_t* p_stack)
+{
+  return (p_stack[0] == FILL_WORD) && (p_stack[1] == FILL_WORD) &&
+         (p_stack[2] == FILL_WORD) && (p_stack[3] == FILL_WORD);
+}
+
+static void partner_task(void* pvParameters)
+{
+  while(true)
+  {
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    xTaskNotifyGive(m_bench_task);
+  }
+}
+
+#if BENCH_OVERFLOW
+static uint32_t recurse(uint32_t depth)
+{
+  volatile uint32_t frame[4] = { depth, depth, depth, depth };
+  return frame[0] + recurse(depth + 1);
+}
+
+static void overflow_task(void* pvParameters)
+{
+  printf("Overflowing the stack of OVF\r\n");
+  printf("%u\r\n", (unsigned)recurse(0));
+  vTaskDelete(NULL);
+}
+#endif
+
+static void bench_task(void* pvParameters)
+{
+  uint32_t start;
+  uint32_t guard_cycles;
+  uint32_t pattern_cycles;
+  uint32_t switch_cycles;
+  uint32_t intact = 0;
+
+  cycle_counter_init();
+
+  for(uint32_t i = 0; i < FAKE_STACK_WORDS; i++)
+  {
+    m_fake_stacks[0][i] = FILL_WORD;
+    m_fake_stacks[1][i] = FILL_WORD;
+  }
+
+  taskENTER_CRITICAL();
+
+  // while the guard is still on this task, the words the pattern check reads
+  // are inside the guard of a fake stack once it moved there
+  start = cycle_counter_get();
+  for(uint32_t i = 0; i < BENCH_COUNT; i++) intact += pattern_intact(m_fake_stacks[i & 1]);
+  pattern_cycles = cycle_counter_get() - start;
+
+  start = cycle_counter_get();
+  for(uint32_t i = 0; i < BENCH_COUNT; i++) stack_guard_switch(m_fake_stacks[i & 1]);
+  guard_cycles = cycle_counter_get() - start;
+
+  taskEXIT_CRITICAL();
+
+  // the guard is on a fake stack now, a yield puts it back on this task
+  taskYIELD();
+
+  // two switches per round trip
+  start = cycle_counter_get();
+  for(uint32_t i = 0; i < BENCH_SWITCHES / 2; i++)
+  {
+    xTaskNotifyGive(m_partner_task);
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  }
+  switch_cycles = cycle_counter_get() - start;
+
+  printf("\r\nCycles per context switch, %u calls\r\n", (unsigned)BENCH_COUNT);
+  printf("MPU guard move         %4u\r\n", (unsigned)(guard_cycles / BENCH_COUNT));
+  printf("pattern check          %4u (%u intact)\r\n", (unsigned)(pattern_cycles / BENCH_COUNT), (unsigned)intact);
+  printf("notify + switch, guard %4u\r\n", (unsigned)(switch_cycles / BENCH_SWITCHES));
+
+#if BENCH_OVERFLOW
+  (void)xTaskCreate(overflow_task, "OVF", configMINIMAL_STACK_SIZE + 40, NULL, 1, NULL);
+#endif
+
+  vTaskDelete(m_partner_task);
+  vTaskDelete(NULL);
+}
+
+BaseType_t stack_guard_bench_start(void)
+{
+  BaseType_t task_err;
+
+  task_err = xTaskCreate(
+                          partner_task,                   // pointer to the task function
+                          "PTN",                          // task name mainly for debugging
+                          configMINIMAL_STACK_SIZE,       // task stack depth in words
+                          NULL,                           // task arguments
+                          2,                              // same as the benchmark, plain handover
+                          &m_partner_task
+                        );
+  if(task_err == pdFAIL) return pdFAIL;
+
+  return xTaskCreate(
+                      bench_task,                     // pointer to the task function
+                      "BNC",                          // task name mainly for debugging
+                      configMINIMAL_STACK_SIZE + 200, // task stack depth in words
+                      NULL,                           // task arguments
+                      2,                              // above the example tasks
+                      &m_bench_task
+                    );
+}
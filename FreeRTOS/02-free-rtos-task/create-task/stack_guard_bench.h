@@ -0,0 +1,17 @@
+/*
+  Per-switch cost of the MPU stack guard against the pattern check
+*/
+
+#ifndef STACK_GUARD_BENCH_H
+#define STACK_GUARD_BENCH_H
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Create the benchmark tasks, results are printed when they finish
+ *
+ * @return pdPASS or pdFAIL on insufficient heap memory
+ */
+BaseType_t stack_guard_bench_start(void);
+
+#endif /* STACK_GUARD_BENCH_H */
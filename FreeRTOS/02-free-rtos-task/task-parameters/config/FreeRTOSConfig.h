@@ -88,6 +88,22 @@
 #define configUSE_TRACE_FACILITY                                                  0
 #define configUSE_STATS_FORMATTING_FUNCTIONS                                      0
 
+/* TLSF heap over all free RAM, see common/heap_tlsf.h */
+#define HEAP_TLSF_LINKER_REGIONS                                                  1
+#define HEAP_TLSF_MALLOC                                                          1
+
+/* Heap call-site trace, see common/heap_trace.h */
+#define HEAP_TRACE_ENABLED                                                        0
+
+/* RAM sections power-down, see common/ram_power.h */
+#define RAM_POWER_ENABLED                                                         0
+
+/* Tickless idle sleep profiler, see common/sleep_prof.h */
+#define SLEEP_PROF_ENABLED                                                        0
+
+/* MPU stack guard, see common/stack_guard.h */
+#define STACK_GUARD_ENABLED                                                       0
+
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES                                                     0
 #define configMAX_CO_ROUTINE_PRIORITIES                                           ( 2 )
@@ -174,6 +190,9 @@ standard names - or at least those used in the unmodified vector table. */
 #if !(defined(__ASSEMBLY__) || defined(__ASSEMBLER__))
     #include "nrf.h"
     #include "nrf_assert.h"
+    #include "heap_trace.h"     /* traceMALLOC() / traceFREE() with HEAP_TRACE_ENABLED */
+    #include "stack_guard.h"    /* traceTASK_SWITCHED_IN() with STACK_GUARD_ENABLED */
+    #include "sleep_prof.h"     /* config{PRE,POST}_SLEEP_PROCESSING() with SLEEP_PROF_ENABLED */
 
     /* This part of definitions may be problematic in assembly - it uses definitions from files that are not assembly compatible. */
     /* Cortex-M specific definitions. */
@@ -9,6 +9,7 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "nrf_drv_clock.h"
+#include "app_diag.h"
 
 // for task reference
 TaskHandle_t task1_handle;
@@ -42,6 +43,12 @@ int main(void)
   /* Initialize clock driver for better time accuracy in FREERTOS */
   err_code = nrf_drv_clock_init();
   APP_ERROR_CHECK(err_code);
+
+  // RAM report, heap trace and sleep profiler, see app_diag.h
+  if(!app_diag_init())
+  {
+    return -1;
+  }
   
   // defined constant to not use task stack
   static const char *msg = "Task 1 function\r\n";
@@ -83,6 +90,9 @@ int main(void)
     return -1;
   }
 
+  // stack guard and RAM power-down, see app_diag.h
+  app_diag_before_scheduler();
+
   /* Activate deep sleep mode */
   SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
 
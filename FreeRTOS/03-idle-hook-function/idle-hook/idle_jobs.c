@@ -0,0 +1,151 @@
+/*
+  Background jobs of the idle hook example, see idle_jobs.h
+*/
+
+#include "idle_jobs.h"
+#include "FreeRTOS.h"
+#include "idle_work.h"
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// lines waiting for the flush job, must be a power of 2
+#define LOG_LINES           8
+#define LOG_LINE_SIZE       48
+#define LOG_DEFER_MS        200
+
+#define SCRUB_SLICE_BYTES   1024
+#define SCRUB_DEFER_MS      5000
+
+// flash_placement.xml, the image starts with the vector table and the
+// read-only part ends where .ARM.exidx starts
+extern const uint8_t __app_flash_start[];
+extern const uint8_t __exidx_start[];
+
+typedef struct
+{
+  const uint32_t* p_next;
+  uint32_t sum1;
+  uint32_t sum2;
+  uint32_t reference;
+  bool reference_valid;
+}scrub_t;
+
+static char m_log_lines[LOG_LINES][LOG_LINE_SIZE];
+static volatile uint32_t m_log_head = 0;    // written by the logging task
+static volatile uint32_t m_log_tail = 0;    // written by the flush job
+
+static scrub_t m_scrub;
+
+// the idle task runs on configMINIMAL_STACK_SIZE words, too few for
+// printf(), the jobs only write characters. Lines are formatted by
+// idle_jobs_log() on the stack of the logging task
+static void str_write(const char* p_str)
+{
+  while(*p_str != '\0')
+  {
+    (void)putchar((unsigned char)*p_str++);
+  }
+}
+
+static void hex_write(uint32_t value)
+{
+  for(int shift = 28; shift >= 0; shift -= 4)
+  {
+    (void)putchar("0123456789abcdef"[(value >> shift) & 0xf]);
+  }
+}
+
+static bool log_flush(void* p_context)
+{
+  if(m_log_tail == m_log_head) return false;
+
+  str_write(m_log_lines[m_log_tail % LOG_LINES]);
+  m_log_tail++;
+
+  return m_log_tail != m_log_head;
+}
+
+static bool flash_scrub(void* p_context)
+{
+  scrub_t* p_scrub = p_context;
+  const uint32_t* p_end = (const uint32_t*)__exidx_start;
+  const uint32_t* p_slice_end;
+  uint32_t sum1 = p_scrub->sum1;
+  uint32_t sum2 = p_scrub->sum2;
+
+  if(p_scrub->p_next == NULL)
+  {
+    p_scrub->p_next = (const uint32_t*)__app_flash_start;
+    sum1 = 0xffff;
+    sum2 = 0xffff;
+  }
+
+  p_slice_end = p_scrub->p_next + SCRUB_SLICE_BYTES / sizeof(uint32_t);
+  if(p_slice_end > p_end) p_slice_end = p_end;
+
+  // Fletcher-32 over 16-bit halves, folded once per word so the sums never
+  // overflow
+  for(const uint32_t* p_word = p_scrub->p_next; p_word < p_slice_end; p_word++)
+  {
+    sum1 += *p_word & 0xffff;
+    sum2 += sum1;
+    sum1 += *p_word >> 16;
+    sum2 += sum1;
+    sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+    sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+  }
+  p_scrub->p_next = p_slice_end;
+  p_scrub->sum1 = sum1;
+  p_scrub->sum2 = sum2;
+
+  if(p_slice_end < p_end) return true;
+
+  // pass done
+  uint32_t checksum = ((sum2 & 0xffff) << 16) | (sum1 & 0xffff);
+  if(!p_scrub->reference_valid)
+  {
+    p_scrub->reference = checksum;
+    p_scrub->reference_valid = true;
+  }
+  else if(checksum != p_scrub->reference)
+  {
+    str_write("Flash scrub mismatch ");
+    hex_write(checksum);
+    str_write(", expected ");
+    hex_write(p_scrub->reference);
+    str_write("\r\n");
+  }
+  p_scrub->p_next = NULL;
+
+  return false;
+}
+
+IDLE_WORK_JOB_DEF(m_log_flush_job, log_flush, NULL, LOG_DEFER_MS);
+IDLE_WORK_JOB_DEF(m_flash_scrub_job, flash_scrub, &m_scrub, SCRUB_DEFER_MS);
+
+void idle_jobs_init(void)
+{
+  idle_work_register(&m_log_flush_job);
+  idle_work_register(&m_flash_scrub_job);
+}
+
+bool idle_jobs_log(const char* fmt, ...)
+{
+  va_list args;
+
+  if(m_log_head - m_log_tail >= LOG_LINES) return false;
+
+  va_start(args, fmt);
+  (void)vsnprintf(m_log_lines[m_log_head % LOG_LINES], LOG_LINE_SIZE, fmt, args);
+  va_end(args);
+  m_log_head++;
+
+  idle_work_kick(&m_log_flush_job);
+  return true;
+}
+
+void idle_jobs_scrub_kick(void)
+{
+  idle_work_kick(&m_flash_scrub_job);
+}
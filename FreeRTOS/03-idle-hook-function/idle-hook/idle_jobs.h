@@ -0,0 +1,35 @@
+/*
+  Background jobs of the idle hook example, run by common/idle_work.c
+
+  - log flush: lines queued by idle_jobs_log() are printed one per slice,
+    within 200 ms of the first queued line. The caller formats them, the
+    idle stack is too small for printf()
+  - flash scrub: a Fletcher-32 checksum of the application code and
+    read-only data, 1 KB per slice. The first pass keeps the result, later
+    passes compare against it, within 5 s of idle_jobs_scrub_kick()
+*/
+
+#ifndef IDLE_JOBS_H
+#define IDLE_JOBS_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Register the jobs, call from main() before vTaskStartScheduler()
+ */
+void idle_jobs_init(void);
+
+/**
+ * @brief Queue a log line for the flush job, from one task only. Lines
+ *        are dropped while the queue is full
+ *
+ * @return false if dropped
+ */
+bool idle_jobs_log(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief Start a scrub pass, ignored while one is running
+ */
+void idle_jobs_scrub_kick(void);
+
+#endif /* IDLE_JOBS_H */
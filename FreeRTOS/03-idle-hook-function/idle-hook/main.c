@@ -9,6 +9,10 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "nrf_drv_clock.h"
+#include "app_diag.h"
+#include "idle_work.h"
+#include "idle_jobs.h"
+#include "load_meter.h"
 
 // for task reference
 TaskHandle_t task1_handle;
@@ -22,13 +26,27 @@ void task1_function(void* pvParameters)
 {
   // cast void Pointer to char Pointer
   char *arg = (char*) pvParameters;
+  uint32_t loops = 0;
     
   // task's infinite loop which must not exit or return
   // if a task is not required, it should be explicitly deleted
   while(true)
   {
-    printf(arg);
-    printf("Counter = %ul\r\n", counter);
+    // printed later by the log flush job of the idle task
+    (void)idle_jobs_log("%s", arg);
+    (void)idle_jobs_log("Counter = %u\r\n", (unsigned)counter);
+    (void)idle_jobs_log("Load 100ms %u.%u%% 1s %u.%u%% 10s %u.%u%%\r\n",
+                        (unsigned)(load_meter_get(LOAD_METER_100MS) / 10), (unsigned)(load_meter_get(LOAD_METER_100MS) % 10),
+                        (unsigned)(load_meter_get(LOAD_METER_1S) / 10), (unsigned)(load_meter_get(LOAD_METER_1S) % 10),
+                        (unsigned)(load_meter_get(LOAD_METER_10S) / 10), (unsigned)(load_meter_get(LOAD_METER_10S) % 10));
+
+    // a flash scrub pass every 10 s, whenever the idle task gets to it
+    if(++loops % 10 == 0)
+    {
+      idle_jobs_scrub_kick();
+      idle_work_print();
+    }
+
     vTaskDelay(pdMS_TO_TICKS(1000));  // v = void return type and function is defined in task.c
   }
 
@@ -43,7 +61,12 @@ void task1_function(void* pvParameters)
 void vApplicationIdleHook(void)
 {
   // code in this hook must not block or suspend 
+  // the pass is timed from here, keep it first
+  load_meter_idle_hook();
   counter++;
+
+  // slices of the background jobs, within IDLE_WORK_BUDGET_CYCLES
+  idle_work_run();
 }
 
 int main(void)
@@ -54,6 +77,22 @@ int main(void)
   /* Initialize clock driver for better time accuracy in FREERTOS */
   err_code = nrf_drv_clock_init();
   APP_ERROR_CHECK(err_code);
+
+  // RAM report, heap trace and sleep profiler, see app_diag.h
+  if(!app_diag_init())
+  {
+    return -1;
+  }
+
+  // log flush and flash scrub jobs run by vApplicationIdleHook()
+  idle_jobs_init();
+
+  // calibrated CPU load, 100 ms, 1 s and 10 s averages
+  if(!load_meter_start())
+  {
+    printf("Load meter create fail\r\n");
+    return -1;
+  }
   
   // defined constant to not use task stack
   static const char *msg = "Task 1 function\r\n";
@@ -77,6 +116,9 @@ int main(void)
     return -1;
   }
 
+  // stack guard and RAM power-down, see app_diag.h
+  app_diag_before_scheduler();
+
   /* Activate deep sleep mode */
   SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
 
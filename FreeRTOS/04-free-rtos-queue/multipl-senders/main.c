@@ -11,6 +11,7 @@
 #include "task.h"
 #include "queue.h"
 #include "nrf_drv_clock.h"
+#include "app_diag.h"
 
 QueueHandle_t queue_handle;
 
@@ -110,6 +111,12 @@ int main(void)
   err_code = nrf_drv_clock_init();
   APP_ERROR_CHECK(err_code);
 
+  // RAM report, heap trace and sleep profiler, see app_diag.h
+  if(!app_diag_init())
+  {
+    return -1;
+  }
+
   queue_handle = xQueueCreate(3, sizeof(queue_data_t));
 
   if(queue_handle != NULL)
@@ -166,6 +173,9 @@ int main(void)
       return -1;
     }
 
+    // stack guard and RAM power-down, see app_diag.h
+    app_diag_before_scheduler();
+
     /* Activate deep sleep mode */
     SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
 
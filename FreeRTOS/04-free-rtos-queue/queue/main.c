@@ -10,6 +10,22 @@
 #include "task.h"
 #include "queue.h"
 #include "nrf_drv_clock.h"
+#include "boards.h"
+#include "app_diag.h"
+#include "queue_bench.h"
+#include "mono_time.h"
+#include "button_input.h"
+
+// 1 = only run the queue benchmark in queue_bench.c, the host Makefile sets
+// it for make bench
+#ifndef RUN_QUEUE_BENCHMARK
+#define RUN_QUEUE_BENCHMARK 0
+#endif
+// 1 = only run the button input of common/button_input.c, events of the 4
+// board buttons come through a queue
+#ifndef RUN_BUTTON_INPUT
+#define RUN_BUTTON_INPUT 0
+#endif
 
 // for task reference
 TaskHandle_t qwr_handle;
@@ -20,6 +36,29 @@ QueueHandle_t queue_handle;
 static const size_t q_size = 10;
 static const size_t q_data_bytes = sizeof(char);
 
+#if RUN_BUTTON_INPUT
+// for the button events
+QueueHandle_t button_queue_handle;
+static const size_t button_q_size = 8;
+static const uint32_t k_button_pins[] = { BUTTON_1, BUTTON_2, BUTTON_3, BUTTON_4 };
+
+// blocks on the queue, the CPU sleeps until a button moves
+void button_task_function(void* pvParameters)
+{
+  button_evt_t evt;
+
+  while(true)
+  {
+    if(xQueueReceive(button_queue_handle, &evt, portMAX_DELAY) != pdPASS) continue;
+
+    button_input_taken(&evt);
+    printf("Button %u %s\r\n", (unsigned)evt.button + 1, button_input_type_name((button_evt_type_t)evt.type));
+
+    // long press of button 1 prints the counts and latencies
+    if(evt.button == 0 && evt.type == BUTTON_EVT_LONG_PRESS) button_input_report();
+  }
+}
+#endif
 
 // user defined Task function which must return void and take a void pointer parameter
 // pv = pointer to void
@@ -47,7 +86,7 @@ void q_writer_task_function(void* pvParameters)
         status = xQueueSendToBack(queue_handle, &items[i], k_wait);
         if(status != pdPASS)
         {
-          printf("Couldn't write to queue, Err = %d\r\n", status);
+          printf("Couldn't write to queue, Err = %d\r\n", (int)status);
         }
       }
       printf("Queue data written\r\n");
@@ -76,13 +115,13 @@ void q_reader_task_function(void* pvParameters)
     UBaseType_t count = uxQueueMessagesWaiting(queue_handle);
     if(count)
     {
-      printf("%u Queue data available to read\r\n", count);
+      printf("%u Queue data available to read\r\n", (unsigned)count);
       for(size_t i=0; i<count; ++i)
       {
         status = xQueueReceive(queue_handle, &rd_val, k_wait);
         if(status != pdPASS)
         {
-          printf("Couldn't read from queue, Err = %d\r\n", status);
+          printf("Couldn't read from queue, Err = %d\r\n", (int)status);
         }
         else
         {
@@ -109,6 +148,63 @@ int main(void)
   err_code = nrf_drv_clock_init();
   APP_ERROR_CHECK(err_code);
 
+  // RAM report, heap trace and sleep profiler, see app_diag.h
+  if(!app_diag_init())
+  {
+    return -1;
+  }
+
+#if RUN_QUEUE_BENCHMARK
+  task_err = queue_bench_start();
+
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Bench create fail\r\n");
+    return -1;
+  }
+
+  // without the example queue and tasks, never returns
+  app_diag_before_scheduler();
+  SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+  vTaskStartScheduler();
+#elif RUN_BUTTON_INPUT
+  // start the 64-bit time base of the latencies, needs the clock driver
+  err_code = mono_time_init();
+  APP_ERROR_CHECK(err_code);
+
+  button_queue_handle = xQueueCreate(button_q_size, sizeof(button_evt_t));
+  if(button_queue_handle == NULL)
+  {
+    printf("Button queue create fail\r\n");
+    return -1;
+  }
+
+  err_code = button_input_init(k_button_pins, sizeof(k_button_pins) / sizeof(k_button_pins[0]), button_queue_handle);
+  APP_ERROR_CHECK(err_code);
+
+  task_err = xTaskCreate(
+                          button_task_function,           // pointer to the task function
+                          "Task3",                        // task name mainly for debugging
+                          configMINIMAL_STACK_SIZE + 200, // task stack depth in words
+                          NULL,                           // task arguments
+                          1,                              // task priority
+                          NULL
+                        );
+
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Task 3 create fail\r\n");
+    return -1;
+  }
+
+  // without the example queue and tasks, never returns
+  app_diag_before_scheduler();
+  SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+  vTaskStartScheduler();
+#endif
+
   queue_handle = xQueueCreate(q_size, q_data_bytes);
   
   // defined constant to not use task stack
@@ -154,6 +250,9 @@ int main(void)
       return -1;
     }
 
+    // stack guard and RAM power-down, see app_diag.h
+    app_diag_before_scheduler();
+
     /* Activate deep sleep mode */
     SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
 
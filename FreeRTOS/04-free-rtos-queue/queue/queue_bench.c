@@ -0,0 +1,121 @@
+/*
+  Queue primitives on the benchmark harness
+
+  Cycles of one call, with the item size of this example (one char):
+  - send: xQueueSendToBack() to an empty queue, no task waiting
+  - receive: xQueueReceive() of the only item
+  - send_full: xQueueSendToBack() to a full queue with no wait, the
+    overflow path of producers that must not block
+  - send_wake: xQueueSendToBack() to a higher priority receiver blocked on
+    the queue, the round trip through its receive and back into its wait
+
+  Results are JSON lines of common/bench.h, compare them against a baseline
+  with tools/bench_compare.py.
+*/
+
+#include "queue_bench.h"
+#include "task.h"
+#include "queue.h"
+#include "bench.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+#define BENCH_WARMUP      16
+#define BENCH_ITERATIONS  256
+
+static QueueHandle_t m_queue;       // bench task only
+static QueueHandle_t m_full_queue;  // one item, always full
+static QueueHandle_t m_wake_queue;  // receiver task blocked on it
+
+static void queue_empty(void* p_context)
+{
+  (void)xQueueReset(m_queue);
+}
+
+static void queue_one_item(void* p_context)
+{
+  const char item = 'x';
+
+  (void)xQueueReset(m_queue);
+  (void)xQueueSendToBack(m_queue, &item, 0);
+}
+
+static void send_run(void* p_context)
+{
+  const char item = 'x';
+  (void)xQueueSendToBack(m_queue, &item, 0);
+}
+
+static void receive_run(void* p_context)
+{
+  char item;
+  (void)xQueueReceive(m_queue, &item, 0);
+}
+
+static void send_full_run(void* p_context)
+{
+  const char item = 'x';
+  (void)xQueueSendToBack(m_full_queue, &item, 0);
+}
+
+static void send_wake_run(void* p_context)
+{
+  const char item = 'x';
+  (void)xQueueSendToBack(m_wake_queue, &item, 0);
+}
+
+static const bench_case_t k_cases[] =
+{
+  { .name = "send",      .setup = queue_empty,    .run = send_run,      .warmup = BENCH_WARMUP, .iterations = BENCH_ITERATIONS },
+  { .name = "receive",   .setup = queue_one_item, .run = receive_run,   .warmup = BENCH_WARMUP, .iterations = BENCH_ITERATIONS },
+  { .name = "send_full", .setup = NULL,           .run = send_full_run, .warmup = BENCH_WARMUP, .iterations = BENCH_ITERATIONS },
+  { .name = "send_wake", .setup = NULL,           .run = send_wake_run, .warmup = BENCH_WARMUP, .iterations = BENCH_ITERATIONS },
+};
+
+static void receiver_task(void* pvParameters)
+{
+  char item;
+
+  while(true)
+  {
+    (void)xQueueReceive(m_wake_queue, &item, portMAX_DELAY);
+  }
+}
+
+static void bench_task(void* pvParameters)
+{
+  bench_suite_run("queue", k_cases, sizeof(k_cases) / sizeof(k_cases[0]));
+  vTaskDelete(NULL);
+}
+
+BaseType_t queue_bench_start(void)
+{
+  const char item = 'x';
+  BaseType_t err;
+
+  m_queue = xQueueCreate(1, sizeof(char));
+  m_full_queue = xQueueCreate(1, sizeof(char));
+  m_wake_queue = xQueueCreate(1, sizeof(char));
+  if(m_queue == NULL || m_full_queue == NULL || m_wake_queue == NULL) return pdFAIL;
+
+  (void)xQueueSendToBack(m_full_queue, &item, 0);
+
+  err = xTaskCreate(
+                     receiver_task,                  // pointer to the task function
+                     "QRX",                          // task name mainly for debugging
+                     configMINIMAL_STACK_SIZE + 40,  // task stack depth in words
+                     NULL,                           // task arguments
+                     2,                              // preempts the bench task on each send
+                     NULL
+                   );
+  if(err != pdPASS) return err;
+
+  return xTaskCreate(
+                      bench_task,                     // pointer to the task function
+                      "BNC",                          // task name mainly for debugging
+                      configMINIMAL_STACK_SIZE + 200, // task stack depth in words
+                      NULL,                           // task arguments
+                      1,                              // below the receiver
+                      NULL
+                    );
+}
@@ -0,0 +1,18 @@
+/*
+  Queue primitives on the benchmark harness
+*/
+
+#ifndef QUEUE_BENCH_H
+#define QUEUE_BENCH_H
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Create the benchmark tasks, JSON results are printed when they
+ *        finish
+ *
+ * @return pdPASS or pdFAIL on insufficient heap memory
+ */
+BaseType_t queue_bench_start(void);
+
+#endif /* QUEUE_BENCH_H */
@@ -4,43 +4,62 @@
   Book: Mastering the FreeRTOS
   Refer Chapter 1: 1.5 Data Types and Coding Style
   Refer Chapter 4: 4.5 Working with Large or Variable Sized Data
+
+  The strings, the queue and both tasks come from fixed-block pools of
+  common/obj_pool.h instead of the heap: the writer takes a buffer from the
+  pool, the reader gives it back once printed.
 */
 
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
 #include "nrf_drv_clock.h"
+#include "app_diag.h"
+#include "obj_pool.h"
+#include "pool_bench.h"
+
+// 1 = only run the pool against heap benchmark in pool_bench.c
+#define RUN_POOL_BENCHMARK 0
+
+#define Q_SIZE        5
+#define Q_DATA_BYTES  sizeof(char*)
+#define STR_LEN       50
+
+// one string per queue entry plus the one the writer is filling
+OBJ_POOL_DEF(m_string_pool, STR_LEN, Q_SIZE + 1);
+OBJ_POOL_QUEUE_DEF(m_queue_pool, Q_SIZE, Q_DATA_BYTES, 1);
+OBJ_POOL_TASK_DEF(m_task_pool, configMINIMAL_STACK_SIZE + 200, 2);
 
 // for accessing the queue
 QueueHandle_t pointer_q;
 
-static const size_t q_size = 5;
-static const size_t q_data_bytes = sizeof(char*);
-
 
 void q_writer_task_function(void* pvParameters)
 {
-  const size_t str_len = 50;
-  char array[str_len];
-  char* string_to_send = &array[0];
+  char* string_to_send;
   BaseType_t str_num = 0;
   printf("%s", (char*)pvParameters);
 
   while(true)
   {
+    // a new buffer for every string, the reader owns it once queued
+    string_to_send = obj_pool_alloc(&m_string_pool);
     if(string_to_send != NULL)
     {
-      snprintf(string_to_send, str_len, "Sending string number %d\r\n", str_num);
+      snprintf(string_to_send, STR_LEN, "Sending string number %d\r\n", (int)str_num);
       
       // same as send to back
-      xQueueSend(pointer_q, &string_to_send, 0);
-      vTaskDelay(200);
+      if(xQueueSend(pointer_q, &string_to_send, 0) != pdPASS)
+      {
+        obj_pool_free(&m_string_pool, string_to_send);
+      }
       str_num++;
     }
     else
     {
       printf("Task 1 failed to create buffer\r\n");
     }
+    vTaskDelay(200);
   }
 }
 
@@ -51,25 +70,47 @@ void q_reader_task_function(void* pvParameters)
 
   while(true)
   {
-    xQueueReceive(pointer_q,  &rec_string, 200);
-    while(*rec_string)
+    if(xQueueReceive(pointer_q,  &rec_string, 200) == pdPASS)
     {
-      printf("%c", *rec_string);
-      rec_string++;
+      printf("%s", rec_string);
+      // done with the buffer, back to the pool
+      obj_pool_free(&m_string_pool, rec_string);
     }
   }
 }
 
 int main(void)
 {
-  BaseType_t task_err;
+  TaskHandle_t task;
   ret_code_t err_code;
 
   /* Initialize clock driver for better time accuracy in FREERTOS */
   err_code = nrf_drv_clock_init();
   APP_ERROR_CHECK(err_code);
 
-  pointer_q = xQueueCreate(q_size, q_data_bytes);
+  // RAM report, heap trace and sleep profiler, see app_diag.h
+  if(!app_diag_init())
+  {
+    return -1;
+  }
+
+  err_code = obj_pool_init(&m_string_pool);
+  APP_ERROR_CHECK(err_code);
+  err_code = obj_pool_init(&m_queue_pool);
+  APP_ERROR_CHECK(err_code);
+  err_code = obj_pool_init(&m_task_pool);
+  APP_ERROR_CHECK(err_code);
+
+#if RUN_POOL_BENCHMARK
+  // pdFAIL = insufficient heap memory
+  if(pool_bench_start() == pdFAIL)
+  {
+    printf("Bench create fail\r\n");
+    return -1;
+  }
+  vTaskStartScheduler();
+#else
+  pointer_q = obj_pool_queue_create(&m_queue_pool);
   
   // defined constant to not use task stack
   static const char *msg = "Queue Writer Task\r\n";
@@ -80,40 +121,40 @@ int main(void)
     // reset queue to empty state
     xQueueReset(pointer_q);
     
-    // task creation function
-    // starts with 'x' means it returns BaseType_t value
-    // which can be either pdPASS or pdFAIL
-    task_err = xTaskCreate(
-                            q_writer_task_function,         // pointer to the task function
-                            "Task1",                        // task name mainly for debugging
-                            configMINIMAL_STACK_SIZE + 200, // task stack depth in words, max value contained in uint16_t data type
-                            (void*)msg,                     // task arguments explicit cast to void pointer
-                            1,                              // task priority same as 2nd task
-                            NULL
-                          );
+    // task creation from the pool, the stack depth is the one of the pool
+    // returns the task handle or NULL when all blocks are in use
+    task = obj_pool_task_create(
+                                 &m_task_pool,           // pool giving TCB and stack
+                                 q_writer_task_function, // pointer to the task function
+                                 "Task1",                // task name mainly for debugging
+                                 (void*)msg,             // task arguments explicit cast to void pointer
+                                 1                       // task priority same as 2nd task
+                               );
   
-    // pdFAIL = insufficient heap memory
-    if(task_err == pdFAIL)
+    // NULL = pool empty
+    if(task == NULL)
     {
       printf("Task 1 create fail\r\n");
       return -1;
     }
 
-    task_err = xTaskCreate(
-                            q_reader_task_function,
-                            "Task2",
-                            configMINIMAL_STACK_SIZE + 200,
-                            (void*)msg2,
-                            1,
-                            NULL
-                          );
-    // pdFAIL = insufficient heap memory
-    if(task_err == pdFAIL)
+    task = obj_pool_task_create(
+                                 &m_task_pool,
+                                 q_reader_task_function,
+                                 "Task2",
+                                 (void*)msg2,
+                                 1
+                               );
+    // NULL = pool empty
+    if(task == NULL)
     {
       printf("Task 2 create fail\r\n");
       return -1;
     }
 
+    // stack guard and RAM power-down, see app_diag.h
+    app_diag_before_scheduler();
+
     /* Activate deep sleep mode */
     SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
 
@@ -122,6 +163,7 @@ int main(void)
     // which can be changed as needed
     vTaskStartScheduler();
   }
+#endif
 
   while (true) //---------
   {
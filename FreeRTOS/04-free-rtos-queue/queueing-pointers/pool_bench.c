@@ -0,0 +1,216 @@
+/*
+  Fixed-block pools against the heap under churn
+
+  Three block classes shaped like the objects this example uses: message
+  buffers sent by pointer, queues of 8 pointers and task control blocks with
+  their stack. Each round picks a random class and slot, frees the slot if
+  it is taken and allocates it otherwise, so short and long lived blocks
+  interleave. The same sequence runs once on obj_pool and once on
+  pvPortMalloc(), the heap gets the exact message length (16 to 64 bytes)
+  where the pool always spends a full 64-byte block.
+
+  Reported per allocator: cycles per alloc and free (min / avg / max),
+  failed allocations and, for the heap, the fragmentation left behind.
+*/
+
+#include "pool_bench.h"
+#include "task.h"
+#include "obj_pool.h"
+#include "heap_tlsf.h"
+#include "prng.h"
+#include "cycle_counter.h"
+#include <stdio.h>
+
+#define BENCH_ROUNDS      20000
+#define BENCH_SEED        0x853c49e6748fea9bULL
+
+#define MSG_MAX_BYTES     64
+#define MSG_MIN_BYTES     16
+#define QUEUE_BYTES       (sizeof(StaticQueue_t) + 8 * sizeof(char*))
+#define TASK_BYTES        (sizeof(StaticTask_t) + (configMINIMAL_STACK_SIZE + 200) * sizeof(StackType_t))
+
+#define MSG_SLOTS         32
+#define QUEUE_SLOTS       8
+#define TASK_SLOTS        4
+
+OBJ_POOL_DEF(m_bench_msg_pool, MSG_MAX_BYTES, MSG_SLOTS);
+OBJ_POOL_DEF(m_bench_queue_pool, QUEUE_BYTES, QUEUE_SLOTS);
+OBJ_POOL_DEF(m_bench_task_pool, TASK_BYTES, TASK_SLOTS);
+
+typedef struct
+{
+  const char* name;
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t total;
+}timing_t;
+
+typedef struct
+{
+  obj_pool_t const* p_pool;
+  uint32_t slots;
+  void* live[MSG_SLOTS];
+}class_t;
+
+static class_t m_classes[] =
+{
+  { &m_bench_msg_pool,   MSG_SLOTS,   { NULL } },
+  { &m_bench_queue_pool, QUEUE_SLOTS, { NULL } },
+  { &m_bench_task_pool,  TASK_SLOTS,  { NULL } },
+};
+
+#define CLASS_COUNT       (sizeof(m_classes) / sizeof(m_classes[0]))
+
+static void timing_reset(timing_t* p_timing, const char* name)
+{
+  p_timing->name = name;
+  p_timing->count = 0;
+  p_timing->min = UINT32_MAX;
+  p_timing->max = 0;
+  p_timing->total = 0;
+}
+
+static void timing_add(timing_t* p_timing, uint32_t cycles)
+{
+  p_timing->count++;
+  p_timing->total += cycles;
+  if(cycles < p_timing->min) p_timing->min = cycles;
+  if(cycles > p_timing->max) p_timing->max = cycles;
+}
+
+static void timing_print(const timing_t* p_timing)
+{
+  if(p_timing->count == 0) return;
+  printf("%-12s %6u calls  %5u / %5u / %5u cycles\r\n",
+         p_timing->name,
+         (unsigned)p_timing->count,
+         (unsigned)p_timing->min,
+         (unsigned)(p_timing->total / p_timing->count),
+         (unsigned)p_timing->max);
+}
+
+static size_t class_bytes(uint32_t class, prng_t* p_prng)
+{
+  switch(class)
+  {
+    case 0:  return MSG_MIN_BYTES + prng_range(p_prng, MSG_MAX_BYTES - MSG_MIN_BYTES + 1);
+    case 1:  return QUEUE_BYTES;
+    default: return TASK_BYTES;
+  }
+}
+
+// one churn run, use_pool selects obj_pool or pvPortMalloc()
+static uint32_t churn(bool use_pool, timing_t* p_alloc, timing_t* p_free)
+{
+  prng_t prng;
+  uint32_t failures = 0;
+
+  // same sequence of classes, slots and sizes for both allocators
+  prng_seed(&prng, BENCH_SEED, 1);
+
+  vTaskSuspendAll();
+
+  for(uint32_t round = 0; round < BENCH_ROUNDS; round++)
+  {
+    uint32_t class = prng_range(&prng, CLASS_COUNT);
+    class_t* p_class = &m_classes[class];
+    uint32_t slot = prng_range(&prng, p_class->slots);
+    size_t bytes = class_bytes(class, &prng);
+    uint32_t start;
+
+    if(p_class->live[slot] != NULL)
+    {
+      start = cycle_counter_get();
+      if(use_pool) obj_pool_free(p_class->p_pool, p_class->live[slot]);
+      else         vPortFree(p_class->live[slot]);
+      timing_add(p_free, cycle_counter_get() - start);
+      p_class->live[slot] = NULL;
+    }
+    else
+    {
+      start = cycle_counter_get();
+      void* p_block = use_pool ? obj_pool_alloc(p_class->p_pool) : pvPortMalloc(bytes);
+      timing_add(p_alloc, cycle_counter_get() - start);
+      if(p_block == NULL) failures++;
+      p_class->live[slot] = p_block;
+    }
+  }
+
+  (void)xTaskResumeAll();
+  return failures;
+}
+
+// give back what the run left allocated
+static void release_all(bool use_pool)
+{
+  for(uint32_t class = 0; class < CLASS_COUNT; class++)
+  {
+    class_t* p_class = &m_classes[class];
+    for(uint32_t slot = 0; slot < p_class->slots; slot++)
+    {
+      if(p_class->live[slot] == NULL) continue;
+      if(use_pool) obj_pool_free(p_class->p_pool, p_class->live[slot]);
+      else         vPortFree(p_class->live[slot]);
+      p_class->live[slot] = NULL;
+    }
+  }
+}
+
+static void bench_task(void* pvParameters)
+{
+  timing_t alloc;
+  timing_t frees;
+  heap_tlsf_stats_t heap_stats;
+  uint32_t failures;
+
+  cycle_counter_init();
+
+  for(uint32_t class = 0; class < CLASS_COUNT; class++)
+  {
+    APP_ERROR_CHECK(obj_pool_init(m_classes[class].p_pool));
+  }
+
+  printf("\r\nChurn of %u rounds, messages %u-%u bytes, queues %u, tasks %u\r\n",
+         (unsigned)BENCH_ROUNDS, (unsigned)MSG_MIN_BYTES, (unsigned)MSG_MAX_BYTES,
+         (unsigned)QUEUE_BYTES, (unsigned)TASK_BYTES);
+
+  timing_reset(&alloc, "pool alloc");
+  timing_reset(&frees, "pool free");
+  failures = churn(true, &alloc, &frees);
+  timing_print(&alloc);
+  timing_print(&frees);
+  printf("pool failures %u, fragmentation 0 %% by construction\r\n", (unsigned)failures);
+  for(uint32_t class = 0; class < CLASS_COUNT; class++) obj_pool_stats_print(m_classes[class].p_pool);
+  release_all(true);
+
+  timing_reset(&alloc, "heap alloc");
+  timing_reset(&frees, "heap free");
+  failures = churn(false, &alloc, &frees);
+  timing_print(&alloc);
+  timing_print(&frees);
+  // measured with the churn blocks still allocated, the state the
+  // application would be in
+  heap_tlsf_stats_get(&heap_stats);
+  printf("heap failures %u, fragmentation %u %%, %u free blocks, largest %u of %u free bytes\r\n",
+         (unsigned)failures,
+         (unsigned)heap_stats.fragmentation,
+         (unsigned)heap_stats.free_blocks,
+         (unsigned)heap_stats.largest_free,
+         (unsigned)heap_stats.free);
+  release_all(false);
+
+  vTaskDelete(NULL);
+}
+
+BaseType_t pool_bench_start(void)
+{
+  return xTaskCreate(
+                      bench_task,                     // pointer to the task function
+                      "BNC",                          // task name mainly for debugging
+                      configMINIMAL_STACK_SIZE + 200, // task stack depth in words
+                      NULL,                           // task arguments
+                      2,                              // above the example tasks
+                      NULL
+                    );
+}
@@ -0,0 +1,17 @@
+/*
+  Fixed-block pools against the heap under churn
+*/
+
+#ifndef POOL_BENCH_H
+#define POOL_BENCH_H
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Create the benchmark task, results are printed when it finishes
+ *
+ * @return pdPASS or pdFAIL on insufficient heap memory
+ */
+BaseType_t pool_bench_start(void);
+
+#endif /* POOL_BENCH_H */
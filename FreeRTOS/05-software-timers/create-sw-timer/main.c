@@ -10,9 +10,17 @@
 #include "task.h"
 #include "timers.h"   // freeRTOS sw timers
 #include "nrf_drv_clock.h"
+#include "app_diag.h"
+#include "mono_time.h" // 64-bit wrap free time stamps
+#include "hfxo.h"      // crystal on request
 
 TimerHandle_t repeating_timer;
 TickType_t time_now = 0;
+uint64_t time_now_us = 0;
+
+// crystal holders, one per user
+HFXO_HOLDER_DEF(timer_hfxo);
+HFXO_HOLDER_DEF(uart_hfxo);
 
 // SW Timer callback function return type void
 // and accepts only 1 argument of type TimerHandle_t
@@ -21,9 +29,19 @@ void sw_timer_callback(TimerHandle_t timer)
   // code should be short and non-blocking
   // never call vTaskDelay function in a SW timer callback
   
+  // the crystal was pre-requested for this expiry, count if it made it
+  hfxo_prestart_check(&timer_hfxo);
+
   time_now = xTaskGetTickCountFromISR();
+  // TickType_t wraps and only resolves 1/1024 s, this one resolves ~30 us
+  // and never wraps
+  time_now_us = mono_time_us_get();
   // following call is creating a run time fault
   // printf("Ticks = %u\r\n", time_now);
+
+  // back to HFINT until shortly before the next expiry
+  hfxo_release(&timer_hfxo);
+  (void)hfxo_prestart_at(&timer_hfxo, xTimerGetExpiryTime(timer));
 }
 
 // user defined Task function which must return void and take a void pointer parameter
@@ -31,13 +49,27 @@ void sw_timer_callback(TimerHandle_t timer)
 void task1_function(void* pvParameters)
 {
   printf("Task 1 function\r\n");
+  uint64_t us;
+  uint32_t loops = 0;
+  TickType_t last_wake = xTaskGetTickCount();
   // task's infinite loop which must not exit or return
   // if a task is not required, it should be explicitly deleted
   while(true)
   {
-    
-    printf("Ticks = %u\r\n", time_now);
-    vTaskDelay(pdMS_TO_TICKS(1000));  // v = void return type and function is defined in task.c
+    // 64-bit copy is not atomic, don't let the timer callback update it halfway
+    taskENTER_CRITICAL();
+    us = time_now_us;
+    taskEXIT_CRITICAL();
+
+    printf("Ticks = %u, Time = %u.%06u s\r\n", time_now,
+           (uint32_t)(us / 1000000), (uint32_t)(us % 1000000));
+
+    if(++loops % 10 == 0) hfxo_report();
+
+    // the UART baud rate is only accurate on the crystal, it is requested
+    // a little ahead of the wake and held while printing
+    hfxo_release(&uart_hfxo);
+    hfxo_delay_until(&uart_hfxo, &last_wake, pdMS_TO_TICKS(1000));
   }
 
   // if task reached here, it must be deleted before exiting the task function
@@ -54,6 +86,16 @@ int main(void)
   /* Initialize clock driver for better time accuracy in FREERTOS */
   err_code = nrf_drv_clock_init();
   APP_ERROR_CHECK(err_code);
+
+  // RAM report, heap trace and sleep profiler, see app_diag.h
+  if(!app_diag_init())
+  {
+    return -1;
+  }
+
+  // start the 64-bit time base, needs the clock driver
+  err_code = mono_time_init();
+  APP_ERROR_CHECK(err_code);
   
   const TickType_t k_timer_period = pdMS_TO_TICKS(1000);
   
@@ -107,6 +149,17 @@ int main(void)
     return -1;
   }
 
+  // crystal running by the first expiry, the callback pre-requests the
+  // following ones itself
+  if(hfxo_prestart_at(&timer_hfxo, k_timer_period) != pdPASS)
+  {
+    printf("HFXO pre-request fail\r\n");
+    return -1;
+  }
+
+  // stack guard and RAM power-down, see app_diag.h
+  app_diag_before_scheduler();
+
   /* Activate deep sleep mode */
   SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
 
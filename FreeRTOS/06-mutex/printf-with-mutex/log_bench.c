@@ -0,0 +1,155 @@
+/*
+  Caller side latency of print_with_mutex() against async_log_printf() and
+  BIN_LOG()
+
+  All paths log the same message the example tasks print. Each call is timed
+  with the DWT cycle counter (64 cycles = 1 us):
+  - paced: one call every 20 ms, the steady state of the example
+  - burst: back to back calls, the async ring overflows and drops instead of
+    blocking the caller
+
+  Bytes per message are printed as well, the text lines against the BIN_LOG()
+  frames as counted by the async_log drain task. Decode the run with
+  tools/bin_log_decode.py, --stats gives the same figure for the whole
+  stream.
+*/
+
+#include "log_bench.h"
+#include "task.h"
+#include "async_log.h"
+#include "bin_log.h"
+#include "cycle_counter.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+#define BENCH_CALLS   32
+
+// defined in main.c
+extern bool print_with_mutex(const char* str);
+
+typedef struct
+{
+  uint32_t min;
+  uint32_t max;
+  uint32_t sum;
+  uint32_t failed;
+}bench_result_t;
+
+static void result_add(bench_result_t* p_res, uint32_t cycles, bool ok)
+{
+  if(cycles < p_res->min) p_res->min = cycles;
+  if(cycles > p_res->max) p_res->max = cycles;
+  p_res->sum += cycles;
+  if(!ok) p_res->failed++;
+}
+
+static void bench_mutex(bench_result_t* p_res, TickType_t pace)
+{
+  static const char msg[] = "[0] Printing for Task 1 with proiroty 1\r\n";
+  *p_res = (bench_result_t){ .min = UINT32_MAX };
+
+  for(uint32_t i = 0; i < BENCH_CALLS; i++)
+  {
+    uint32_t start = cycle_counter_get();
+    bool ok = print_with_mutex(msg);
+    result_add(p_res, cycle_counter_get() - start, ok);
+    if(pace) vTaskDelay(pace);
+  }
+}
+
+static void bench_async(bench_result_t* p_res, TickType_t pace)
+{
+  *p_res = (bench_result_t){ .min = UINT32_MAX };
+
+  for(uint32_t i = 0; i < BENCH_CALLS; i++)
+  {
+    uint32_t start = cycle_counter_get();
+    bool ok = async_log_printf("[%u] Printing for Task %u with proiroty %u\r\n", i, 1u, 1u);
+    result_add(p_res, cycle_counter_get() - start, ok);
+    if(pace) vTaskDelay(pace);
+  }
+}
+
+static void bench_binary(bench_result_t* p_res, TickType_t pace)
+{
+  *p_res = (bench_result_t){ .min = UINT32_MAX };
+
+  for(uint32_t i = 0; i < BENCH_CALLS; i++)
+  {
+    uint32_t start = cycle_counter_get();
+    BIN_LOG("[%u] Printing for Task %u with proiroty %u\r\n", i, 1u, 1u);
+    // BIN_LOG() doesn't return the queue state, drops show up in the stats
+    result_add(p_res, cycle_counter_get() - start, true);
+    if(pace) vTaskDelay(pace);
+  }
+}
+
+static void result_print(const char* name, const bench_result_t* p_res)
+{
+  printf("%-14s min %6u avg %6u max %7u cycles, %u of %u failed\r\n",
+         name, p_res->min, p_res->sum / BENCH_CALLS, p_res->max,
+         p_res->failed, BENCH_CALLS);
+}
+
+// average of the messages the drain task wrote in between, in 1/10 bytes
+static uint32_t bytes_per_message(const async_log_stats_t* p_from, const async_log_stats_t* p_to)
+{
+  uint32_t written = p_to->written - p_from->written;
+
+  return (written != 0) ? (p_to->bytes - p_from->bytes) * 10 / written : 0;
+}
+
+static void bench_task(void* pvParameters)
+{
+  const TickType_t k_pace = pdMS_TO_TICKS(20);
+  bench_result_t mutex_paced, mutex_burst, async_paced, async_burst;
+  bench_result_t binary_paced, binary_burst;
+  async_log_stats_t start, text, binary;
+
+  cycle_counter_init();
+
+  bench_mutex(&mutex_paced, k_pace);
+  bench_mutex(&mutex_burst, 0);
+
+  async_log_stats_get(&start);
+  bench_async(&async_paced, k_pace);
+  bench_async(&async_burst, 0);
+  vTaskDelay(pdMS_TO_TICKS(500));
+  async_log_stats_get(&text);
+
+  bench_binary(&binary_paced, k_pace);
+  bench_binary(&binary_burst, 0);
+  vTaskDelay(pdMS_TO_TICKS(500));
+  async_log_stats_get(&binary);
+  binary_burst.failed = binary.dropped - text.dropped;
+
+  // let the drain task empty the ring before printing directly
+  vTaskDelay(pdMS_TO_TICKS(500));
+
+  printf("\r\nCaller latency, %u calls, 64 cycles = 1 us\r\n", BENCH_CALLS);
+  result_print("mutex paced", &mutex_paced);
+  result_print("mutex burst", &mutex_burst);
+  result_print("async paced", &async_paced);
+  result_print("async burst", &async_burst);
+  result_print("binary paced", &binary_paced);
+  result_print("binary burst", &binary_burst);
+  uint32_t text_bytes = bytes_per_message(&start, &text);
+  uint32_t binary_bytes = bytes_per_message(&text, &binary);
+  printf("bytes per message: text %u.%u, binary %u.%u\r\n",
+         (unsigned)(text_bytes / 10), (unsigned)(text_bytes % 10),
+         (unsigned)(binary_bytes / 10), (unsigned)(binary_bytes % 10));
+
+  vTaskDelete(NULL);
+}
+
+BaseType_t log_bench_start(void)
+{
+  return xTaskCreate(
+                      bench_task,                     // pointer to the task function
+                      "BNC",                          // task name mainly for debugging
+                      configMINIMAL_STACK_SIZE + 200, // task stack depth in words
+                      NULL,                           // task arguments
+                      2,                              // same priority as the highest example task
+                      NULL
+                    );
+}
@@ -0,0 +1,17 @@
+/*
+  Caller side latency of print_with_mutex() against async_log_printf()
+*/
+
+#ifndef LOG_BENCH_H
+#define LOG_BENCH_H
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Create the benchmark task, results are printed when it finishes
+ *
+ * @return pdPASS or pdFAIL on insufficient heap memory
+ */
+BaseType_t log_bench_start(void);
+
+#endif /* LOG_BENCH_H */
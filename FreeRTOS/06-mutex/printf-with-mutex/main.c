@@ -10,17 +10,45 @@
 #include "task.h"
 #include "semphr.h" // to use mutex
 #include "nrf_drv_clock.h"
+#include "app_diag.h"
+#include "mono_time.h"
+#include "mutex_prof.h" // set MUTEX_PROF_ENABLED in FreeRTOSConfig.h
+#include "async_log.h"
+#include "bin_log.h"
+#include "log_bench.h"
+#include "rwlock_bench.h"
+#include "mutex_bench.h"
+
+#define LOG_MODE_MUTEX    0 // print_with_mutex()
+#define LOG_MODE_ASYNC    1 // async_log_printf(), caller formats the text
+#define LOG_MODE_BINARY   2 // BIN_LOG(), decode with tools/bin_log_decode.py
+
+// how the example tasks print, MUTEX_PROF_ENABLED only has printing_mutex
+// to profile with LOG_MODE_MUTEX
+#ifndef LOG_MODE
+#define LOG_MODE          LOG_MODE_MUTEX
+#endif
+// 1 = only run the caller latency benchmark in log_bench.c
+#define RUN_LOG_BENCHMARK 0
+// 1 = only run the reader throughput benchmark in rwlock_bench.c
+#define RUN_RWLOCK_BENCHMARK 0
+// 1 = only run the mutex benchmark in mutex_bench.c, the host Makefile sets
+// it for make bench
+#ifndef RUN_MUTEX_BENCHMARK
+#define RUN_MUTEX_BENCHMARK 0
+#endif
 
 // set configUSE_MUTEXES to 1 in FreeRTOSConfig.h
-SemaphoreHandle_t printing_mutex;
+// profiled mutex, a plain SemaphoreHandle_t with MUTEX_PROF_ENABLED 0
+prof_mutex_t printing_mutex;
 
 bool print_with_mutex(const char* str)
 {
   static const TickType_t k_wait_delay = pdMS_TO_TICKS(10);
   // return early on pdFAIL otherwise a run time fault will be generated
-  if(xSemaphoreTake(printing_mutex, k_wait_delay) != pdTRUE)  return false;
+  if(mutex_prof_take(printing_mutex, k_wait_delay) != pdTRUE)  return false;
   printf("%s", str);
-  xSemaphoreGive(printing_mutex);
+  mutex_prof_give(printing_mutex);
   return true;
 }
 
@@ -28,15 +56,26 @@ void task1_function(void* pvParameters)
 {
   const TickType_t k_wait = pdMS_TO_TICKS(500);
   UBaseType_t task_priority;
+#if LOG_MODE == LOG_MODE_MUTEX
   char msg[50] = {0};
+#endif
   size_t count = 0;
   while(true)
   {
     // no need of task handle
     task_priority = uxTaskPriorityGet(NULL);
-    snprintf(msg, 50, "[%u] Printing for Task 1 with proiroty %u\r\n", count, task_priority);
+#if LOG_MODE == LOG_MODE_ASYNC
+    // formats straight into the log ring and returns, never waits for printf
+    if(async_log_printf("[%u] Printing for Task 1 with proiroty %u\r\n", (unsigned)count, (unsigned)task_priority)) count++;
+#elif LOG_MODE == LOG_MODE_BINARY
+    // only the string id and the 2 raw arguments go out, 12 bytes
+    BIN_LOG("[%u] Printing for Task 1 with proiroty %u\r\n", count, task_priority);
+    count++;
+#else
+    snprintf(msg, 50, "[%u] Printing for Task 1 with proiroty %u\r\n", (unsigned)count, (unsigned)task_priority);
     // increment count only on success or true from printing function 
     if(print_with_mutex(msg))  count++;
+#endif
     vTaskDelay(k_wait);
   }
 }
@@ -45,15 +84,34 @@ void task2_function(void* pvParameters)
 {
   const TickType_t k_wait = pdMS_TO_TICKS(1000);
   UBaseType_t task_priority;
+#if LOG_MODE == LOG_MODE_MUTEX
   char msg[50] = {0};
+#endif
   size_t count = 0;
   while(true)
   {
     // no need of task handle
     task_priority = uxTaskPriorityGet(NULL);
-    snprintf(msg, 50, "[%u] Printing for Task 2 with proiroty %u\r\n", count, task_priority);
+#if LOG_MODE == LOG_MODE_ASYNC
+    if(async_log_printf("[%u] Printing for Task 2 with proiroty %u\r\n", (unsigned)count, (unsigned)task_priority)) count++;
+#elif LOG_MODE == LOG_MODE_BINARY
+    BIN_LOG("[%u] Printing for Task 2 with proiroty %u\r\n", count, task_priority);
+    count++;
+#else
+    snprintf(msg, 50, "[%u] Printing for Task 2 with proiroty %u\r\n", (unsigned)count, (unsigned)task_priority);
     // increment count only on success or true from printing function 
-    if(print_with_mutex(msg)) count++;
+    if(print_with_mutex(msg))
+    {
+      count++;
+      // contention table every 10 prints, printed under the mutex so it
+      // doesn't mix with task 1 output
+      if((count % 10) == 0 && mutex_prof_take(printing_mutex, portMAX_DELAY) == pdTRUE)
+      {
+        mutex_prof_print();
+        mutex_prof_give(printing_mutex);
+      }
+    }
+#endif
     vTaskDelay(k_wait);
   }
 }
@@ -67,15 +125,63 @@ int main(void)
   err_code = nrf_drv_clock_init();
   APP_ERROR_CHECK(err_code);
 
+  // RAM report, heap trace and sleep profiler, see app_diag.h
+  if(!app_diag_init())
+  {
+    return -1;
+  }
+
+  // time base of the mutex profiler
+  err_code = mono_time_init();
+  APP_ERROR_CHECK(err_code);
+
   // set configUSE_MUTEXES to 1 in FreeRTOSConfig.h
-  printing_mutex = xSemaphoreCreateMutex();
+  printing_mutex = mutex_prof_create("print");
 
   if(printing_mutex == NULL)
   {
     printf("Mutex create fail\r\n");
     return -1;
   }
-  
+
+  // drain task runs at idle priority, it only gets CPU when no task needs it
+  task_err = async_log_init(tskIDLE_PRIORITY, NULL);
+
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Log task create fail\r\n");
+    return -1;
+  }
+
+#if RUN_LOG_BENCHMARK
+  task_err = log_bench_start();
+
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Benchmark task create fail\r\n");
+    return -1;
+  }
+#elif RUN_RWLOCK_BENCHMARK
+  task_err = rwlock_bench_start();
+
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Benchmark task create fail\r\n");
+    return -1;
+  }
+#elif RUN_MUTEX_BENCHMARK
+  task_err = mutex_bench_start();
+
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Benchmark task create fail\r\n");
+    return -1;
+  }
+#else
   task_err = xTaskCreate(
                           task1_function,                 // pointer to the task function
                           "Task1",                        // task name mainly for debugging
@@ -107,6 +213,10 @@ int main(void)
     printf("Task 2 create fail\r\n");
     return -1;
   }
+#endif
+
+  // stack guard and RAM power-down, see app_diag.h
+  app_diag_before_scheduler();
 
   /* Activate deep sleep mode */
   SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
@@ -0,0 +1,117 @@
+/*
+  Mutex primitives on the benchmark harness
+
+  Cycles of one take and give pair, or of one give:
+  - take_give: uncontended xSemaphoreTake() and xSemaphoreGive()
+  - recursive: the same with the recursive mutex calls
+  - prof_take_give: the pair through common/mutex_prof.h, the profiler
+    cost with MUTEX_PROF_ENABLED 1 in FreeRTOSConfig.h
+  - give_wake: xSemaphoreGive() while a higher priority task waits for the
+    mutex. The bench task holds it with the inherited priority, the give
+    drops the inheritance and hands over, the waiter takes, gives and waits
+    for the next round before the give returns
+
+  Results are JSON lines of common/bench.h, compare them against a baseline
+  with tools/bench_compare.py.
+*/
+
+#include "mutex_bench.h"
+#include "task.h"
+#include "semphr.h"
+#include "mutex_prof.h"
+#include "bench.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+#define BENCH_WARMUP      16
+#define BENCH_ITERATIONS  256
+
+static SemaphoreHandle_t m_mutex;
+static SemaphoreHandle_t m_recursive;
+static prof_mutex_t m_prof_mutex;
+static SemaphoreHandle_t m_wake_mutex;
+static TaskHandle_t m_waiter;
+
+static void take_give_run(void* p_context)
+{
+  (void)xSemaphoreTake(m_mutex, 0);
+  (void)xSemaphoreGive(m_mutex);
+}
+
+static void recursive_run(void* p_context)
+{
+  (void)xSemaphoreTakeRecursive(m_recursive, 0);
+  (void)xSemaphoreGiveRecursive(m_recursive);
+}
+
+static void prof_take_give_run(void* p_context)
+{
+  (void)mutex_prof_take(m_prof_mutex, 0);
+  (void)mutex_prof_give(m_prof_mutex);
+}
+
+// take the mutex and let the waiter block on it, it preempts right away
+static void give_wake_setup(void* p_context)
+{
+  (void)xSemaphoreTake(m_wake_mutex, 0);
+  xTaskNotifyGive(m_waiter);
+}
+
+static void give_wake_run(void* p_context)
+{
+  (void)xSemaphoreGive(m_wake_mutex);
+}
+
+static const bench_case_t k_cases[] =
+{
+  { .name = "take_give",      .setup = NULL,            .run = take_give_run,      .warmup = BENCH_WARMUP, .iterations = BENCH_ITERATIONS },
+  { .name = "recursive",      .setup = NULL,            .run = recursive_run,      .warmup = BENCH_WARMUP, .iterations = BENCH_ITERATIONS },
+  { .name = "prof_take_give", .setup = NULL,            .run = prof_take_give_run, .warmup = BENCH_WARMUP, .iterations = BENCH_ITERATIONS },
+  { .name = "give_wake",      .setup = give_wake_setup, .run = give_wake_run,      .warmup = BENCH_WARMUP, .iterations = BENCH_ITERATIONS },
+};
+
+static void waiter_task(void* pvParameters)
+{
+  while(true)
+  {
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    (void)xSemaphoreTake(m_wake_mutex, portMAX_DELAY);
+    (void)xSemaphoreGive(m_wake_mutex);
+  }
+}
+
+static void bench_task(void* pvParameters)
+{
+  bench_suite_run("mutex", k_cases, sizeof(k_cases) / sizeof(k_cases[0]));
+  vTaskDelete(NULL);
+}
+
+BaseType_t mutex_bench_start(void)
+{
+  BaseType_t err;
+
+  m_mutex = xSemaphoreCreateMutex();
+  m_recursive = xSemaphoreCreateRecursiveMutex();
+  m_prof_mutex = mutex_prof_create("bench");
+  m_wake_mutex = xSemaphoreCreateMutex();
+  if(m_mutex == NULL || m_recursive == NULL || m_prof_mutex == NULL || m_wake_mutex == NULL) return pdFAIL;
+
+  err = xTaskCreate(
+                     waiter_task,                    // pointer to the task function
+                     "MWT",                          // task name mainly for debugging
+                     configMINIMAL_STACK_SIZE + 40,  // task stack depth in words
+                     NULL,                           // task arguments
+                     2,                              // preempts the bench task on each handover
+                     &m_waiter
+                   );
+  if(err != pdPASS) return err;
+
+  return xTaskCreate(
+                      bench_task,                     // pointer to the task function
+                      "BNC",                          // task name mainly for debugging
+                      configMINIMAL_STACK_SIZE + 200, // task stack depth in words
+                      NULL,                           // task arguments
+                      1,                              // below the waiter
+                      NULL
+                    );
+}
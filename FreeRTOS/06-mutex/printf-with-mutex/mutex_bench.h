@@ -0,0 +1,18 @@
+/*
+  Mutex primitives on the benchmark harness
+*/
+
+#ifndef MUTEX_BENCH_H
+#define MUTEX_BENCH_H
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Create the benchmark tasks, JSON results are printed when they
+ *        finish
+ *
+ * @return pdPASS or pdFAIL on insufficient heap memory
+ */
+BaseType_t mutex_bench_start(void);
+
+#endif /* MUTEX_BENCH_H */
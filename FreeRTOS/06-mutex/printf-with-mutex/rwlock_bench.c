@@ -0,0 +1,148 @@
+/*
+  Reader throughput of a plain mutex against rwlock_t
+
+  1 to BENCH_MAX_READERS reader tasks copy a shared configuration block in a
+  loop for BENCH_WINDOW. Inside the lock every reader also blocks for one tick,
+  standing in for a slow read (flash, sensor) or for being preempted while
+  holding the lock. On a single core that's where the lock type matters: the
+  mutex lets one reader in at a time, rwlock_t lets all of them overlap their
+  waits.
+
+  Reader tasks are created once and parked between runs.
+*/
+
+#include "rwlock_bench.h"
+#include "task.h"
+#include "semphr.h"
+#include "rwlock.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_MAX_READERS   4
+#define BENCH_WINDOW_MS     1000
+#define BENCH_WINDOW        pdMS_TO_TICKS(BENCH_WINDOW_MS)
+
+typedef struct
+{
+  uint32_t values[8];
+  uint32_t version;
+}config_t;
+
+static config_t m_config;
+
+static SemaphoreHandle_t m_mutex;
+static rwlock_t m_rwlock;
+static SemaphoreHandle_t m_done;
+
+static TaskHandle_t m_readers[BENCH_MAX_READERS];
+static volatile uint32_t m_reads[BENCH_MAX_READERS];
+static volatile bool m_use_rwlock;
+static volatile bool m_stop;
+
+static void read_config(config_t* p_copy)
+{
+  if(m_use_rwlock) rwlock_read_lock(&m_rwlock, portMAX_DELAY);
+  else             xSemaphoreTake(m_mutex, portMAX_DELAY);
+
+  memcpy(p_copy, &m_config, sizeof(*p_copy));
+  // slow part of the read, done while holding the lock
+  vTaskDelay(1);
+
+  if(m_use_rwlock) rwlock_read_unlock(&m_rwlock);
+  else             xSemaphoreGive(m_mutex);
+}
+
+static void reader_task(void* pvParameters)
+{
+  uint32_t index = (uint32_t)(uintptr_t)pvParameters;
+  config_t copy;
+
+  while(true)
+  {
+    // parked until the controller starts a run
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    while(!m_stop)
+    {
+      read_config(&copy);
+      m_reads[index]++;
+    }
+    xSemaphoreGive(m_done);
+  }
+}
+
+static uint32_t bench_run(bool use_rwlock, uint32_t readers)
+{
+  uint32_t total = 0;
+
+  m_use_rwlock = use_rwlock;
+  m_stop = false;
+  for(uint32_t i = 0; i < BENCH_MAX_READERS; i++) m_reads[i] = 0;
+
+  for(uint32_t i = 0; i < readers; i++) xTaskNotifyGive(m_readers[i]);
+  vTaskDelay(BENCH_WINDOW);
+  m_stop = true;
+
+  for(uint32_t i = 0; i < readers; i++) xSemaphoreTake(m_done, portMAX_DELAY);
+  for(uint32_t i = 0; i < readers; i++) total += m_reads[i];
+
+  return total;
+}
+
+static void controller_task(void* pvParameters)
+{
+  uint32_t mutex_reads[BENCH_MAX_READERS];
+  uint32_t rwlock_reads[BENCH_MAX_READERS];
+
+  for(uint32_t n = 1; n <= BENCH_MAX_READERS; n++)
+  {
+    mutex_reads[n - 1] = bench_run(false, n);
+    rwlock_reads[n - 1] = bench_run(true, n);
+  }
+
+  printf("\r\nReads per second, %u ms window, 1 tick blocking read\r\n",
+         (unsigned)BENCH_WINDOW_MS);
+  printf("readers    mutex   rwlock\r\n");
+  for(uint32_t n = 1; n <= BENCH_MAX_READERS; n++)
+  {
+    printf("%7u %8u %8u\r\n", (unsigned)n,
+           (unsigned)(mutex_reads[n - 1] * 1000 / BENCH_WINDOW_MS),
+           (unsigned)(rwlock_reads[n - 1] * 1000 / BENCH_WINDOW_MS));
+  }
+
+  vTaskDelete(NULL);
+}
+
+BaseType_t rwlock_bench_start(void)
+{
+  BaseType_t err;
+
+  m_mutex = xSemaphoreCreateMutex();
+  m_done = xSemaphoreCreateCounting(BENCH_MAX_READERS, 0);
+  if(m_mutex == NULL || m_done == NULL) return pdFAIL;
+  if(rwlock_init(&m_rwlock) != pdPASS) return pdFAIL;
+
+  for(uint32_t i = 0; i < BENCH_MAX_READERS; i++)
+  {
+    err = xTaskCreate(
+                      reader_task,                    // pointer to the task function
+                      "RD",                           // task name mainly for debugging
+                      configMINIMAL_STACK_SIZE + 100, // task stack depth in words
+                      (void*)(uintptr_t)i,            // reader index
+                      1,                              // all readers at the same priority
+                      &m_readers[i]
+                    );
+    if(err != pdPASS) return err;
+  }
+
+  return xTaskCreate(
+                      controller_task,                // pointer to the task function
+                      "BNC",                          // task name mainly for debugging
+                      configMINIMAL_STACK_SIZE + 200, // task stack depth in words
+                      NULL,                           // task arguments
+                      2,                              // above the readers
+                      NULL
+                    );
+}
@@ -0,0 +1,17 @@
+/*
+  Reader throughput of a plain mutex against rwlock_t
+*/
+
+#ifndef RWLOCK_BENCH_H
+#define RWLOCK_BENCH_H
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Create the benchmark tasks, results are printed when they finish
+ *
+ * @return pdPASS or pdFAIL on insufficient heap memory
+ */
+BaseType_t rwlock_bench_start(void);
+
+#endif /* RWLOCK_BENCH_H */
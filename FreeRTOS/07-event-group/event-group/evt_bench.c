@@ -0,0 +1,186 @@
+/*
+  Set bits latency of the kernel event group against idx_evt_group_t
+
+  For 1 to BENCH_MAX_WAITERS waiters, one target task waits for TARGET_BIT
+  and the other waiters block on bits that are never set, as in a system
+  where many tasks wait on different events. The benchmark measures the
+  cycles of the set call that unblocks the target. The target runs below
+  the benchmark task, so the measure covers the set and the readying of the
+  target but not the context switch.
+
+  The kernel group walks every waiter on each set, the indexed group only
+  the waiters registered under TARGET_BIT.
+
+  Background waiters move between the two groups on SWITCH_BIT instead of
+  being created twice. 64 waiters take about 32 KB of heap, see
+  configTOTAL_HEAP_SIZE.
+*/
+
+#include "evt_bench.h"
+#include "task.h"
+#include "event_groups.h"
+#include "idx_evt_group.h"
+#include "cycle_counter.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define BENCH_MAX_WAITERS   64
+#define BENCH_ROUNDS        32
+
+// 24 usable bits in the kernel group, same bit layout in both groups
+#define TARGET_BIT          (1UL << 23)
+#define SWITCH_BIT          (1UL << 22)
+#define BACKGROUND_BITS     22
+
+#if IDX_EVT_GROUP_MAX_WAITERS < BENCH_MAX_WAITERS
+#error "set IDX_EVT_GROUP_MAX_WAITERS to 64 in FreeRTOSConfig.h"
+#endif
+
+typedef struct
+{
+  uint32_t min;
+  uint32_t max;
+  uint32_t avg;
+}result_t;
+
+static EventGroupHandle_t m_kernel_group;
+static idx_evt_group_t m_idx_group;
+
+static uint32_t m_background_count = 0;
+
+static void background_task(void* pvParameters)
+{
+  uint32_t bit = 1UL << ((uint32_t)(uintptr_t)pvParameters % BACKGROUND_BITS);
+
+  while(true)
+  {
+    (void)xEventGroupWaitBits(m_kernel_group, bit | SWITCH_BIT, pdFALSE, pdFALSE, portMAX_DELAY);
+    (void)idx_evt_group_wait_bits(&m_idx_group, bit | SWITCH_BIT, pdFALSE, pdFALSE, portMAX_DELAY);
+  }
+}
+
+static void kernel_target_task(void* pvParameters)
+{
+  while(true)
+  {
+    (void)xEventGroupWaitBits(m_kernel_group, TARGET_BIT, pdTRUE, pdFALSE, portMAX_DELAY);
+  }
+}
+
+static void idx_target_task(void* pvParameters)
+{
+  while(true)
+  {
+    (void)idx_evt_group_wait_bits(&m_idx_group, TARGET_BIT, pdTRUE, pdFALSE, portMAX_DELAY);
+  }
+}
+
+static result_t bench_run(bool indexed)
+{
+  result_t result = { UINT32_MAX, 0, 0 };
+  uint32_t total = 0;
+
+  for(uint32_t i = 0; i < BENCH_ROUNDS; i++)
+  {
+    uint32_t start = cycle_counter_get();
+    if(indexed) (void)idx_evt_group_set_bits(&m_idx_group, TARGET_BIT);
+    else        (void)xEventGroupSetBits(m_kernel_group, TARGET_BIT);
+    uint32_t cycles = cycle_counter_get() - start;
+
+    if(cycles < result.min) result.min = cycles;
+    if(cycles > result.max) result.max = cycles;
+    total += cycles;
+
+    // target clears the bit and blocks again
+    vTaskDelay(2);
+  }
+
+  result.avg = total / BENCH_ROUNDS;
+  return result;
+}
+
+static BaseType_t background_add(uint32_t count)
+{
+  while(m_background_count < count)
+  {
+    BaseType_t err = xTaskCreate(
+                                  background_task,                // pointer to the task function
+                                  "BG",                           // task name mainly for debugging
+                                  configMINIMAL_STACK_SIZE + 40,  // task stack depth in words
+                                  (void*)(uintptr_t)m_background_count, // picks the bit to wait for
+                                  1,                              // below the benchmark task
+                                  NULL
+                                );
+    if(err != pdPASS) return err;
+    m_background_count++;
+  }
+
+  // let the new ones block on the kernel group
+  vTaskDelay(2);
+  return pdPASS;
+}
+
+static void bench_task(void* pvParameters)
+{
+  result_t kernel;
+  result_t indexed;
+
+  cycle_counter_init();
+
+  printf("\r\nSet bits cycles, %u rounds, one waiter unblocked\r\n", (unsigned)BENCH_ROUNDS);
+  printf("waiters   kernel min/avg/max     indexed min/avg/max\r\n");
+
+  for(uint32_t n = 1; n <= BENCH_MAX_WAITERS; n *= 2)
+  {
+    if(background_add(n - 1) != pdPASS)
+    {
+      printf("Waiter create fail\r\n");
+      break;
+    }
+
+    kernel = bench_run(false);
+
+    // all background waiters over to the indexed group
+    (void)xEventGroupSetBits(m_kernel_group, SWITCH_BIT);
+    vTaskDelay(2);
+    (void)xEventGroupClearBits(m_kernel_group, SWITCH_BIT);
+
+    indexed = bench_run(true);
+
+    // and back for the next run
+    (void)idx_evt_group_set_bits(&m_idx_group, SWITCH_BIT);
+    vTaskDelay(2);
+    (void)idx_evt_group_clear_bits(&m_idx_group, SWITCH_BIT);
+
+    printf("%7u %6u/%6u/%6u %6u/%6u/%6u\r\n", (unsigned)n,
+           (unsigned)kernel.min, (unsigned)kernel.avg, (unsigned)kernel.max,
+           (unsigned)indexed.min, (unsigned)indexed.avg, (unsigned)indexed.max);
+  }
+
+  vTaskDelete(NULL);
+}
+
+BaseType_t evt_bench_start(void)
+{
+  BaseType_t err;
+
+  m_kernel_group = xEventGroupCreate();
+  if(m_kernel_group == NULL) return pdFAIL;
+  idx_evt_group_init(&m_idx_group);
+
+  err = xTaskCreate(kernel_target_task, "TK", configMINIMAL_STACK_SIZE + 40, NULL, 1, NULL);
+  if(err != pdPASS) return err;
+
+  err = xTaskCreate(idx_target_task, "TI", configMINIMAL_STACK_SIZE + 40, NULL, 1, NULL);
+  if(err != pdPASS) return err;
+
+  return xTaskCreate(
+                      bench_task,                     // pointer to the task function
+                      "BNC",                          // task name mainly for debugging
+                      configMINIMAL_STACK_SIZE + 200, // task stack depth in words
+                      NULL,                           // task arguments
+                      2,                              // above all waiters
+                      NULL
+                    );
+}
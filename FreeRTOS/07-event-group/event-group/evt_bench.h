@@ -0,0 +1,17 @@
+/*
+  Set bits latency of the kernel event group against idx_evt_group_t
+*/
+
+#ifndef EVT_BENCH_H
+#define EVT_BENCH_H
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Create the benchmark tasks, results are printed when they finish
+ *
+ * @return pdPASS or pdFAIL on insufficient heap memory
+ */
+BaseType_t evt_bench_start(void);
+
+#endif /* EVT_BENCH_H */
@@ -0,0 +1,138 @@
+/*
+  Event group primitives on the benchmark harness
+
+  Cycles of one call:
+  - set_bits: xEventGroupSetBits() with no task waiting
+  - clear_bits: xEventGroupClearBits()
+  - set_wake: xEventGroupSetBits() of the bit a higher priority task waits
+    for, the round trip through its wait and back
+  - idx_set_wake: the same on idx_evt_group_t
+  - sync: xEventGroupSync() of two tasks, the partner is already waiting,
+    so the call returns at once and the partner runs before it does
+
+  evt_bench.c covers the set bits cost against the number of waiters.
+  Results are JSON lines of common/bench.h, compare them against a baseline
+  with tools/bench_compare.py.
+*/
+
+#include "evt_group_bench.h"
+#include "task.h"
+#include "event_groups.h"
+#include "idx_evt_group.h"
+#include "bench.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+#define BENCH_WARMUP      16
+#define BENCH_ITERATIONS  256
+
+#define PLAIN_BIT         (1UL << 0)
+#define WAKE_BIT          (1UL << 1)
+#define BENCH_SYNC_BIT    (1UL << 2)
+#define PARTNER_SYNC_BIT  (1UL << 3)
+#define SYNC_BITS         (BENCH_SYNC_BIT | PARTNER_SYNC_BIT)
+
+static EventGroupHandle_t m_group;
+static idx_evt_group_t m_idx_group;
+
+static void plain_bit_clear(void* p_context)
+{
+  (void)xEventGroupClearBits(m_group, PLAIN_BIT);
+}
+
+static void plain_bit_set(void* p_context)
+{
+  (void)xEventGroupSetBits(m_group, PLAIN_BIT);
+}
+
+static void set_bits_run(void* p_context)
+{
+  (void)xEventGroupSetBits(m_group, PLAIN_BIT);
+}
+
+static void clear_bits_run(void* p_context)
+{
+  (void)xEventGroupClearBits(m_group, PLAIN_BIT);
+}
+
+static void set_wake_run(void* p_context)
+{
+  (void)xEventGroupSetBits(m_group, WAKE_BIT);
+}
+
+static void idx_set_wake_run(void* p_context)
+{
+  (void)idx_evt_group_set_bits(&m_idx_group, WAKE_BIT);
+}
+
+static void sync_run(void* p_context)
+{
+  (void)xEventGroupSync(m_group, BENCH_SYNC_BIT, SYNC_BITS, portMAX_DELAY);
+}
+
+static const bench_case_t k_cases[] =
+{
+  { .name = "set_bits",     .setup = plain_bit_clear, .run = set_bits_run,     .warmup = BENCH_WARMUP, .iterations = BENCH_ITERATIONS },
+  { .name = "clear_bits",   .setup = plain_bit_set,   .run = clear_bits_run,   .warmup = BENCH_WARMUP, .iterations = BENCH_ITERATIONS },
+  { .name = "set_wake",     .setup = NULL,            .run = set_wake_run,     .warmup = BENCH_WARMUP, .iterations = BENCH_ITERATIONS },
+  { .name = "idx_set_wake", .setup = NULL,            .run = idx_set_wake_run, .warmup = BENCH_WARMUP, .iterations = BENCH_ITERATIONS },
+  { .name = "sync",         .setup = NULL,            .run = sync_run,         .warmup = BENCH_WARMUP, .iterations = BENCH_ITERATIONS },
+};
+
+static void waiter_task(void* pvParameters)
+{
+  while(true)
+  {
+    (void)xEventGroupWaitBits(m_group, WAKE_BIT, pdTRUE, pdFALSE, portMAX_DELAY);
+  }
+}
+
+static void idx_waiter_task(void* pvParameters)
+{
+  while(true)
+  {
+    (void)idx_evt_group_wait_bits(&m_idx_group, WAKE_BIT, pdTRUE, pdFALSE, portMAX_DELAY);
+  }
+}
+
+static void partner_task(void* pvParameters)
+{
+  while(true)
+  {
+    (void)xEventGroupSync(m_group, PARTNER_SYNC_BIT, SYNC_BITS, portMAX_DELAY);
+  }
+}
+
+static void bench_task(void* pvParameters)
+{
+  bench_suite_run("evt_group", k_cases, sizeof(k_cases) / sizeof(k_cases[0]));
+  vTaskDelete(NULL);
+}
+
+BaseType_t evt_group_bench_start(void)
+{
+  BaseType_t err;
+
+  m_group = xEventGroupCreate();
+  if(m_group == NULL) return pdFAIL;
+  idx_evt_group_init(&m_idx_group);
+
+  // all three preempt the bench task as soon as their bits are set
+  err = xTaskCreate(waiter_task, "EWT", configMINIMAL_STACK_SIZE + 40, NULL, 2, NULL);
+  if(err != pdPASS) return err;
+
+  err = xTaskCreate(idx_waiter_task, "EWI", configMINIMAL_STACK_SIZE + 40, NULL, 2, NULL);
+  if(err != pdPASS) return err;
+
+  err = xTaskCreate(partner_task, "ESY", configMINIMAL_STACK_SIZE + 40, NULL, 2, NULL);
+  if(err != pdPASS) return err;
+
+  return xTaskCreate(
+                      bench_task,                     // pointer to the task function
+                      "BNC",                          // task name mainly for debugging
+                      configMINIMAL_STACK_SIZE + 200, // task stack depth in words
+                      NULL,                           // task arguments
+                      1,                              // below the waiters
+                      NULL
+                    );
+}
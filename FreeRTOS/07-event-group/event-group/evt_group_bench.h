@@ -0,0 +1,18 @@
+/*
+  Event group primitives on the benchmark harness
+*/
+
+#ifndef EVT_GROUP_BENCH_H
+#define EVT_GROUP_BENCH_H
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Create the benchmark tasks, JSON results are printed when they
+ *        finish
+ *
+ * @return pdPASS or pdFAIL on insufficient heap memory
+ */
+BaseType_t evt_group_bench_start(void);
+
+#endif /* EVT_GROUP_BENCH_H */
@@ -0,0 +1,234 @@
+/*
+  Interrupt to task latency and loss of the deferred and the direct
+  event group set path
+
+  TIMER1 floods the CPU with compare interrupts, each one sets EVENT_BIT
+  for a waiter task at configTIMER_TASK_PRIORITY, the priority of the timer
+  daemon task the deferred path goes through:
+
+  - deferred: xEventGroupSetBitsFromISR() posts the set to the timer daemon
+    task, the waiter runs after the daemon. A post that finds the timer
+    queue full fails and the event is lost
+  - direct: idx_evt_group_set_bits_from_isr() readies the waiter in the
+    interrupt, the waiter runs on the interrupt exit
+
+  Latency goes from the first interrupt after the waiter last ran to the
+  waiter running again. Events set while the bit is still pending merge into
+  one wake up, like with any event group, they are counted as merged and
+  not as lost.
+*/
+
+#include "evt_isr_bench.h"
+#include "task.h"
+#include "event_groups.h"
+#include "idx_evt_group.h"
+#include "cycle_counter.h"
+#include "app_util_platform.h"
+#include "nrf_timer.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+#define BENCH_TIMER             NRF_TIMER1
+#define BENCH_TIMER_IRQn        TIMER1_IRQn
+#define BENCH_TIMER_IRQHandler  TIMER1_IRQHandler
+#define BENCH_IRQ_PRIORITY      APP_IRQ_PRIORITY_HIGH   // highest allowed to call FreeRTOS
+
+#define BENCH_WINDOW_MS         1000
+#define EVENT_BIT               (1UL << 0)
+
+#define CYCLES_PER_US           (SystemCoreClock / 1000000UL)
+
+// interrupt periods in us, from idle to flood
+static const uint32_t k_periods_us[] = { 1000, 100, 20, 10 };
+
+typedef struct
+{
+  uint32_t events;
+  uint32_t wakes;
+  uint32_t lost;
+  uint32_t avg_us;
+  uint32_t max_us;
+}result_t;
+
+static EventGroupHandle_t m_kernel_group;
+static idx_evt_group_t m_idx_group;
+
+static volatile bool m_direct;
+static volatile bool m_pending;        // an event is on its way to the waiter
+static volatile uint32_t m_stamp;      // cycles of the first event not seen yet
+
+static volatile uint32_t m_events;
+static volatile uint32_t m_lost;
+static volatile uint32_t m_wakes;
+static volatile uint32_t m_latency_total;
+static volatile uint32_t m_latency_max;
+
+void BENCH_TIMER_IRQHandler(void)
+{
+  BaseType_t higher_prio_woken = pdFALSE;
+  uint32_t now = cycle_counter_get();
+  bool first = !m_pending;
+
+  nrf_timer_event_clear(BENCH_TIMER, NRF_TIMER_EVENT_COMPARE0);
+
+  m_events++;
+  if(first)
+  {
+    m_pending = true;
+    m_stamp = now;
+  }
+
+  if(m_direct)
+  {
+    (void)idx_evt_group_set_bits_from_isr(&m_idx_group, EVENT_BIT, &higher_prio_woken);
+  }
+  else if(xEventGroupSetBitsFromISR(m_kernel_group, EVENT_BIT, &higher_prio_woken) != pdPASS)
+  {
+    // timer queue full, the waiter never hears about this event
+    m_lost++;
+    if(first) m_pending = false;
+  }
+
+  portYIELD_FROM_ISR(higher_prio_woken);
+}
+
+static void event_seen(void)
+{
+  uint32_t now = cycle_counter_get();
+
+  taskENTER_CRITICAL();
+  uint32_t latency = now - m_stamp;
+  m_pending = false;
+  taskEXIT_CRITICAL();
+
+  m_wakes++;
+  m_latency_total += latency;
+  if(latency > m_latency_max) m_latency_max = latency;
+}
+
+static void kernel_waiter_task(void* pvParameters)
+{
+  while(true)
+  {
+    (void)xEventGroupWaitBits(m_kernel_group, EVENT_BIT, pdTRUE, pdFALSE, portMAX_DELAY);
+    event_seen();
+  }
+}
+
+static void idx_waiter_task(void* pvParameters)
+{
+  while(true)
+  {
+    (void)idx_evt_group_wait_bits(&m_idx_group, EVENT_BIT, pdTRUE, pdFALSE, portMAX_DELAY);
+    event_seen();
+  }
+}
+
+static void timer_init(void)
+{
+  nrf_timer_task_trigger(BENCH_TIMER, NRF_TIMER_TASK_STOP);
+  nrf_timer_task_trigger(BENCH_TIMER, NRF_TIMER_TASK_CLEAR);
+  nrf_timer_mode_set(BENCH_TIMER, NRF_TIMER_MODE_TIMER);
+  nrf_timer_bit_width_set(BENCH_TIMER, NRF_TIMER_BIT_WIDTH_32);
+  nrf_timer_frequency_set(BENCH_TIMER, NRF_TIMER_FREQ_1MHz);
+  nrf_timer_shorts_enable(BENCH_TIMER, NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK);
+  nrf_timer_event_clear(BENCH_TIMER, NRF_TIMER_EVENT_COMPARE0);
+  nrf_timer_int_enable(BENCH_TIMER, NRF_TIMER_INT_COMPARE0_MASK);
+
+  NVIC_SetPriority(BENCH_TIMER_IRQn, BENCH_IRQ_PRIORITY);
+  NVIC_ClearPendingIRQ(BENCH_TIMER_IRQn);
+  NVIC_EnableIRQ(BENCH_TIMER_IRQn);
+}
+
+static result_t bench_run(bool direct, uint32_t period_us)
+{
+  result_t result;
+
+  m_direct = direct;
+  m_pending = false;
+  m_events = 0;
+  m_lost = 0;
+  m_wakes = 0;
+  m_latency_total = 0;
+  m_latency_max = 0;
+
+  // register write, the HAL name of this call differs between nrfx versions
+  BENCH_TIMER->CC[0] = period_us;
+  nrf_timer_task_trigger(BENCH_TIMER, NRF_TIMER_TASK_CLEAR);
+  nrf_timer_task_trigger(BENCH_TIMER, NRF_TIMER_TASK_START);
+
+  vTaskDelay(pdMS_TO_TICKS(BENCH_WINDOW_MS));
+
+  nrf_timer_task_trigger(BENCH_TIMER, NRF_TIMER_TASK_STOP);
+  // let the last event drain before reading the counters
+  vTaskDelay(2);
+
+  result.events = m_events;
+  result.wakes = m_wakes;
+  result.lost = m_lost;
+  result.avg_us = (m_wakes > 0) ? (m_latency_total / m_wakes) / CYCLES_PER_US : 0;
+  result.max_us = m_latency_max / CYCLES_PER_US;
+  return result;
+}
+
+static void print_result(const char* name, uint32_t period_us, const result_t* p_result)
+{
+  uint32_t merged = p_result->events - p_result->wakes - p_result->lost;
+
+  printf("%6u %-8s %7u %7u %7u %7u %6u %6u\r\n", (unsigned)period_us, name,
+         (unsigned)p_result->events, (unsigned)p_result->wakes,
+         (unsigned)merged, (unsigned)p_result->lost,
+         (unsigned)p_result->avg_us, (unsigned)p_result->max_us);
+}
+
+static void bench_task(void* pvParameters)
+{
+  result_t deferred;
+  result_t direct;
+
+  cycle_counter_init();
+  timer_init();
+
+  printf("\r\nISR to task, %u ms per run, timer queue of %u\r\n",
+         (unsigned)BENCH_WINDOW_MS, (unsigned)configTIMER_QUEUE_LENGTH);
+  printf("period path      events   wakes  merged    lost avg us max us\r\n");
+
+  for(uint32_t i = 0; i < sizeof(k_periods_us) / sizeof(k_periods_us[0]); i++)
+  {
+    deferred = bench_run(false, k_periods_us[i]);
+    direct = bench_run(true, k_periods_us[i]);
+
+    print_result("deferred", k_periods_us[i], &deferred);
+    print_result("direct", k_periods_us[i], &direct);
+  }
+
+  NVIC_DisableIRQ(BENCH_TIMER_IRQn);
+  vTaskDelete(NULL);
+}
+
+BaseType_t evt_isr_bench_start(void)
+{
+  BaseType_t err;
+
+  m_kernel_group = xEventGroupCreate();
+  if(m_kernel_group == NULL) return pdFAIL;
+  idx_evt_group_init(&m_idx_group);
+
+  // waiters at the timer daemon priority, the deferred path can't do better
+  err = xTaskCreate(kernel_waiter_task, "WK", configMINIMAL_STACK_SIZE + 60, NULL,
+                    configTIMER_TASK_PRIORITY, NULL);
+  if(err != pdPASS) return err;
+
+  err = xTaskCreate(idx_waiter_task, "WI", configMINIMAL_STACK_SIZE + 60, NULL,
+                    configTIMER_TASK_PRIORITY, NULL);
+  if(err != pdPASS) return err;
+
+  return xTaskCreate(
+                      bench_task,                     // pointer to the task function
+                      "BNC",                          // task name mainly for debugging
+                      configMINIMAL_STACK_SIZE + 200, // task stack depth in words
+                      NULL,                           // task arguments
+                      1,                              // below the waiters
+                      NULL
+                    );
+}
@@ -0,0 +1,18 @@
+/*
+  Interrupt to task latency and loss of the deferred and the direct
+  event group set path
+*/
+
+#ifndef EVT_ISR_BENCH_H
+#define EVT_ISR_BENCH_H
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Create the benchmark tasks, results are printed when they finish
+ *
+ * @return pdPASS or pdFAIL on insufficient heap memory
+ */
+BaseType_t evt_isr_bench_start(void);
+
+#endif /* EVT_ISR_BENCH_H */
@@ -10,10 +10,30 @@
 #include "task.h"
 #include "event_groups.h"
 #include "nrf_drv_clock.h"
+#include "app_diag.h"
+#include "evt_bench.h"
+#include "evt_isr_bench.h"
+#include "evt_group_bench.h"
+#include "isr_stress.h"
 
 #define EVT_GROUP_BIT_0 (1UL << 0UL)
 #define EVT_GROUP_BIT_1 (1UL << 1UL)
 
+// 1 = only run the set bits latency benchmark in evt_bench.c
+#define RUN_EVT_BENCHMARK 0
+// 1 = only run the interrupt flood benchmark in evt_isr_bench.c
+#define RUN_EVT_ISR_BENCHMARK 0
+// 1 = only run the primitive benchmark in evt_group_bench.c, the host
+// Makefile sets it for make bench
+#ifndef RUN_EVT_GROUP_BENCHMARK
+#define RUN_EVT_GROUP_BENCHMARK 0
+#endif
+// 1 = only run the ...FromISR stress test in common/isr_stress.c, the host
+// Makefile sets it for make stress
+#ifndef RUN_ISR_STRESS
+#define RUN_ISR_STRESS 0
+#endif
+
 EventGroupHandle_t evt_group;
 
 void evt_group_setting_task(void* pvParameters)
@@ -69,6 +89,49 @@ int main(void)
   err_code = nrf_drv_clock_init();
   APP_ERROR_CHECK(err_code);
 
+  // RAM report, heap trace and sleep profiler, see app_diag.h
+  if(!app_diag_init())
+  {
+    return -1;
+  }
+
+#if RUN_EVT_BENCHMARK
+  task_err = evt_bench_start();
+
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Bench create fail\r\n");
+    return -1;
+  }
+#elif RUN_EVT_ISR_BENCHMARK
+  task_err = evt_isr_bench_start();
+
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Bench create fail\r\n");
+    return -1;
+  }
+#elif RUN_EVT_GROUP_BENCHMARK
+  task_err = evt_group_bench_start();
+
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Bench create fail\r\n");
+    return -1;
+  }
+#elif RUN_ISR_STRESS
+  task_err = isr_stress_start();
+
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Stress create fail\r\n");
+    return -1;
+  }
+#else
   // function returns the handle to event group if created
   evt_group = xEventGroupCreate();
 
@@ -109,6 +172,10 @@ int main(void)
     printf("Task 2 create fail\r\n");
     return -1;
   }
+#endif
+
+  // stack guard and RAM power-down, see app_diag.h
+  app_diag_before_scheduler();
 
   /* Activate deep sleep mode */
   SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
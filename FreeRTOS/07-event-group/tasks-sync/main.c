@@ -10,12 +10,22 @@
 #include "task.h"
 #include "event_groups.h"
 #include "nrf_drv_clock.h"
-#include "stdlib.h"
+#include "app_diag.h"
+#include "rng_entropy.h"
+#include "prng.h"
+#include "wide_sync.h"
+#include "prng_bench.h"
+#include <stdint.h>
 
 #define TASK1_EVT_GROUP_BIT   (1UL << 0UL)
 #define TASK2_EVT_GROUP_BIT   (1UL << 1UL)
 #define TASK3_EVT_GROUP_BIT   (1UL << 2UL)
 
+// 1 = run the 40 task rendezvous of wide_sync.c instead of the 3 tasks below
+#define RUN_WIDE_SYNC 0
+// 1 = only run the random number throughput benchmark in prng_bench.c
+#define RUN_PRNG_BENCHMARK 0
+
 static const TickType_t k_max_delay = pdMS_TO_TICKS(2000);
 static const TickType_t k_min_delay = pdMS_TO_TICKS(200);
 
@@ -26,12 +36,15 @@ void task1_function(void* pvParameters)
 {
   printf("Task 1 started\r\n");  
   TickType_t wait;
+  // own generator, rand() state is shared by all tasks
+  prng_t prng;
+  prng_seed_from_entropy(&prng);
 
-  EventBits_t sync_bit = (EventBits_t)pvParameters;
+  EventBits_t sync_bit = (EventBits_t)(uintptr_t)pvParameters;
   
   while(true)
   {
-    wait = (rand() % k_max_delay) + k_min_delay;
+    wait = prng_range(&prng, k_max_delay) + k_min_delay;
     vTaskDelay(wait);
     printf("Task 1 reached SYNC point\r\n");
     xEventGroupSync(evt_group,        // event group handle
@@ -46,12 +59,15 @@ void task2_function(void* pvParameters)
 {
   printf("Task 2 started\r\n");  
   TickType_t wait;
+  // own generator, rand() state is shared by all tasks
+  prng_t prng;
+  prng_seed_from_entropy(&prng);
 
-  EventBits_t sync_bit = (EventBits_t)pvParameters;
+  EventBits_t sync_bit = (EventBits_t)(uintptr_t)pvParameters;
   
   while(true)
   {
-    wait = (rand() % k_max_delay) + k_min_delay;
+    wait = prng_range(&prng, k_max_delay) + k_min_delay;
     vTaskDelay(wait);
     printf("Task 2 reached SYNC point\r\n");
     xEventGroupSync(evt_group,        // event group handle
@@ -66,12 +82,15 @@ void task3_function(void* pvParameters)
 {
   printf("Task 3 started\r\n");  
   TickType_t wait;
+  // own generator, rand() state is shared by all tasks
+  prng_t prng;
+  prng_seed_from_entropy(&prng);
 
-  EventBits_t sync_bit = (EventBits_t)pvParameters;
+  EventBits_t sync_bit = (EventBits_t)(uintptr_t)pvParameters;
   
   while(true)
   {
-    wait = (rand() % k_max_delay) + k_min_delay;
+    wait = prng_range(&prng, k_max_delay) + k_min_delay;
     vTaskDelay(wait);
     printf("Task 3 reached SYNC point\r\n");
     xEventGroupSync(evt_group,        // event group handle
@@ -91,6 +110,35 @@ int main(void)
   err_code = nrf_drv_clock_init();
   APP_ERROR_CHECK(err_code);
 
+  // RAM report, heap trace and sleep profiler, see app_diag.h
+  if(!app_diag_init())
+  {
+    return -1;
+  }
+
+  // seeds of the task generators
+  err_code = rng_entropy_init();
+  APP_ERROR_CHECK(err_code);
+
+#if RUN_WIDE_SYNC
+  task_err = wide_sync_start();
+
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Workers create fail\r\n");
+    return -1;
+  }
+#elif RUN_PRNG_BENCHMARK
+  task_err = prng_bench_start();
+
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Bench create fail\r\n");
+    return -1;
+  }
+#else
   // function returns the handle to event group if created
   evt_group = xEventGroupCreate();
 
@@ -109,6 +157,13 @@ int main(void)
                           NULL
                         );
 
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Task 1 create fail\r\n");
+    return -1;
+  }
+
   task_err = xTaskCreate(
                         task2_function,                 // pointer to the task function
                         "Task2",                        // task name mainly for debugging
@@ -118,6 +173,13 @@ int main(void)
                         NULL
                       );
 
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Task 2 create fail\r\n");
+    return -1;
+  }
+
   task_err = xTaskCreate(
                         task3_function,                 // pointer to the task function
                         "Task3",                        // task name mainly for debugging
@@ -127,6 +189,17 @@ int main(void)
                         NULL
                         );
 
+  // pdFAIL = insufficient heap memory
+  if(task_err == pdFAIL)
+  {
+    printf("Task 3 create fail\r\n");
+    return -1;
+  }
+#endif
+
+  // stack guard and RAM power-down, see app_diag.h
+  app_diag_before_scheduler();
+
   /* Activate deep sleep mode */
   SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
 
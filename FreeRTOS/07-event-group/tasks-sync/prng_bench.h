@@ -0,0 +1,17 @@
+/*
+  Throughput of rand(), prng_t and the RNG entropy pool
+*/
+
+#ifndef PRNG_BENCH_H
+#define PRNG_BENCH_H
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Create the benchmark task, results are printed when it finishes
+ *
+ * @return pdPASS or pdFAIL on insufficient heap memory
+ */
+BaseType_t prng_bench_start(void);
+
+#endif /* PRNG_BENCH_H */
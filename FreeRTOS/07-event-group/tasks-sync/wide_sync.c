@@ -0,0 +1,73 @@
+/*
+  Rendezvous of more tasks than the 24 bits of a kernel event group
+
+  Same pattern as the three tasks in main.c with SYNC_WORKERS tasks, each
+  one owning a bit of a 64-bit idx_evt_group_t. Every worker waits a random
+  time, then sets its bit and waits for all others in one
+  idx_evt_group_sync() call. Worker 0 prints the rounds.
+*/
+
+#include "wide_sync.h"
+#include "task.h"
+#include "idx_evt_group.h"
+#include "prng.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define SYNC_WORKERS    40
+
+#if IDX_EVT_GROUP_BITS < SYNC_WORKERS || IDX_EVT_GROUP_MAX_WAITERS < SYNC_WORKERS
+#error "set IDX_EVT_GROUP_BITS and IDX_EVT_GROUP_MAX_WAITERS to 64 in FreeRTOSConfig.h"
+#endif
+
+static const TickType_t k_max_delay = pdMS_TO_TICKS(500);
+static const TickType_t k_min_delay = pdMS_TO_TICKS(20);
+
+static const idx_evt_bits_t k_all_sync_bits = IDX_EVT_BIT(SYNC_WORKERS) - 1;
+
+static idx_evt_group_t m_sync_group;
+
+static void worker_task(void* pvParameters)
+{
+  uint32_t index = (uint32_t)(uintptr_t)pvParameters;
+  uint32_t round = 0;
+  prng_t prng;
+
+  prng_seed_from_entropy(&prng);
+
+  while(true)
+  {
+    vTaskDelay(prng_range(&prng, k_max_delay) + k_min_delay);
+
+    (void)idx_evt_group_sync(&m_sync_group,       // event group
+                             IDX_EVT_BIT(index),  // the bit used by this task to show SYNC
+                             k_all_sync_bits,     // the bits to wait for
+                             portMAX_DELAY);      // wait indefinitely
+    round++;
+
+    if(index == 0)
+    {
+      printf("%u workers exited SYNC, round %u\r\n", (unsigned)SYNC_WORKERS, (unsigned)round);
+    }
+  }
+}
+
+BaseType_t wide_sync_start(void)
+{
+  idx_evt_group_init(&m_sync_group);
+
+  for(uint32_t i = 0; i < SYNC_WORKERS; i++)
+  {
+    BaseType_t err = xTaskCreate(
+                                  worker_task,                    // pointer to the task function
+                                  "W",                            // task name mainly for debugging
+                                  configMINIMAL_STACK_SIZE + 60,  // task stack depth in words
+                                  (void*)(uintptr_t)i,            // task arguments carrying the bit index
+                                  1,                              // task priority
+                                  NULL
+                                );
+    if(err != pdPASS) return err;
+  }
+
+  return pdPASS;
+}
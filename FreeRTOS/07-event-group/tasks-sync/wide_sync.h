@@ -0,0 +1,17 @@
+/*
+  Rendezvous of more tasks than the 24 bits of a kernel event group
+*/
+
+#ifndef WIDE_SYNC_H
+#define WIDE_SYNC_H
+
+#include "FreeRTOS.h"
+
+/**
+ * @brief Create the worker tasks
+ *
+ * @return pdPASS or pdFAIL on insufficient heap memory
+ */
+BaseType_t wide_sync_start(void);
+
+#endif /* WIDE_SYNC_H */
@@ -0,0 +1,37 @@
+/*
+  Diagnostics every example starts the same way, see app_diag.h
+*/
+
+#include "app_diag.h"
+#include "FreeRTOS.h"
+#include "heap_tlsf.h"
+#include "heap_trace.h"
+#include "ram_power.h"
+#include "sleep_prof.h"
+#include "stack_guard.h"
+#include <stdio.h>
+
+bool app_diag_init(void)
+{
+  heap_tlsf_ram_report();
+
+  if(!heap_trace_start())
+  {
+    printf("Heap trace create fail\r\n");
+    return false;
+  }
+
+  if(!sleep_prof_start())
+  {
+    printf("Sleep profiler create fail\r\n");
+    return false;
+  }
+
+  return true;
+}
+
+void app_diag_before_scheduler(void)
+{
+  stack_guard_init();
+  (void)ram_power_apply();
+}
@@ -0,0 +1,38 @@
+/*
+  Diagnostics every example starts the same way
+
+  Each main() calls app_diag_init() right after the clock driver and
+  app_diag_before_scheduler() right before vTaskStartScheduler(), once its
+  tasks and queues exist. What they start is switched per example in
+  config/FreeRTOSConfig.h, a diagnostic switched off costs nothing:
+
+  - heap_tlsf_ram_report(), static data, stack and heap split, always
+  - heap_trace_start(), heap call-site trace, HEAP_TRACE_ENABLED
+  - sleep_prof_start(), tickless sleep profile, SLEEP_PROF_ENABLED
+  - stack_guard_init(), MPU guard below the running stack, STACK_GUARD_ENABLED
+  - ram_power_apply(), power-down of unused RAM, RAM_POWER_ENABLED
+
+  A new diagnostic is added here and to the projects, not to every main().
+*/
+
+#ifndef APP_DIAG_H
+#define APP_DIAG_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Print the RAM split, start the heap trace and sleep profiler,
+ *        call from main() before creating tasks
+ *
+ * @return false if a diagnostic task could not be created, the failing one
+ *         is printed
+ */
+bool app_diag_init(void);
+
+/**
+ * @brief Arm the stack guard and power off unused RAM, call from main()
+ *        after the last task or queue, right before vTaskStartScheduler()
+ */
+void app_diag_before_scheduler(void);
+
+#endif /* APP_DIAG_H */
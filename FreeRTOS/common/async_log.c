@@ -0,0 +1,255 @@
+/*
+  Asynchronous non-blocking logger, see async_log.h
+*/
+
+#include "async_log.h"
+#include "task.h"
+#include "nrf_atomic.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SLOT_MASK (ASYNC_LOG_SLOT_COUNT - 1)
+
+#if (ASYNC_LOG_SLOT_COUNT & SLOT_MASK) != 0
+#error "ASYNC_LOG_SLOT_COUNT must be a power of 2"
+#endif
+
+#if ASYNC_LOG_SLOT_SIZE > 258
+#error "ASYNC_LOG_SLOT_SIZE must fit the 8-bit length field"
+#endif
+
+#if ASYNC_LOG_BATCH_SIZE < ASYNC_LOG_SLOT_SIZE
+#error "ASYNC_LOG_BATCH_SIZE must hold at least one slot"
+#endif
+
+typedef struct
+{
+  volatile uint8_t ready; // set by the producer once data is complete
+  uint8_t len;
+  char data[ASYNC_LOG_SLOT_SIZE - 2];
+}slot_t;
+
+static slot_t m_slots[ASYNC_LOG_SLOT_COUNT];
+
+// free running indexes, head is moved by producers inside the critical
+// section, tail only by the drain task
+static volatile uint32_t m_head = 0;
+static volatile uint32_t m_tail = 0;
+
+static uint32_t m_max_used = 0;
+static volatile uint32_t m_dropped = 0;
+static volatile uint32_t m_written = 0;
+static volatile uint32_t m_bytes = 0;
+static nrf_atomic_u32_t m_truncated = 0;
+
+static TaskHandle_t m_drain_task = NULL;
+static async_log_write_t m_write = NULL;
+
+static inline bool in_isr(void)
+{
+  return __get_IPSR() != 0;
+}
+
+// byte by byte, printf("%.*s") stops at the first 0x00 of a bin_log frame
+static void stdout_write(const char* data, size_t len)
+{
+  for(size_t i = 0; i < len; i++)
+  {
+    (void)putchar((unsigned char)data[i]);
+  }
+}
+
+// the only critical section on the caller side, a few instructions long.
+// stamp is read in it when a slot is free, NULL for none
+static slot_t* slot_reserve(bool* p_was_empty, async_log_stamp_t stamp, uint32_t* p_stamp)
+{
+  slot_t* p_slot = NULL;
+  UBaseType_t isr_state = 0;
+  bool isr = in_isr();
+
+  if(isr)
+  {
+    isr_state = taskENTER_CRITICAL_FROM_ISR();
+  }
+  else
+  {
+    taskENTER_CRITICAL();
+  }
+
+  uint32_t used = m_head - m_tail;
+  if(used < ASYNC_LOG_SLOT_COUNT)
+  {
+    p_slot = &m_slots[m_head & SLOT_MASK];
+    m_head++;
+    used++;
+    if(used > m_max_used) m_max_used = used;
+    *p_was_empty = (used == 1);
+    if(stamp != NULL) *p_stamp = stamp();
+  }
+  else
+  {
+    m_dropped++;
+  }
+
+  if(isr)
+  {
+    taskEXIT_CRITICAL_FROM_ISR(isr_state);
+  }
+  else
+  {
+    taskEXIT_CRITICAL();
+  }
+
+  return p_slot;
+}
+
+static void slot_commit(slot_t* p_slot, bool was_empty)
+{
+  // message must be complete in memory before the drain task sees ready
+  __DMB();
+  p_slot->ready = 1;
+
+  // the drain task sleeps only on an empty ring, so it needs a wake up when
+  // the first slot after empty is committed
+  if(was_empty && m_drain_task != NULL)
+  {
+    if(in_isr())
+    {
+      BaseType_t higher_prio_woken = pdFALSE;
+      vTaskNotifyGiveFromISR(m_drain_task, &higher_prio_woken);
+      portYIELD_FROM_ISR(higher_prio_woken);
+    }
+    else
+    {
+      xTaskNotifyGive(m_drain_task);
+    }
+  }
+}
+
+bool async_log_vprintf(const char* fmt, va_list args)
+{
+  bool was_empty;
+  slot_t* p_slot = slot_reserve(&was_empty, NULL, NULL);
+  if(p_slot == NULL) return false;
+
+  int len = vsnprintf(p_slot->data, sizeof(p_slot->data), fmt, args);
+  if(len < 0)
+  {
+    len = 0;
+  }
+  else if(len > ASYNC_LOG_MSG_MAX_LEN)
+  {
+    len = ASYNC_LOG_MSG_MAX_LEN;
+    (void)nrf_atomic_u32_add(&m_truncated, 1);
+  }
+  p_slot->len = (uint8_t)len;
+
+  slot_commit(p_slot, was_empty);
+  return true;
+}
+
+bool async_log_printf(const char* fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  bool queued = async_log_vprintf(fmt, args);
+  va_end(args);
+  return queued;
+}
+
+bool async_log_write(const void* data, size_t len)
+{
+  return async_log_write_stamped(data, len, 0, NULL);
+}
+
+bool async_log_write_stamped(const void* data, size_t len, size_t stamp_offset, async_log_stamp_t stamp)
+{
+  uint32_t stamp_value = 0;
+
+  if(len > ASYNC_LOG_MSG_MAX_LEN) return false;
+  if(stamp != NULL && stamp_offset + sizeof(stamp_value) > len) return false;
+
+  bool was_empty;
+  slot_t* p_slot = slot_reserve(&was_empty, stamp, &stamp_value);
+  if(p_slot == NULL) return false;
+
+  memcpy(p_slot->data, data, len);
+  if(stamp != NULL) memcpy(&p_slot->data[stamp_offset], &stamp_value, sizeof(stamp_value));
+  p_slot->len = (uint8_t)len;
+
+  slot_commit(p_slot, was_empty);
+  return true;
+}
+
+void async_log_stats_get(async_log_stats_t* p_stats)
+{
+  taskENTER_CRITICAL();
+  p_stats->written = m_written;
+  p_stats->bytes = m_bytes;
+  p_stats->dropped = m_dropped;
+  p_stats->truncated = m_truncated;
+  p_stats->max_used = m_max_used;
+  taskEXIT_CRITICAL();
+}
+
+static void drain_task(void* pvParameters)
+{
+  static char batch[ASYNC_LOG_BATCH_SIZE];
+  uint32_t reported_drops = 0;
+
+  while(true)
+  {
+    size_t len = 0;
+
+    uint32_t dropped = m_dropped;
+    if(dropped != reported_drops)
+    {
+      int n = snprintf(batch, sizeof(batch), "[log] %u dropped\r\n", (unsigned)(dropped - reported_drops));
+      if(n > 0) len = (size_t)n;
+      reported_drops = dropped;
+    }
+
+    // copy finished slots in order, stop at the first one still being
+    // formatted so the output order matches the reservation order
+    while(m_tail != m_head)
+    {
+      slot_t* p_slot = &m_slots[m_tail & SLOT_MASK];
+      if(!p_slot->ready) break;
+      if(len + p_slot->len > sizeof(batch)) break;
+
+      memcpy(&batch[len], p_slot->data, p_slot->len);
+      len += p_slot->len;
+
+      p_slot->ready = 0;
+      __DMB();
+      // slot can be reused from here on
+      m_tail++;
+      m_written++;
+      m_bytes += p_slot->len;
+    }
+
+    if(len > 0)
+    {
+      m_write(batch, len);
+      continue;
+    }
+
+    // empty ring: sleep until the next commit, otherwise the tail slot is
+    // still being written by a preempted caller, poll it every tick
+    ulTaskNotifyTake(pdTRUE, (m_tail == m_head) ? portMAX_DELAY : 1);
+  }
+}
+
+BaseType_t async_log_init(UBaseType_t priority, async_log_write_t write)
+{
+  m_write = (write != NULL) ? write : stdout_write;
+
+  return xTaskCreate(
+                      drain_task,                 // pointer to the task function
+                      "LOG",                      // task name mainly for debugging
+                      ASYNC_LOG_TASK_STACK_SIZE,  // task stack depth in words
+                      NULL,                       // task arguments
+                      priority,                   // keep below the logging tasks
+                      &m_drain_task
+                    );
+}
@@ -0,0 +1,106 @@
+/*
+  Asynchronous non-blocking logger
+
+  print_with_mutex() keeps the printing mutex for the whole blocking printf()
+  and drops the message if the mutex isn't free within 10 ms. Here the caller
+  only formats into a ring of fixed size slots, the slot is reserved in one
+  short critical section and the text is written outside of it. A low priority
+  drain task copies finished slots into a batch and writes the batch at once.
+
+  - callers never block, from a task or an ISR
+  - a full ring drops the message and counts it, the drain task reports the
+    count with the next batch
+  - messages longer than a slot are truncated and counted
+*/
+
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include "FreeRTOS.h"
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// number of slots, must be a power of 2
+#ifndef ASYNC_LOG_SLOT_COUNT
+#define ASYNC_LOG_SLOT_COUNT    16
+#endif
+
+// bytes per slot including the 2 byte header
+#ifndef ASYNC_LOG_SLOT_SIZE
+#define ASYNC_LOG_SLOT_SIZE     64
+#endif
+
+// bytes written by the drain task in one call of the write function
+#ifndef ASYNC_LOG_BATCH_SIZE
+#define ASYNC_LOG_BATCH_SIZE    256
+#endif
+
+#ifndef ASYNC_LOG_TASK_STACK_SIZE
+#define ASYNC_LOG_TASK_STACK_SIZE (configMINIMAL_STACK_SIZE + 200)
+#endif
+
+// largest message kept without truncation, slot minus the 2 byte header and
+// the NUL written by vsnprintf()
+#define ASYNC_LOG_MSG_MAX_LEN   (ASYNC_LOG_SLOT_SIZE - 3)
+
+// output function used by the drain task, data is not NUL terminated
+typedef void (*async_log_write_t)(const char* data, size_t len);
+
+// time stamp of async_log_write_stamped(), called with interrupts masked
+typedef uint32_t (*async_log_stamp_t)(void);
+
+typedef struct
+{
+  uint32_t written;     // messages handed to the write function
+  uint32_t bytes;       // bytes of those messages
+  uint32_t dropped;     // messages lost because the ring was full
+  uint32_t truncated;   // messages cut to ASYNC_LOG_MSG_MAX_LEN
+  uint32_t max_used;    // high water mark of used slots
+}async_log_stats_t;
+
+/**
+ * @brief Create the drain task
+ *
+ * @param priority - drain task priority, keep it below the logging tasks
+ * @param write    - output function, NULL writes to stdout with putchar()
+ *
+ * @return pdPASS or pdFAIL on insufficient heap memory
+ */
+BaseType_t async_log_init(UBaseType_t priority, async_log_write_t write);
+
+/**
+ * @brief Format a message into the ring, never blocks
+ *
+ * @return true if queued, false if dropped
+ */
+bool async_log_printf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief va_list variant of async_log_printf()
+ */
+bool async_log_vprintf(const char* fmt, va_list args);
+
+/**
+ * @brief Copy raw bytes into the ring, never blocks
+ *
+ * @return true if queued, false if dropped or len > ASYNC_LOG_MSG_MAX_LEN
+ */
+bool async_log_write(const void* data, size_t len);
+
+/**
+ * @brief Copy raw bytes into the ring with a 32-bit stamp at stamp_offset,
+ *        never blocks. The stamp is read in the critical section that
+ *        reserves the slot, so messages leave the ring in stamp order
+ *
+ * @return true if queued, false if dropped or the stamp is outside data
+ */
+bool async_log_write_stamped(const void* data, size_t len, size_t stamp_offset, async_log_stamp_t stamp);
+
+/**
+ * @brief Snapshot of the counters
+ */
+void async_log_stats_get(async_log_stats_t* p_stats);
+
+#endif /* ASYNC_LOG_H */
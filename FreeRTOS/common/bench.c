@@ -0,0 +1,119 @@
+/*
+  Benchmark harness with machine-readable results, see bench.h
+*/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "bench.h"
+#include "cycle_counter.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define OVERHEAD_ROUNDS   16
+
+static uint32_t m_samples[BENCH_MAX_ITERATIONS];
+
+static void empty_run(void* p_context)
+{
+}
+
+// timing an empty call through the same pointer, the fastest of a few
+static uint32_t overhead_get(void)
+{
+  void (*volatile run)(void*) = empty_run;
+  uint32_t best = UINT32_MAX;
+
+  for(uint32_t i = 0; i < OVERHEAD_ROUNDS; i++)
+  {
+    uint32_t start = cycle_counter_get();
+    run(NULL);
+    uint32_t cycles = cycle_counter_get() - start;
+    if(cycles < best) best = cycles;
+  }
+
+  return best;
+}
+
+static void samples_sort(uint32_t* p_samples, uint32_t count)
+{
+  for(uint32_t i = 1; i < count; i++)
+  {
+    uint32_t value = p_samples[i];
+    uint32_t j = i;
+
+    while(j > 0 && p_samples[j - 1] > value)
+    {
+      p_samples[j] = p_samples[j - 1];
+      j--;
+    }
+    p_samples[j] = value;
+  }
+}
+
+void bench_case_run(const bench_case_t* p_case, bench_stats_t* p_stats)
+{
+  uint32_t count = p_case->iterations;
+  if(count > BENCH_MAX_ITERATIONS) count = BENCH_MAX_ITERATIONS;
+
+  cycle_counter_init();
+  p_stats->overhead = overhead_get();
+
+  for(uint32_t i = 0; i < p_case->warmup; i++)
+  {
+    if(p_case->setup != NULL) p_case->setup(p_case->p_context);
+    p_case->run(p_case->p_context);
+  }
+
+  for(uint32_t i = 0; i < count; i++)
+  {
+    if(p_case->setup != NULL) p_case->setup(p_case->p_context);
+
+    uint32_t start = cycle_counter_get();
+    p_case->run(p_case->p_context);
+    uint32_t cycles = cycle_counter_get() - start;
+
+    m_samples[i] = (cycles > p_stats->overhead) ? cycles - p_stats->overhead : 0;
+  }
+
+  if(count == 0)
+  {
+    p_stats->min = p_stats->median = p_stats->p99 = p_stats->max = 0;
+    return;
+  }
+
+  samples_sort(m_samples, count);
+
+  // lower median, p99 is the smallest sample at or above 99 % of them
+  p_stats->min = m_samples[0];
+  p_stats->median = m_samples[(count - 1) / 2];
+  p_stats->p99 = m_samples[(count * 99 + 99) / 100 - 1];
+  p_stats->max = m_samples[count - 1];
+}
+
+void bench_stats_print(const char* suite, const bench_case_t* p_case, const bench_stats_t* p_stats)
+{
+  uint32_t count = p_case->iterations;
+  if(count > BENCH_MAX_ITERATIONS) count = BENCH_MAX_ITERATIONS;
+
+  printf("{\"suite\":\"%s\",\"case\":\"%s\",\"clock\":\"%s\",\"hz\":%u,"
+         "\"warmup\":%u,\"iterations\":%u,\"overhead\":%u,"
+         "\"min\":%u,\"median\":%u,\"p99\":%u,\"max\":%u}\r\n",
+         suite, p_case->name, BENCH_CLOCK, (unsigned)SystemCoreClock,
+         (unsigned)p_case->warmup, (unsigned)count, (unsigned)p_stats->overhead,
+         (unsigned)p_stats->min, (unsigned)p_stats->median,
+         (unsigned)p_stats->p99, (unsigned)p_stats->max);
+}
+
+void bench_suite_run(const char* suite, const bench_case_t* p_cases, size_t count)
+{
+  bench_stats_t stats;
+
+  for(size_t i = 0; i < count; i++)
+  {
+    bench_case_run(&p_cases[i], &stats);
+    bench_stats_print(suite, &p_cases[i], &stats);
+  }
+
+  printf("{\"suite\":\"%s\",\"done\":%u}\r\n", suite, (unsigned)count);
+  BENCH_DONE();
+}
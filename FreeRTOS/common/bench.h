@@ -0,0 +1,90 @@
+/*
+  Benchmark harness with machine-readable results
+
+  A case is a function timed once per iteration, with an optional untimed
+  setup before each one. The harness runs the warmup iterations, times the
+  rest with cycle_counter_get() and subtracts the cost of timing an empty
+  call. On target that is DWT->CYCCNT, on the host build the shim counts
+  CLOCK_MONOTONIC in cycles of the same 64 MHz.
+
+  Each case prints one JSON line on the console, UART on target and stdout
+  on the host, wrapped here:
+
+    {"suite":"queue","case":"send_receive","clock":"dwt","hz":64000000,
+     "warmup":16,"iterations":256,"overhead":6,
+     "min":402,"median":410,"p99":455,"max":1210}
+
+  The last line of a suite is {"suite":"queue","done":3}. Other output can
+  be mixed in, tools/bench_compare.py only reads the JSON lines and
+  compares them with a stored baseline.
+
+  The samples live in one static buffer, run one suite at a time.
+
+  Cases are preempted like any other code, the tick and the timer task
+  show up in p99 and max. Run suites instead of the example tasks, not next
+  to them.
+*/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// samples kept per case, a case runs at most this many timed iterations
+#ifndef BENCH_MAX_ITERATIONS
+#define BENCH_MAX_ITERATIONS  256
+#endif
+
+// names the clock in the results, runs on different clocks don't compare
+#ifndef BENCH_CLOCK
+#define BENCH_CLOCK           "dwt"
+#endif
+
+// called after the done line of a suite, the host build exits there
+#ifndef BENCH_DONE
+#define BENCH_DONE()
+#endif
+
+typedef struct
+{
+  const char* name;
+  void (*setup)(void* p_context);   // untimed, before each iteration, may be NULL
+  void (*run)(void* p_context);     // timed
+  void* p_context;
+  uint16_t warmup;
+  uint16_t iterations;
+}bench_case_t;
+
+typedef struct
+{
+  uint32_t min;
+  uint32_t median;
+  uint32_t p99;
+  uint32_t max;
+  uint32_t overhead;                // timing cost subtracted from each sample
+}bench_stats_t;
+
+/**
+ * @brief Run one case, from a task
+ *
+ * @param p_case  - case to run, iterations are capped to BENCH_MAX_ITERATIONS
+ * @param p_stats - cycles of one iteration
+ */
+void bench_case_run(const bench_case_t* p_case, bench_stats_t* p_stats);
+
+/**
+ * @brief Print the JSON line of a case
+ */
+void bench_stats_print(const char* suite, const bench_case_t* p_case, const bench_stats_t* p_stats);
+
+/**
+ * @brief Run and print all cases of a suite, then the done line, from a task
+ *
+ * @param suite   - suite name, the baseline key is suite and case name
+ * @param p_cases - cases in the order to run
+ * @param count   - number of cases
+ */
+void bench_suite_run(const char* suite, const bench_case_t* p_cases, size_t count);
+
+#endif /* BENCH_H */
@@ -0,0 +1,58 @@
+/*
+  Deferred formatting binary logger, see bin_log.h
+*/
+
+#include "bin_log.h"
+#include "async_log.h"
+#include <string.h>
+#if BIN_LOG_TIMESTAMP
+#include "mono_time.h"
+#endif
+
+#define HEADER_SIZE     4
+#define TIMESTAMP_FLAG  0x80
+#define FRAME_MAX_SIZE  (HEADER_SIZE + 4 + BIN_LOG_MAX_ARGS * 4)
+
+#if FRAME_MAX_SIZE > ASYNC_LOG_MSG_MAX_LEN
+#error "ASYNC_LOG_SLOT_SIZE too small for a binary log frame"
+#endif
+
+// placed by flash_placement.xml around the .bin_log_fmt section
+extern const char __start_bin_log_fmt[];
+
+#if BIN_LOG_TIMESTAMP
+static uint32_t timestamp_get(void)
+{
+  return (uint32_t)mono_time_ticks_get();
+}
+#endif
+
+bool bin_log_emit(const char* fmt, const uint32_t* args, uint32_t nargs)
+{
+  uint8_t frame[FRAME_MAX_SIZE];
+  uint32_t id = (uint32_t)(fmt - __start_bin_log_fmt);
+  size_t len = HEADER_SIZE;
+
+  frame[0] = BIN_LOG_SYNC;
+  frame[1] = (uint8_t)id;
+  frame[2] = (uint8_t)(id >> 8);
+  frame[3] = (uint8_t)nargs;
+
+#if BIN_LOG_TIMESTAMP
+  // filled in when the slot is reserved, a frame stamped before a
+  // preemption would otherwise leave the ring after later stamps
+  frame[3] |= TIMESTAMP_FLAG;
+  memset(&frame[len], 0, sizeof(uint32_t));
+  len += sizeof(uint32_t);
+#endif
+
+  // Cortex-M is little endian, arguments go out as they are in memory
+  memcpy(&frame[len], args, nargs * sizeof(uint32_t));
+  len += nargs * sizeof(uint32_t);
+
+#if BIN_LOG_TIMESTAMP
+  return async_log_write_stamped(frame, len, HEADER_SIZE, timestamp_get);
+#else
+  return async_log_write(frame, len);
+#endif
+}
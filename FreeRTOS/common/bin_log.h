@@ -0,0 +1,89 @@
+/*
+  Deferred formatting binary logger
+
+  BIN_LOG() keeps the printf() style call site but the target never formats
+  the text. The format string is placed in the .bin_log_fmt section, the call
+  only sends the string's offset in that section plus the raw 32-bit arguments
+  through the async_log ring. tools/bin_log_decode.py reads the strings back
+  from the ELF file and does the formatting on the host.
+
+  Frame, little endian:
+    0xA5 | id (2 bytes) | nargs (bits 0-3), timestamp flag (bit 7) |
+    [timestamp, 4 bytes] | nargs * 4 bytes
+
+  A log call with two arguments is 12 bytes on the wire (16 with the
+  timestamp) instead of the ~45 character text line. Text printed with
+  printf() or async_log_printf() can be mixed into the same stream if it is
+  ASCII, Latin-1 and UTF-8 text can contain the 0xA5 sync byte. The decoder
+  only takes a 0xA5 as a frame when the next 3 bytes are a valid header and
+  passes it on as text otherwise, a stray one that happens to look like a
+  header decodes as a wrong frame.
+
+  Limits of deferred formatting:
+  - up to 8 arguments, each sent as 32 bits. 64-bit integers and floating
+    point conversions are not supported
+  - a %s argument is sent as the pointer, the decoder can only resolve
+    strings in flash (string literals, const arrays)
+
+  The flash_placement.xml of the project needs the .bin_log_fmt section.
+*/
+
+#ifndef BIN_LOG_H
+#define BIN_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 1 = add the low 32 bits of mono_time_ticks_get() to every frame, read
+// when the ring slot is reserved so frames leave in time order. The
+// project must then also build mono_time.c
+#ifndef BIN_LOG_TIMESTAMP
+#define BIN_LOG_TIMESTAMP   0
+#endif
+
+#define BIN_LOG_SYNC        0xA5
+#define BIN_LOG_MAX_ARGS    8
+
+/**
+ * @brief Log a message with deferred formatting, never blocks
+ *
+ * @param fmt - string literal, printf() syntax
+ */
+#define BIN_LOG(fmt, ...)                                                     \
+  do                                                                          \
+  {                                                                           \
+    static const char bin_log_fmt_[]                                          \
+      __attribute__((section(".bin_log_fmt"), used)) = fmt;                   \
+    const uint32_t bin_log_args_[] =                                          \
+      { 0 BIN_LOG_CAT(BIN_LOG_MAP_, BIN_LOG_NARGS(__VA_ARGS__))(__VA_ARGS__) };\
+    (void)bin_log_emit(bin_log_fmt_, &bin_log_args_[1],                       \
+                       BIN_LOG_NARGS(__VA_ARGS__));                           \
+  } while(0)
+
+/**
+ * @brief Build a frame and queue it in the async_log ring, used by BIN_LOG()
+ *
+ * @return true if queued, false if dropped
+ */
+bool bin_log_emit(const char* fmt, const uint32_t* args, uint32_t nargs);
+
+// argument counting and conversion helpers for BIN_LOG()
+#define BIN_LOG_CAT(a, b)   BIN_LOG_CAT_(a, b)
+#define BIN_LOG_CAT_(a, b)  a##b
+
+#define BIN_LOG_NARGS(...)  BIN_LOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define BIN_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+
+#define BIN_LOG_U32(x)      ((uint32_t)(uintptr_t)(x))
+
+#define BIN_LOG_MAP_0()
+#define BIN_LOG_MAP_1(a)                      , BIN_LOG_U32(a)
+#define BIN_LOG_MAP_2(a, b)                   BIN_LOG_MAP_1(a) , BIN_LOG_U32(b)
+#define BIN_LOG_MAP_3(a, b, c)                BIN_LOG_MAP_2(a, b) , BIN_LOG_U32(c)
+#define BIN_LOG_MAP_4(a, b, c, d)             BIN_LOG_MAP_3(a, b, c) , BIN_LOG_U32(d)
+#define BIN_LOG_MAP_5(a, b, c, d, e)          BIN_LOG_MAP_4(a, b, c, d) , BIN_LOG_U32(e)
+#define BIN_LOG_MAP_6(a, b, c, d, e, f)       BIN_LOG_MAP_5(a, b, c, d, e) , BIN_LOG_U32(f)
+#define BIN_LOG_MAP_7(a, b, c, d, e, f, g)    BIN_LOG_MAP_6(a, b, c, d, e, f) , BIN_LOG_U32(g)
+#define BIN_LOG_MAP_8(a, b, c, d, e, f, g, h) BIN_LOG_MAP_7(a, b, c, d, e, f, g) , BIN_LOG_U32(h)
+
+#endif /* BIN_LOG_H */
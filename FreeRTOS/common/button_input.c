@@ -0,0 +1,215 @@
+/*
+  Interrupt driven button input into a queue, see button_input.h
+*/
+
+#include "button_input.h"
+#include "task.h"
+#include "timers.h"
+#include "mono_time.h"
+#include "boards.h"
+#include "nrf_drv_gpiote.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+typedef struct
+{
+  uint32_t pin;
+  TimerHandle_t debounce_timer;
+  TimerHandle_t long_timer;
+  uint64_t edge_ticks;        // first edge since the level was last read
+  uint64_t press_ticks;       // edge of the press the long timer runs for
+  volatile bool edge_pending;
+  bool pressed;               // last stable level
+}button_t;
+
+static const char* const k_type_names[] = { "press", "release", "long press" };
+
+static button_t m_buttons[BUTTON_INPUT_MAX];
+static uint8_t m_count = 0;
+static QueueHandle_t m_queue = NULL;
+
+static volatile uint32_t m_edges;
+static volatile uint32_t m_timer_fails;   // timer queue full in the interrupt
+static uint32_t m_events[3];
+static uint32_t m_dropped;                // event queue full
+
+// mono_time ticks of the events taken
+static uint32_t m_taken;
+static uint64_t m_edge_latency_sum;
+static uint32_t m_edge_latency_max;
+static uint64_t m_queue_latency_sum;
+static uint32_t m_queue_latency_max;
+
+static bool pin_pressed(uint32_t pin)
+{
+  return nrf_drv_gpiote_in_is_set(pin) == (BUTTONS_ACTIVE_STATE != 0);
+}
+
+static void event_send(uint8_t index, button_evt_type_t type, uint64_t edge_ticks)
+{
+  button_evt_t evt =
+  {
+    .edge_ticks = edge_ticks,
+    .queued_ticks = mono_time_ticks_get(),
+    .button = index,
+    .type = (uint8_t)type
+  };
+
+  m_events[type]++;
+  // daemon task context, must not block
+  if(xQueueSend(m_queue, &evt, 0) != pdPASS) m_dropped++;
+}
+
+static void debounce_timer_callback(TimerHandle_t timer)
+{
+  uint8_t index = (uint8_t)(uintptr_t)pvTimerGetTimerID(timer);
+  button_t* p_button = &m_buttons[index];
+
+  // edges after this read restart the timer and get a new stamp
+  taskENTER_CRITICAL();
+  uint64_t edge_ticks = p_button->edge_ticks;
+  p_button->edge_pending = false;
+  taskEXIT_CRITICAL();
+
+  bool pressed = pin_pressed(p_button->pin);
+
+  // bounced back to where it was
+  if(pressed == p_button->pressed) return;
+  p_button->pressed = pressed;
+
+  if(pressed)
+  {
+    p_button->press_ticks = edge_ticks;
+    (void)xTimerReset(p_button->long_timer, 0);
+    event_send(index, BUTTON_EVT_PRESS, edge_ticks);
+  }
+  else
+  {
+    (void)xTimerStop(p_button->long_timer, 0);
+    event_send(index, BUTTON_EVT_RELEASE, edge_ticks);
+  }
+}
+
+static void long_timer_callback(TimerHandle_t timer)
+{
+  uint8_t index = (uint8_t)(uintptr_t)pvTimerGetTimerID(timer);
+  button_t* p_button = &m_buttons[index];
+
+  if(!p_button->pressed) return;
+
+  event_send(index, BUTTON_EVT_LONG_PRESS,
+             p_button->press_ticks + mono_time_us_to_ticks(BUTTON_INPUT_LONG_PRESS_MS * 1000ULL));
+}
+
+// GPIOTE interrupt, once per edge the PORT event caught
+static void gpiote_handler(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t action)
+{
+  BaseType_t higher_prio_woken = pdFALSE;
+
+  for(uint8_t i = 0; i < m_count; i++)
+  {
+    button_t* p_button = &m_buttons[i];
+
+    if(p_button->pin != pin) continue;
+
+    m_edges++;
+    if(!p_button->edge_pending)
+    {
+      p_button->edge_pending = true;
+      // GPIOTE runs at the priority of the mono_time RTC interrupt, which
+      // cannot preempt it here. The read counts a pending overflow itself
+      // and never waits for that interrupt
+      p_button->edge_ticks = mono_time_ticks_get();
+    }
+    if(xTimerResetFromISR(p_button->debounce_timer, &higher_prio_woken) != pdPASS) m_timer_fails++;
+    break;
+  }
+
+  portYIELD_FROM_ISR(higher_prio_woken);
+}
+
+ret_code_t button_input_init(const uint32_t* p_pins, uint8_t count, QueueHandle_t queue)
+{
+  ret_code_t err_code;
+
+  if(p_pins == NULL || count == 0 || count > BUTTON_INPUT_MAX || queue == NULL)
+  {
+    return NRF_ERROR_INVALID_PARAM;
+  }
+  if(m_queue != NULL) return NRF_ERROR_INVALID_STATE;
+
+  if(!nrf_drv_gpiote_is_init())
+  {
+    err_code = nrf_drv_gpiote_init();
+    if(err_code != NRF_SUCCESS) return err_code;
+  }
+
+  for(uint8_t i = 0; i < count; i++)
+  {
+    button_t* p_button = &m_buttons[i];
+
+    p_button->pin = p_pins[i];
+    p_button->debounce_timer = xTimerCreate("BDB", pdMS_TO_TICKS(BUTTON_INPUT_DEBOUNCE_MS), pdFALSE,
+                                            (void*)(uintptr_t)i, debounce_timer_callback);
+    p_button->long_timer = xTimerCreate("BLP", pdMS_TO_TICKS(BUTTON_INPUT_LONG_PRESS_MS), pdFALSE,
+                                        (void*)(uintptr_t)i, long_timer_callback);
+    if(p_button->debounce_timer == NULL || p_button->long_timer == NULL) return NRF_ERROR_NO_MEM;
+  }
+
+  m_queue = queue;
+  m_count = count;
+
+  for(uint8_t i = 0; i < count; i++)
+  {
+    button_t* p_button = &m_buttons[i];
+    // PORT event, the low accuracy input of GPIOTE
+    nrf_drv_gpiote_in_config_t config = GPIOTE_CONFIG_IN_SENSE_TOGGLE(false);
+
+    config.pull = BUTTON_PULL;
+    err_code = nrf_drv_gpiote_in_init(p_button->pin, &config, gpiote_handler);
+    if(err_code != NRF_SUCCESS) return err_code;
+
+    p_button->pressed = pin_pressed(p_button->pin);
+    p_button->edge_pending = false;
+    nrf_drv_gpiote_in_event_enable(p_button->pin, true);
+  }
+
+  return NRF_SUCCESS;
+}
+
+void button_input_taken(const button_evt_t* p_evt)
+{
+  uint64_t now = mono_time_ticks_get();
+  uint32_t edge_latency = (uint32_t)(now - p_evt->edge_ticks);
+  uint32_t queue_latency = (uint32_t)(now - p_evt->queued_ticks);
+
+  m_taken++;
+  m_edge_latency_sum += edge_latency;
+  if(edge_latency > m_edge_latency_max) m_edge_latency_max = edge_latency;
+  m_queue_latency_sum += queue_latency;
+  if(queue_latency > m_queue_latency_max) m_queue_latency_max = queue_latency;
+}
+
+void button_input_report(void)
+{
+  uint32_t taken = m_taken;
+
+  printf("Buttons: %u edges, %u presses, %u releases, %u long presses\r\n",
+         (unsigned)m_edges, (unsigned)m_events[BUTTON_EVT_PRESS],
+         (unsigned)m_events[BUTTON_EVT_RELEASE], (unsigned)m_events[BUTTON_EVT_LONG_PRESS]);
+  printf("  dropped %u, timer queue full %u\r\n", (unsigned)m_dropped, (unsigned)m_timer_fails);
+  if(taken == 0) return;
+
+  // debounce time included, a long press counts from when it became one
+  printf("  edge to task  avg %u us max %u us\r\n",
+         (unsigned)mono_time_ticks_to_us(m_edge_latency_sum / taken),
+         (unsigned)mono_time_ticks_to_us(m_edge_latency_max));
+  printf("  queue to task avg %u us max %u us\r\n",
+         (unsigned)mono_time_ticks_to_us(m_queue_latency_sum / taken),
+         (unsigned)mono_time_ticks_to_us(m_queue_latency_max));
+}
+
+const char* button_input_type_name(button_evt_type_t type)
+{
+  return (type <= BUTTON_EVT_LONG_PRESS) ? k_type_names[type] : "?";
+}
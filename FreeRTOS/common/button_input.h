@@ -0,0 +1,96 @@
+/*
+  Interrupt driven button input into a queue
+
+  Buttons are GPIOTE PORT event inputs, the low power SENSE mechanism that
+  needs no HFCLK and no GPIOTE channel, so the CPU sleeps in tickless idle
+  until a button moves. Nothing polls:
+
+  - every edge restarts the debounce timer of its button, a FreeRTOS
+    software timer started from the GPIOTE interrupt
+  - BUTTON_INPUT_DEBOUNCE_MS after the last edge the timer callback reads
+    the pin once, a level that differs from the last stable one is a press
+    or a release
+  - a press starts the long press timer, still pressed when it expires is a
+    long press, a release stops it
+
+  Events go into the queue given to button_input_init() from the timer
+  daemon task without blocking, a full queue drops them and counts them.
+
+  Each event carries the mono_time of the first edge, for a long press the
+  time it became one, and the time it was queued. The consumer hands every
+  event it takes to button_input_taken(), button_input_report() prints the
+  edge to task latency, which holds the debounce time, and the queue to
+  task latency.
+
+  Needs mono_time_init() and the timer daemon, GPIOTE_ENABLED in
+  sdk_config.h and GPIOTE_CONFIG_NUM_OF_LOW_POWER_EVENTS of at least the
+  number of buttons.
+*/
+
+#ifndef BUTTON_INPUT_H
+#define BUTTON_INPUT_H
+
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "sdk_errors.h"
+#include <stdint.h>
+
+// buttons of one button_input_init()
+#ifndef BUTTON_INPUT_MAX
+#define BUTTON_INPUT_MAX          4
+#endif
+
+// quiet time after the last edge before the level counts
+#ifndef BUTTON_INPUT_DEBOUNCE_MS
+#define BUTTON_INPUT_DEBOUNCE_MS  20
+#endif
+
+#ifndef BUTTON_INPUT_LONG_PRESS_MS
+#define BUTTON_INPUT_LONG_PRESS_MS 1000
+#endif
+
+typedef enum
+{
+  BUTTON_EVT_PRESS,
+  BUTTON_EVT_RELEASE,
+  BUTTON_EVT_LONG_PRESS
+}button_evt_type_t;
+
+typedef struct
+{
+  uint64_t edge_ticks;      // mono_time of the first edge
+  uint64_t queued_ticks;    // mono_time when queued
+  uint8_t button;           // index in the pins of button_input_init()
+  uint8_t type;             // button_evt_type_t
+}button_evt_t;
+
+/**
+ * @brief Configure the pins and start watching them, before or after the
+ *        scheduler started
+ *
+ * @param p_pins - button pins, active at BUTTONS_ACTIVE_STATE of boards.h
+ * @param count  - number of pins, up to BUTTON_INPUT_MAX
+ * @param queue  - queue of button_evt_t items the events are sent to
+ *
+ * @return NRF_SUCCESS, NRF_ERROR_INVALID_PARAM on a bad count or no queue,
+ *         NRF_ERROR_INVALID_STATE if already initialised, NRF_ERROR_NO_MEM
+ *         on insufficient heap memory for the timers or a GPIOTE error
+ */
+ret_code_t button_input_init(const uint32_t* p_pins, uint8_t count, QueueHandle_t queue);
+
+/**
+ * @brief Record the latency of an event taken from the queue
+ */
+void button_input_taken(const button_evt_t* p_evt);
+
+/**
+ * @brief Print the event counts and the latencies, from a task
+ */
+void button_input_report(void);
+
+/**
+ * @brief Name of an event type, for printing
+ */
+const char* button_input_type_name(button_evt_type_t type);
+
+#endif /* BUTTON_INPUT_H */
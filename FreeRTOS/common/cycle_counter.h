@@ -0,0 +1,27 @@
+/*
+  Cortex-M4 DWT cycle counter helpers
+
+  CYCCNT counts CPU clock cycles (64 MHz on nRF52840) and wraps every ~67 s,
+  differences of two reads are correct across one wrap. The counter stops
+  while the CPU sleeps, so use it for code paths and not for wall time.
+*/
+
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include "nrf.h"
+#include <stdint.h>
+
+static inline void cycle_counter_init(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static inline uint32_t cycle_counter_get(void)
+{
+  return DWT->CYCCNT;
+}
+
+#endif /* CYCLE_COUNTER_H */
@@ -0,0 +1,542 @@
+/*
+  TLSF heap for FreeRTOS, see heap_tlsf.h
+*/
+
+#include "heap_tlsf.h"
+#include "task.h"
+#include "nrf.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ALIGN_LOG2        3
+#define ALIGN_SIZE        (1UL << ALIGN_LOG2)
+
+// 16 lists per power of 2
+#define SL_LOG2           4
+#define SL_COUNT          (1UL << SL_LOG2)
+
+// blocks below SMALL_BLOCK_SIZE share first level 0, in steps of ALIGN_SIZE
+#define FL_SHIFT          (SL_LOG2 + ALIGN_LOG2)
+#define SMALL_BLOCK_SIZE  (1UL << FL_SHIFT)
+
+// largest block is below 2^(FL_MAX + 1)
+#define FL_MAX            18
+#define FL_COUNT          (FL_MAX - FL_SHIFT + 2)
+
+#define BLOCK_FREE        1UL
+#define SIZE_MASK         (~(ALIGN_SIZE - 1))
+
+typedef struct block_s
+{
+  struct block_s* prev_phys;  // physical neighbour below, NULL for the first
+  size_t size;                // payload bytes, BLOCK_FREE in bit 0
+  // the free list links use the payload of free blocks
+  struct block_s* next_free;
+  struct block_s* prev_free;
+}block_t;
+
+#define BLOCK_OVERHEAD    (offsetof(block_t, next_free))
+#define BLOCK_MIN_SIZE    (sizeof(block_t) - BLOCK_OVERHEAD)
+#define BLOCK_MAX_SIZE    ((1UL << (FL_MAX + 1)) - ALIGN_SIZE)
+
+#if HEAP_TLSF_LINKER_REGIONS
+// flash_placement.xml
+extern uint8_t __ram_free_start[];
+extern uint8_t __StackLimit[];
+extern uint8_t __StackTop[];
+#if HEAP_TLSF_MALLOC
+extern uint8_t __libc_heap_start[];
+extern uint8_t __libc_heap_end[];
+#endif
+#elif configAPPLICATION_ALLOCATED_HEAP == 1
+extern uint8_t ucHeap[configTOTAL_HEAP_SIZE];
+#else
+static uint8_t ucHeap[configTOTAL_HEAP_SIZE] __attribute__((aligned(ALIGN_SIZE)));
+#endif
+
+typedef struct
+{
+  uint8_t* start;
+  size_t size;
+}region_t;
+
+static region_t m_regions[HEAP_TLSF_MAX_REGIONS];
+static uint32_t m_region_count = 0;
+
+static uint32_t m_fl_bitmap;
+static uint32_t m_sl_bitmap[FL_COUNT];
+static block_t* m_free_lists[FL_COUNT][SL_COUNT];
+
+static bool m_initialised = false;
+static size_t m_total = 0;
+static size_t m_free = 0;
+static size_t m_min_ever_free = 0;
+static uint32_t m_allocs = 0;
+static uint32_t m_frees = 0;
+static uint32_t m_failures = 0;
+static uintptr_t m_high_water = 0;
+
+static inline uint32_t bit_fls(size_t x)
+{
+  return 31 - (uint32_t)__builtin_clz(x);
+}
+
+static inline uint32_t bit_ffs(uint32_t x)
+{
+  return (uint32_t)__builtin_ctz(x);
+}
+
+static inline size_t block_size(const block_t* p_block)
+{
+  return p_block->size & SIZE_MASK;
+}
+
+static inline bool block_is_free(const block_t* p_block)
+{
+  return (p_block->size & BLOCK_FREE) != 0;
+}
+
+static inline void* block_to_ptr(block_t* p_block)
+{
+  return (uint8_t*)p_block + BLOCK_OVERHEAD;
+}
+
+static inline block_t* ptr_to_block(void* ptr)
+{
+  return (block_t*)((uint8_t*)ptr - BLOCK_OVERHEAD);
+}
+
+static inline block_t* block_next(block_t* p_block)
+{
+  return (block_t*)((uint8_t*)block_to_ptr(p_block) + block_size(p_block));
+}
+
+// list of the blocks of this size
+static void mapping_insert(size_t size, uint32_t* p_fl, uint32_t* p_sl)
+{
+  if(size < SMALL_BLOCK_SIZE)
+  {
+    *p_fl = 0;
+    *p_sl = size / (SMALL_BLOCK_SIZE / SL_COUNT);
+  }
+  else
+  {
+    uint32_t f = bit_fls(size);
+    *p_sl = (size >> (f - SL_LOG2)) ^ SL_COUNT;
+    *p_fl = f - (FL_SHIFT - 1);
+  }
+}
+
+// first list whose blocks are all big enough for this size
+static void mapping_search(size_t size, uint32_t* p_fl, uint32_t* p_sl)
+{
+  if(size >= SMALL_BLOCK_SIZE)
+  {
+    size += (1UL << (bit_fls(size) - SL_LOG2)) - 1;
+  }
+  mapping_insert(size, p_fl, p_sl);
+}
+
+static void free_list_remove(block_t* p_block)
+{
+  uint32_t fl, sl;
+  mapping_insert(block_size(p_block), &fl, &sl);
+
+  if(p_block->prev_free != NULL) p_block->prev_free->next_free = p_block->next_free;
+  else                           m_free_lists[fl][sl] = p_block->next_free;
+  if(p_block->next_free != NULL) p_block->next_free->prev_free = p_block->prev_free;
+
+  if(m_free_lists[fl][sl] == NULL)
+  {
+    m_sl_bitmap[fl] &= ~(1UL << sl);
+    if(m_sl_bitmap[fl] == 0) m_fl_bitmap &= ~(1UL << fl);
+  }
+}
+
+static void free_list_insert(block_t* p_block)
+{
+  uint32_t fl, sl;
+  mapping_insert(block_size(p_block), &fl, &sl);
+
+  p_block->prev_free = NULL;
+  p_block->next_free = m_free_lists[fl][sl];
+  if(p_block->next_free != NULL) p_block->next_free->prev_free = p_block;
+  m_free_lists[fl][sl] = p_block;
+
+  m_sl_bitmap[fl] |= 1UL << sl;
+  m_fl_bitmap |= 1UL << fl;
+}
+
+static block_t* free_list_find(uint32_t fl, uint32_t sl)
+{
+  uint32_t sl_map = m_sl_bitmap[fl] & (~0UL << sl);
+
+  if(sl_map == 0)
+  {
+    // nothing left in this power of 2, take the next one that has a block
+    uint32_t fl_map = m_fl_bitmap & (~0UL << (fl + 1));
+    if(fl_map == 0) return NULL;
+
+    fl = bit_ffs(fl_map);
+    sl_map = m_sl_bitmap[fl];
+  }
+
+  return m_free_lists[fl][bit_ffs(sl_map)];
+}
+
+// hand the tail of a block above size back to the free lists
+static void block_trim(block_t* p_block, size_t size)
+{
+  size_t total = block_size(p_block);
+  if(total < size + sizeof(block_t)) return;
+
+  block_t* p_rest = (block_t*)((uint8_t*)block_to_ptr(p_block) + size);
+  p_rest->prev_phys = p_block;
+  p_rest->size = (total - size - BLOCK_OVERHEAD) | BLOCK_FREE;
+  block_next(p_rest)->prev_phys = p_rest;
+
+  p_block->size = size | (p_block->size & BLOCK_FREE);
+  free_list_insert(p_rest);
+  m_free -= BLOCK_OVERHEAD;
+}
+
+static block_t* block_merge(block_t* p_low, block_t* p_high)
+{
+  p_low->size += block_size(p_high) + BLOCK_OVERHEAD;
+  block_next(p_low)->prev_phys = p_low;
+  m_free += BLOCK_OVERHEAD;
+  return p_low;
+}
+
+// one free block over the region, closed by an empty used block. Blocks
+// never merge across regions, even adjacent ones
+static bool region_add(void* start, size_t size)
+{
+  uintptr_t first = ((uintptr_t)start + ALIGN_SIZE - 1) & SIZE_MASK;
+  uintptr_t last = ((uintptr_t)start + size) & SIZE_MASK;
+
+  if(m_region_count == HEAP_TLSF_MAX_REGIONS) return false;
+  if(last < first + sizeof(block_t) + BLOCK_OVERHEAD) return false;
+
+  size_t usable = last - first - 2 * BLOCK_OVERHEAD;
+  if(usable > BLOCK_MAX_SIZE) usable = BLOCK_MAX_SIZE;
+
+  block_t* p_block = (block_t*)first;
+  p_block->prev_phys = NULL;
+  p_block->size = usable | BLOCK_FREE;
+
+  block_t* p_end = block_next(p_block);
+  p_end->prev_phys = p_block;
+  p_end->size = 0;
+
+  free_list_insert(p_block);
+
+  m_regions[m_region_count].start = (uint8_t*)first;
+  m_regions[m_region_count].size = usable + 2 * BLOCK_OVERHEAD;
+  m_region_count++;
+
+  m_total += usable + 2 * BLOCK_OVERHEAD;
+  m_free += usable;
+  m_min_ever_free += usable;
+  return true;
+}
+
+static void heap_init(void)
+{
+  m_initialised = true;
+
+#if HEAP_TLSF_LINKER_REGIONS
+  // all RAM between the static data and the main stack
+  (void)region_add(__ram_free_start, (size_t)(__StackLimit - __ram_free_start));
+#if HEAP_TLSF_MALLOC
+  // the C library heap, malloc() below replaces its allocator
+  (void)region_add(__libc_heap_start, (size_t)(__libc_heap_end - __libc_heap_start));
+#endif
+#else
+  (void)region_add(ucHeap, configTOTAL_HEAP_SIZE);
+#endif
+}
+
+void* pvPortMalloc(size_t xWantedSize)
+{
+  void* ptr = NULL;
+
+  if(xWantedSize > 0 && xWantedSize <= BLOCK_MAX_SIZE)
+  {
+    size_t size = (xWantedSize + ALIGN_SIZE - 1) & SIZE_MASK;
+    if(size < BLOCK_MIN_SIZE) size = BLOCK_MIN_SIZE;
+
+    vTaskSuspendAll();
+
+    if(!m_initialised) heap_init();
+
+    uint32_t fl, sl;
+    mapping_search(size, &fl, &sl);
+
+    block_t* p_block = (fl < FL_COUNT) ? free_list_find(fl, sl) : NULL;
+    if(p_block != NULL)
+    {
+      free_list_remove(p_block);
+      block_trim(p_block, size);
+      p_block->size &= ~BLOCK_FREE;
+
+      m_free -= block_size(p_block);
+      if(m_free < m_min_ever_free) m_min_ever_free = m_free;
+      m_allocs++;
+      if((uintptr_t)block_next(p_block) > m_high_water) m_high_water = (uintptr_t)block_next(p_block);
+      ptr = block_to_ptr(p_block);
+    }
+
+    (void)xTaskResumeAll();
+  }
+
+  traceMALLOC(ptr, xWantedSize);
+
+  if(ptr == NULL)
+  {
+    m_failures++;
+#if configUSE_MALLOC_FAILED_HOOK == 1
+    extern void vApplicationMallocFailedHook(void);
+    vApplicationMallocFailedHook();
+#endif
+  }
+
+  return ptr;
+}
+
+void vPortFree(void* pv)
+{
+  if(pv == NULL) return;
+
+  block_t* p_block = ptr_to_block(pv);
+  configASSERT(!block_is_free(p_block));
+
+  vTaskSuspendAll();
+
+  traceFREE(pv, block_size(p_block));
+
+  m_free += block_size(p_block);
+  m_frees++;
+
+  block_t* p_next = block_next(p_block);
+  if(block_is_free(p_next))
+  {
+    free_list_remove(p_next);
+    p_block = block_merge(p_block, p_next);
+  }
+
+  block_t* p_prev = p_block->prev_phys;
+  if(p_prev != NULL && block_is_free(p_prev))
+  {
+    free_list_remove(p_prev);
+    p_block = block_merge(p_prev, p_block);
+  }
+
+  p_block->size |= BLOCK_FREE;
+  free_list_insert(p_block);
+
+  (void)xTaskResumeAll();
+}
+
+size_t xPortGetFreeHeapSize(void)
+{
+  vTaskSuspendAll();
+  if(!m_initialised) heap_init();
+  (void)xTaskResumeAll();
+
+  return m_free;
+}
+
+size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+  vTaskSuspendAll();
+  if(!m_initialised) heap_init();
+  (void)xTaskResumeAll();
+
+  return m_min_ever_free;
+}
+
+bool heap_tlsf_region_add(void* start, size_t size)
+{
+  vTaskSuspendAll();
+  if(!m_initialised) heap_init();
+  bool added = region_add(start, size);
+  (void)xTaskResumeAll();
+
+  return added;
+}
+
+void* heap_tlsf_high_water(void)
+{
+  return (void*)m_high_water;
+}
+
+size_t heap_tlsf_cap(void* limit)
+{
+  uintptr_t end = (uintptr_t)limit & SIZE_MASK;
+  size_t removed = 0;
+
+  vTaskSuspendAll();
+
+  if(!m_initialised) heap_init();
+
+  for(uint32_t i = 0; i < m_region_count; i++)
+  {
+    region_t* p_region = &m_regions[i];
+    uintptr_t region_end = (uintptr_t)p_region->start + p_region->size;
+    if(end <= (uintptr_t)p_region->start || end >= region_end) continue;
+
+    // only the free block in front of the closing block can give memory
+    // back, and it must keep at least its minimum size
+    block_t* p_last = ((block_t*)(region_end - BLOCK_OVERHEAD))->prev_phys;
+    uintptr_t new_close = end - BLOCK_OVERHEAD;
+    if(!block_is_free(p_last) || new_close < (uintptr_t)block_to_ptr(p_last) + BLOCK_MIN_SIZE) break;
+
+    free_list_remove(p_last);
+    p_last->size = (new_close - (uintptr_t)block_to_ptr(p_last)) | BLOCK_FREE;
+
+    block_t* p_close = (block_t*)new_close;
+    p_close->prev_phys = p_last;
+    p_close->size = 0;
+    free_list_insert(p_last);
+
+    removed = region_end - end;
+    p_region->size -= removed;
+    m_total -= removed;
+    m_free -= removed;
+    m_min_ever_free = (m_min_ever_free > removed) ? m_min_ever_free - removed : 0;
+    break;
+  }
+
+  (void)xTaskResumeAll();
+
+  return removed;
+}
+
+void vPortInitialiseBlocks(void)
+{
+  // only for heap_1/heap_2 compatibility, the heap sets itself up on the
+  // first allocation
+}
+
+void heap_tlsf_stats_get(heap_tlsf_stats_t* p_stats)
+{
+  size_t largest = 0;
+  uint32_t blocks = 0;
+
+  vTaskSuspendAll();
+
+  if(!m_initialised) heap_init();
+
+  for(uint32_t fl = 0; fl < FL_COUNT; fl++)
+  {
+    for(uint32_t sl = 0; sl < SL_COUNT; sl++)
+    {
+      for(block_t* p_block = m_free_lists[fl][sl]; p_block != NULL; p_block = p_block->next_free)
+      {
+        if(block_size(p_block) > largest) largest = block_size(p_block);
+        blocks++;
+      }
+    }
+  }
+
+  p_stats->total = m_total;
+  p_stats->free = m_free;
+  p_stats->min_ever_free = m_min_ever_free;
+  p_stats->allocs = m_allocs;
+  p_stats->frees = m_frees;
+  p_stats->failures = m_failures;
+
+  (void)xTaskResumeAll();
+
+  p_stats->free_blocks = blocks;
+  p_stats->fragmentation = (p_stats->free > 0) ? (uint32_t)(100 - (uint64_t)largest * 100 / p_stats->free) : 0;
+
+  // a request is rounded up to its size class before the search, the
+  // biggest one served for sure is the class below the largest block
+  if(largest >= SMALL_BLOCK_SIZE)
+  {
+    size_t step = 1UL << (bit_fls(largest) - SL_LOG2);
+    largest &= ~(step - 1);
+  }
+
+  p_stats->largest_free = largest;
+}
+
+void heap_tlsf_stats_print(void)
+{
+  heap_tlsf_stats_t stats;
+  heap_tlsf_stats_get(&stats);
+
+  printf("heap %u B, free %u B, min free %u B, largest %u B, %u free blocks, frag %u%%\r\n",
+         (unsigned)stats.total, (unsigned)stats.free, (unsigned)stats.min_ever_free,
+         (unsigned)stats.largest_free, (unsigned)stats.free_blocks, (unsigned)stats.fragmentation);
+  printf("heap %u allocs, %u frees, %u failed\r\n",
+         (unsigned)stats.allocs, (unsigned)stats.frees, (unsigned)stats.failures);
+}
+
+void heap_tlsf_ram_report(void)
+{
+  heap_tlsf_stats_t stats;
+  heap_tlsf_stats_get(&stats);
+
+  size_t ram = NRF_FICR->INFO.RAM * 1024UL;
+
+  printf("RAM %u B\r\n", (unsigned)ram);
+  for(uint32_t i = 0; i < m_region_count; i++)
+  {
+    printf("  heap region %u: 0x%08x, %u B\r\n", (unsigned)i,
+           (unsigned)(uintptr_t)m_regions[i].start, (unsigned)m_regions[i].size);
+  }
+#if HEAP_TLSF_LINKER_REGIONS
+  size_t stack = (size_t)(__StackTop - __StackLimit);
+  printf("  main stack %u B, static data %u B\r\n",
+         (unsigned)stack, (unsigned)(ram - stack - stats.total));
+#endif
+  printf("  usable heap %u B, %u%% of RAM\r\n",
+         (unsigned)stats.free, (unsigned)((uint64_t)stats.free * 100 / ram));
+}
+
+#if HEAP_TLSF_MALLOC
+// the C library allocator on the same pool, so both share all free RAM
+void* malloc(size_t size)
+{
+  return pvPortMalloc(size);
+}
+
+void free(void* ptr)
+{
+  vPortFree(ptr);
+}
+
+void* calloc(size_t count, size_t size)
+{
+  if(size != 0 && count > SIZE_MAX / size) return NULL;
+
+  void* ptr = pvPortMalloc(count * size);
+  if(ptr != NULL) memset(ptr, 0, count * size);
+  return ptr;
+}
+
+void* realloc(void* ptr, size_t size)
+{
+  if(ptr == NULL) return pvPortMalloc(size);
+  if(size == 0)
+  {
+    vPortFree(ptr);
+    return NULL;
+  }
+
+  size_t old_size = block_size(ptr_to_block(ptr));
+  if(size <= old_size) return ptr;
+
+  void* new_ptr = pvPortMalloc(size);
+  if(new_ptr != NULL)
+  {
+    memcpy(new_ptr, ptr, old_size);
+    vPortFree(ptr);
+  }
+  return new_ptr;
+}
+#endif
@@ -0,0 +1,111 @@
+/*
+  TLSF heap for FreeRTOS
+
+  Drop-in replacement of MemMang/heap_1.c to heap_5.c: pvPortMalloc(),
+  vPortFree(), xPortGetFreeHeapSize() and xPortGetMinimumEverFreeHeapSize().
+  Unlike heap_1 memory can be freed, so a deleted task gives back its TCB
+  and stack.
+
+  Two-level segregated fit (Masmano et al., ECRTS 2004): free blocks are
+  kept in 16 lists per power of 2 of their size, two bitmaps tell which lists
+  are not empty. A malloc finds a list with two count-leading-zeros and takes
+  its first block, a free merges with both physical neighbours. Both are
+  O(1), no list walks, the scheduler is suspended for the same short time
+  whatever the heap state.
+
+  - 8 byte alignment, 8 bytes of header per allocation, 8 bytes minimum
+  - a request is rounded up to its size class (at most 1/16 more) so the
+    first block of the list found is always big enough
+  - blocks up to 512 KB
+
+  Memory comes from one or more regions, free blocks of all regions share
+  the same lists:
+
+  - HEAP_TLSF_LINKER_REGIONS 0: the configTOTAL_HEAP_SIZE array ucHeap
+  - HEAP_TLSF_LINKER_REGIONS 1: all RAM between the end of the static data
+    (__ram_free_start) and the main stack (__StackLimit), symbols from
+    flash_placement.xml. The size follows the static data of the build,
+    configTOTAL_HEAP_SIZE is ignored
+  - HEAP_TLSF_MALLOC 1: malloc(), calloc(), realloc() and free() of the C
+    library allocate from the same lists and, with linker regions, the
+    .heap section (arm_linker_heap_size) becomes one more region. Task
+    context only, like pvPortMalloc()
+  - heap_tlsf_region_add() for any other block of memory
+*/
+
+#ifndef HEAP_TLSF_H
+#define HEAP_TLSF_H
+
+#include "FreeRTOS.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 1 = heap regions from the flash_placement.xml symbols, 0 = ucHeap array
+#ifndef HEAP_TLSF_LINKER_REGIONS
+#define HEAP_TLSF_LINKER_REGIONS  0
+#endif
+
+// 1 = malloc() family on the same heap
+#ifndef HEAP_TLSF_MALLOC
+#define HEAP_TLSF_MALLOC          0
+#endif
+
+#ifndef HEAP_TLSF_MAX_REGIONS
+#define HEAP_TLSF_MAX_REGIONS     4
+#endif
+
+typedef struct
+{
+  size_t total;             // bytes managed, headers included
+  size_t free;              // free bytes in all free blocks
+  size_t largest_free;      // biggest request that can succeed now
+  size_t min_ever_free;     // low water mark of free
+  uint32_t free_blocks;     // number of free blocks
+  uint32_t fragmentation;   // 0 to 100 %, share of free bytes outside the largest block
+  uint32_t allocs;          // successful pvPortMalloc() calls
+  uint32_t frees;           // vPortFree() calls
+  uint32_t failures;        // pvPortMalloc() calls that returned NULL
+}heap_tlsf_stats_t;
+
+/**
+ * @brief Add a block of memory to the heap, at any time
+ *
+ * @return false if HEAP_TLSF_MAX_REGIONS are in use or the block is too small
+ */
+bool heap_tlsf_region_add(void* start, size_t size);
+
+/**
+ * @brief End of the highest block ever allocated
+ */
+void* heap_tlsf_high_water(void);
+
+/**
+ * @brief Shrink the region holding limit so that the heap never uses
+ *        memory from limit up to the end of that region
+ *
+ * Only works if the last block of the region is free and starts below
+ * limit, which is the case above heap_tlsf_high_water().
+ *
+ * @return bytes taken out of the heap, 0 if it was not possible
+ */
+size_t heap_tlsf_cap(void* limit);
+
+/**
+ * @brief Snapshot of the heap state, walks the free lists so avoid it in
+ *        time critical code
+ */
+void heap_tlsf_stats_get(heap_tlsf_stats_t* p_stats);
+
+/**
+ * @brief Print the heap state with printf()
+ */
+void heap_tlsf_stats_print(void);
+
+/**
+ * @brief Print how the RAM of the chip is split between static data, main
+ *        stack and heap regions, call from main() before creating tasks
+ */
+void heap_tlsf_ram_report(void);
+
+#endif /* HEAP_TLSF_H */
@@ -0,0 +1,130 @@
+/*
+  Heap call-site trace, see heap_trace.h
+*/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "heap_trace.h"
+#include <stdio.h>
+
+#if HEAP_TRACE_ENABLED
+
+#if (HEAP_TRACE_RING_SIZE & (HEAP_TRACE_RING_SIZE - 1)) != 0
+#error "HEAP_TRACE_RING_SIZE must be a power of 2"
+#endif
+
+#define RING_MASK         (HEAP_TRACE_RING_SIZE - 1)
+#define SIZE_FREE_FLAG    0x80000000UL
+
+// records copied out of the ring in one critical section by the dump
+#define DUMP_CHUNK        8
+
+typedef struct
+{
+  uint32_t tick;
+  uint32_t caller;
+  uint32_t ptr;
+  uint32_t size;    // SIZE_FREE_FLAG set for a free
+}record_t;
+
+static record_t m_ring[HEAP_TRACE_RING_SIZE];
+static uint32_t m_written = 0;    // records ever written, wraps
+static uint32_t m_dumped = 0;     // records ever dumped or lost
+static bool m_header_sent = false;
+
+static void record(void* ptr, uint32_t size, void* caller)
+{
+  taskENTER_CRITICAL();
+  // read with the record taken, so ring order is tick order. Valid with the
+  // scheduler suspended and before it starts, where it reads 0
+  record_t* p_record = &m_ring[m_written & RING_MASK];
+  p_record->tick = xTaskGetTickCount();
+  p_record->caller = (uint32_t)(uintptr_t)caller;
+  p_record->ptr = (uint32_t)(uintptr_t)ptr;
+  p_record->size = size;
+  m_written++;
+  taskEXIT_CRITICAL();
+}
+
+void heap_trace_malloc(void* ptr, size_t size, void* caller)
+{
+  record(ptr, (uint32_t)size & ~SIZE_FREE_FLAG, caller);
+}
+
+void heap_trace_free(void* ptr, size_t size, void* caller)
+{
+  record(ptr, (uint32_t)size | SIZE_FREE_FLAG, caller);
+}
+
+void heap_trace_dump(void)
+{
+  record_t chunk[DUMP_CHUNK];
+  uint32_t lost = 0;
+  uint32_t count;
+
+  if(!m_header_sent)
+  {
+    printf("HT S %u %u\r\n", (unsigned)HEAP_TRACE_RING_SIZE, (unsigned)configTICK_RATE_HZ);
+    m_header_sent = true;
+  }
+
+  do
+  {
+    // copy a few records at a time, printing is far too slow to keep the
+    // writers out for the whole dump
+    taskENTER_CRITICAL();
+    if(m_written - m_dumped > HEAP_TRACE_RING_SIZE)
+    {
+      lost += m_written - m_dumped - HEAP_TRACE_RING_SIZE;
+      m_dumped = m_written - HEAP_TRACE_RING_SIZE;
+    }
+    count = m_written - m_dumped;
+    if(count > DUMP_CHUNK) count = DUMP_CHUNK;
+    for(uint32_t i = 0; i < count; i++) chunk[i] = m_ring[(m_dumped + i) & RING_MASK];
+    m_dumped += count;
+    taskEXIT_CRITICAL();
+
+    if(lost != 0)
+    {
+      printf("HT L %u\r\n", (unsigned)lost);
+      lost = 0;
+    }
+
+    for(uint32_t i = 0; i < count; i++)
+    {
+      printf("HT %c %08x %08x %08x %u\r\n",
+             (chunk[i].size & SIZE_FREE_FLAG) ? 'F' : 'A',
+             (unsigned)chunk[i].tick,
+             (unsigned)chunk[i].caller,
+             (unsigned)chunk[i].ptr,
+             (unsigned)(chunk[i].size & ~SIZE_FREE_FLAG));
+    }
+  } while(count == DUMP_CHUNK);
+}
+
+static void dump_task(void* pvParameters)
+{
+  TickType_t last_wake = xTaskGetTickCount();
+
+  while(true)
+  {
+    vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(HEAP_TRACE_DUMP_MS));
+    heap_trace_dump();
+  }
+}
+
+bool heap_trace_start(void)
+{
+  BaseType_t task_err = xTaskCreate(
+                                     dump_task,                      // pointer to the task function
+                                     "HTR",                          // task name mainly for debugging
+                                     configMINIMAL_STACK_SIZE + 100, // task stack depth in words
+                                     NULL,                           // task arguments
+                                     1,                              // lowest above idle
+                                     NULL
+                                   );
+
+  return task_err == pdPASS;
+}
+
+#endif /* HEAP_TRACE_ENABLED */
@@ -0,0 +1,91 @@
+/*
+  Heap call-site trace
+
+  With HEAP_TRACE_ENABLED set to 1 in FreeRTOSConfig.h the traceMALLOC() and
+  traceFREE() hooks of the kernel record every pvPortMalloc() and
+  vPortFree() into a ring: tick count, caller address, block address and
+  size. A failed pvPortMalloc() is recorded too, with its caller and the
+  size that could not be found, so an xTaskCreate() returning pdFAIL can be
+  traced back to what was holding the heap.
+
+  A low priority task prints the new records every HEAP_TRACE_DUMP_MS as
+  text lines, tools/heap_trace.py rebuilds peak usage, the live blocks at
+  the peak, leaks and failures from the captured console output:
+
+    HT S <ring size> <tick rate>          once, at the first dump
+    HT A <tick> <caller> <ptr> <size>     allocation, ptr 0 = failed
+    HT F <tick> <caller> <ptr> <size>     free, size of the whole block
+    HT L <count>                          records overwritten before dumped
+
+  tick, caller and ptr are hex, size and count decimal. The caller is the
+  return address of pvPortMalloc() / vPortFree(), for kernel objects that
+  is the create function (xTaskCreate(), xQueueGenericCreate(), ...).
+
+  Cost per call is one short critical section and four stores, the ring is
+  HEAP_TRACE_RING_SIZE * 16 bytes of RAM. At 115200 baud the dump keeps up
+  with about 250 heap calls per second, above that records are lost and
+  reported with an L line.
+
+  With HEAP_TRACE_ENABLED 0 nothing is recorded and heap_trace_start() does
+  nothing. This header is included by FreeRTOSConfig.h, it must not include
+  kernel headers.
+*/
+
+#ifndef HEAP_TRACE_H
+#define HEAP_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef HEAP_TRACE_ENABLED
+#define HEAP_TRACE_ENABLED        0
+#endif
+
+// records kept between two dumps, must be a power of 2
+#ifndef HEAP_TRACE_RING_SIZE
+#define HEAP_TRACE_RING_SIZE      256
+#endif
+
+#ifndef HEAP_TRACE_DUMP_MS
+#define HEAP_TRACE_DUMP_MS        1000
+#endif
+
+#if HEAP_TRACE_ENABLED
+
+// kernel hooks, expanded inside pvPortMalloc() and vPortFree() so the return
+// address is the one of their caller
+#define traceMALLOC(pvAddress, uiSize)  heap_trace_malloc((pvAddress), (uiSize), __builtin_return_address(0))
+#define traceFREE(pvAddress, uiSize)    heap_trace_free((pvAddress), (uiSize), __builtin_return_address(0))
+
+/**
+ * @brief Record an allocation, called by traceMALLOC()
+ */
+void heap_trace_malloc(void* ptr, size_t size, void* caller);
+
+/**
+ * @brief Record a free, called by traceFREE()
+ */
+void heap_trace_free(void* ptr, size_t size, void* caller);
+
+/**
+ * @brief Create the dump task
+ *
+ * @return false on insufficient heap memory
+ */
+bool heap_trace_start(void);
+
+/**
+ * @brief Print the records added since the last dump with printf(), from a
+ *        task. Also called by the dump task
+ */
+void heap_trace_dump(void);
+
+#else
+
+#define heap_trace_start()        true
+#define heap_trace_dump()
+
+#endif /* HEAP_TRACE_ENABLED */
+
+#endif /* HEAP_TRACE_H */
@@ -0,0 +1,222 @@
+/*
+  On-demand HFXO with counted requests, see hfxo.h
+*/
+
+#include "hfxo.h"
+#include "task.h"
+#include "timers.h"
+#include "mono_time.h"
+#include "app_util_platform.h"
+#include <stdio.h>
+
+static hfxo_holder_t* m_p_holders = NULL;
+static uint32_t m_count = 0;            // requests of all holders
+static uint32_t m_starts = 0;
+static uint64_t m_on_ticks = 0;         // mono_time ticks with the crystal requested
+static uint64_t m_on_since;
+static uint64_t m_requested_at;         // mono_time of the last start request
+
+static uint32_t m_latency_min = UINT32_MAX;
+static uint32_t m_latency_max = 0;
+static uint64_t m_latency_sum = 0;      // mono_time ticks
+static uint32_t m_latency_count = 0;
+
+static TickType_t m_lead_ticks = (TickType_t)(HFXO_STARTUP_US * configTICK_RATE_HZ / 1000000UL + 2);
+
+static void hfclk_started(nrf_drv_clock_evt_type_t event);
+
+static nrf_drv_clock_handler_item_t m_started_item = { .event_handler = hfclk_started };
+
+// clock driver callback, from the POWER_CLOCK interrupt or from
+// nrf_drv_clock_hfclk_request() itself
+static void hfclk_started(nrf_drv_clock_evt_type_t event)
+{
+  if(event != NRF_DRV_CLOCK_EVT_HFCLK_STARTED) return;
+
+  uint32_t latency = (uint32_t)(mono_time_ticks_get() - m_requested_at);
+
+  if(latency < m_latency_min) m_latency_min = latency;
+  if(latency > m_latency_max)
+  {
+    m_latency_max = latency;
+
+    // one tick more because the early wake may land anywhere in its tick
+    m_lead_ticks = (TickType_t)((mono_time_ticks_to_us(latency) * configTICK_RATE_HZ + 999999) / 1000000 + 1);
+  }
+  m_latency_sum += latency;
+  m_latency_count++;
+}
+
+// the time is read before the critical region so the interrupts stay masked
+// only for the bookkeeping, an interrupt in between may stamp a later start
+static uint64_t elapsed(uint64_t now, uint64_t since)
+{
+  return (now > since) ? now - since : 0;
+}
+
+void hfxo_request(hfxo_holder_t* p_holder)
+{
+  uint64_t now = mono_time_ticks_get();
+
+  CRITICAL_REGION_ENTER();
+  if(p_holder->requests++ == 0)
+  {
+    p_holder->p_next = m_p_holders;
+    m_p_holders = p_holder;
+  }
+  if(p_holder->count++ == 0) p_holder->held_since = now;
+
+  // the driver counts requests as well, but only this first one needs the
+  // started event
+  if(m_count++ == 0)
+  {
+    m_on_since = now;
+    m_requested_at = now;
+    m_starts++;
+    nrf_drv_clock_hfclk_request(&m_started_item);
+  }
+  CRITICAL_REGION_EXIT();
+}
+
+void hfxo_release(hfxo_holder_t* p_holder)
+{
+  uint64_t now = mono_time_ticks_get();
+
+  CRITICAL_REGION_ENTER();
+  if(p_holder->count != 0)
+  {
+    if(--p_holder->count == 0) p_holder->held_ticks += elapsed(now, p_holder->held_since);
+
+    // back to HFINT while awake, only LFCLK while asleep
+    if(--m_count == 0)
+    {
+      m_on_ticks += elapsed(now, m_on_since);
+      nrf_drv_clock_hfclk_release();
+    }
+  }
+  CRITICAL_REGION_EXIT();
+}
+
+bool hfxo_is_running(void)
+{
+  return nrf_drv_clock_hfclk_is_running();
+}
+
+void hfxo_prestart_check(hfxo_holder_t* p_holder)
+{
+  CRITICAL_REGION_ENTER();
+  if(nrf_drv_clock_hfclk_is_running()) p_holder->prestart_ready++;
+  else p_holder->prestart_late++;
+  CRITICAL_REGION_EXIT();
+}
+
+void hfxo_delay_until(hfxo_holder_t* p_holder, TickType_t* p_last_wake, TickType_t period)
+{
+  TickType_t lead = m_lead_ticks;
+
+  if(period > lead)
+  {
+    TickType_t early_wake = *p_last_wake;
+    vTaskDelayUntil(&early_wake, period - lead);
+  }
+
+  hfxo_request(p_holder);
+  vTaskDelayUntil(p_last_wake, period);
+  hfxo_prestart_check(p_holder);
+
+  // late, the lead grew from this start on
+  while(!nrf_drv_clock_hfclk_is_running()) vTaskDelay(1);
+}
+
+static void prestart_callback(TimerHandle_t timer)
+{
+  hfxo_request((hfxo_holder_t*)pvTimerGetTimerID(timer));
+}
+
+BaseType_t hfxo_prestart_at(hfxo_holder_t* p_holder, TickType_t tick)
+{
+  TickType_t lead = m_lead_ticks;
+  TickType_t wait = tick - xTaskGetTickCount();
+
+  // too close or already passed
+  if((int32_t)wait <= (int32_t)lead)
+  {
+    hfxo_request(p_holder);
+    return pdPASS;
+  }
+
+  if(p_holder->prestart_timer == NULL)
+  {
+    p_holder->prestart_timer = xTimerCreate(
+                                             p_holder->name,     // name for the timer, used for debugging only
+                                             wait - lead,        // period in ticks
+                                             pdFALSE,            // one shot
+                                             p_holder,           // timer ID, the holder
+                                             prestart_callback
+                                           );
+    if(p_holder->prestart_timer == NULL) return pdFAIL;
+  }
+
+  // also starts the timer, no blocking so it can be called from a timer
+  // callback
+  return xTimerChangePeriod((TimerHandle_t)p_holder->prestart_timer, wait - lead, 0);
+}
+
+TickType_t hfxo_lead_ticks(void)
+{
+  return m_lead_ticks;
+}
+
+// x in 1/10, printed as %u.%u
+#define TENTHS(x)     (unsigned)((x) / 10), (unsigned)((x) % 10)
+
+void hfxo_report(void)
+{
+  uint64_t now;
+  uint64_t on_ticks;
+  uint32_t starts;
+  uint32_t latency_min;
+  uint32_t latency_max;
+  uint32_t latency_avg;
+
+  now = mono_time_ticks_get();
+  CRITICAL_REGION_ENTER();
+  on_ticks = m_on_ticks + ((m_count != 0) ? elapsed(now, m_on_since) : 0);
+  starts = m_starts;
+  latency_min = (m_latency_count == 0) ? 0 : m_latency_min;
+  latency_max = m_latency_max;
+  latency_avg = (m_latency_count == 0) ? 0 : (uint32_t)(m_latency_sum / m_latency_count);
+  CRITICAL_REGION_EXIT();
+
+  if(now == 0) return;
+
+  // share of time in 1/1000, the crystal current in 1/10 uA averaged over
+  // the whole time. HFINT would run instead while the CPU is awake, so the
+  // real cost lies between the HFXO - HFINT difference and the full HFXO
+  // current
+  uint32_t on_permille = (uint32_t)(on_ticks * 1000 / now);
+  uint32_t cost_max = (uint32_t)(on_ticks * HFXO_RUN_UA * 10 / now);
+  uint32_t cost_min = (uint32_t)(on_ticks * (HFXO_RUN_UA - HFINT_RUN_UA) * 10 / now);
+
+  printf("HFXO on %u.%u%% of %u s, %u starts, lead %u ticks\r\n",
+         TENTHS(on_permille), (unsigned)(now / MONO_TIME_TICKS_PER_SEC), (unsigned)starts, (unsigned)m_lead_ticks);
+  printf("  startup min/avg/max %u/%u/%u us\r\n",
+         (unsigned)mono_time_ticks_to_us(latency_min),
+         (unsigned)mono_time_ticks_to_us(latency_avg),
+         (unsigned)mono_time_ticks_to_us(latency_max));
+  printf("  crystal %u.%u to %u.%u uA average\r\n", TENTHS(cost_min), TENTHS(cost_max));
+
+  // counters of a holder may move on while printed, the list only grows at
+  // its head
+  for(hfxo_holder_t* p_holder = m_p_holders; p_holder != NULL; p_holder = p_holder->p_next)
+  {
+    uint64_t held = p_holder->held_ticks;
+
+    printf("  %-16s %6u requests, held %u ms, pre-requests %u ready %u late\r\n",
+           p_holder->name,
+           (unsigned)p_holder->requests,
+           (unsigned)(held * 1000 / MONO_TIME_TICKS_PER_SEC),
+           (unsigned)p_holder->prestart_ready,
+           (unsigned)p_holder->prestart_late);
+  }
+}
@@ -0,0 +1,122 @@
+/*
+  On-demand HFXO with counted requests
+
+  nrf_drv_clock_init() leaves the 64 MHz crystal off, the CPU and the
+  peripherals then run from HFINT, the internal RC oscillator, and the
+  tickless sleep only keeps LFCLK. HFINT is cheap and starts at once but
+  is far less accurate, so the UART baud rate, radio, or timer
+  measurements need HFXO. Here tasks and drivers take and release the
+  crystal through holders:
+
+  - each holder counts its own requests, the crystal runs while any holder
+    has one and stops with the last release, from a task or an ISR
+  - the time from request to HFCLKSTARTED is measured with mono_time, the
+    largest one seen sets the lead time of the pre-requests
+  - hfxo_delay_until() is vTaskDelayUntil() that wakes the lead time
+    early, requests the crystal and sleeps again, the task resumes on time
+    with HFXO running
+  - hfxo_prestart_at() requests the crystal the lead time before a known
+    tick, for software timer callbacks: pass xTimerGetExpiryTime()
+  - hfxo_report() prints the share of time the crystal ran, its startup
+    latency, the estimated current it cost and per holder the requests,
+    time held and how many pre-requests were ready in time
+
+  The early wake of a pre-request costs a wake and the crystal runs for
+  the lead time before it is needed, against a startup latency of up to
+  HFXO_STARTUP_US on every request that was not made ahead.
+
+  Needs mono_time_init() before the first request.
+*/
+
+#ifndef HFXO_H
+#define HFXO_H
+
+#include "FreeRTOS.h"
+#include "nrf_drv_clock.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// startup time assumed until one was measured
+#ifndef HFXO_STARTUP_US
+#define HFXO_STARTUP_US       1000
+#endif
+
+// typical run currents of the nRF52840 Product Specification, for the report
+#ifndef HFXO_RUN_UA
+#define HFXO_RUN_UA           250
+#endif
+
+#ifndef HFINT_RUN_UA
+#define HFINT_RUN_UA          60
+#endif
+
+typedef struct hfxo_holder_s
+{
+  const char* name;
+  struct hfxo_holder_s* p_next; // holders that ever requested, for the report
+  uint32_t count;             // requests held
+  uint32_t requests;
+  uint64_t held_ticks;        // mono_time ticks with count > 0
+  uint64_t held_since;
+  uint32_t prestart_ready;    // pre-requests with the crystal running in time
+  uint32_t prestart_late;
+  void* prestart_timer;       // TimerHandle_t of hfxo_prestart_at()
+}hfxo_holder_t;
+
+#define HFXO_HOLDER_DEF(_name)  static hfxo_holder_t _name = { .name = #_name }
+
+/**
+ * @brief Take a request, starts the crystal if it is the first one
+ */
+void hfxo_request(hfxo_holder_t* p_holder);
+
+/**
+ * @brief Drop a request, stops the crystal if it was the last one
+ */
+void hfxo_release(hfxo_holder_t* p_holder);
+
+/**
+ * @brief Crystal started and stable
+ */
+bool hfxo_is_running(void);
+
+/**
+ * @brief vTaskDelayUntil() returning with a request taken and the crystal
+ *        started, release it when done
+ *
+ * @param p_holder     - holder the request is taken for
+ * @param p_last_wake  - as for vTaskDelayUntil()
+ * @param period       - as for vTaskDelayUntil()
+ */
+void hfxo_delay_until(hfxo_holder_t* p_holder, TickType_t* p_last_wake, TickType_t period);
+
+/**
+ * @brief Take a request the lead time before a tick, from a task or a
+ *        software timer callback. Release it when the work at that tick is
+ *        done
+ *
+ * @param p_holder - holder the request is taken for
+ * @param tick     - when the crystal must be running
+ *
+ * @return pdFAIL on insufficient heap memory for the holder timer or a full
+ *         timer queue
+ */
+BaseType_t hfxo_prestart_at(hfxo_holder_t* p_holder, TickType_t tick);
+
+/**
+ * @brief Check that a pre-requested crystal was ready, call at the tick
+ *        given to hfxo_prestart_at()
+ */
+void hfxo_prestart_check(hfxo_holder_t* p_holder);
+
+/**
+ * @brief Current lead time of the pre-requests
+ */
+TickType_t hfxo_lead_ticks(void);
+
+/**
+ * @brief Print the run time, latency and current trade-offs, from a task
+ */
+void hfxo_report(void);
+
+#endif /* HFXO_H */
@@ -0,0 +1,173 @@
+/*
+  LED blinking in hardware with the PWM peripheral, see hw_blink.h
+*/
+
+#include "hw_blink.h"
+#include "app_util.h"
+#include "boards.h"
+#include "nrf_pwm.h"
+#include <stddef.h>
+#include <stdio.h>
+
+#define BASE_CLOCK_KHZ    125
+#define MAX_STEP_MS       (0x7FFF / BASE_CLOCK_KHZ)
+
+typedef struct
+{
+  uint16_t on_ms;
+  uint16_t off_ms;
+  uint16_t step_ms;
+  uint8_t channels;
+  uint32_t pins[NRF_PWM_CHANNEL_COUNT];
+  nrf_pwm_values_individual_t values[2];    // on and off step, read by EasyDMA
+}group_t;
+
+static NRF_PWM_Type* const k_instances[] = { NRF_PWM0, NRF_PWM1, NRF_PWM2, NRF_PWM3 };
+
+// HW_BLINK_PWM_COUNT can leave instances out, not add any
+STATIC_ASSERT(HW_BLINK_PWM_COUNT <= ARRAY_SIZE(k_instances));
+
+static group_t m_groups[HW_BLINK_PWM_COUNT];
+static uint8_t m_group_count = 0;
+
+static uint16_t step_ms_get(uint16_t on_ms, uint16_t off_ms)
+{
+  uint16_t a = on_ms;
+  uint16_t b = off_ms;
+
+  while(b != 0)
+  {
+    uint16_t r = a % b;
+    a = b;
+    b = r;
+  }
+
+  // largest divisor of both that fits a PWM period
+  for(uint16_t step = (a < MAX_STEP_MS) ? a : MAX_STEP_MS; step > 1; step--)
+  {
+    if(a % step == 0) return step;
+  }
+  return 1;
+}
+
+static void group_start(NRF_PWM_Type* p_pwm, group_t* p_group)
+{
+  uint16_t top = (uint16_t)(p_group->step_ms * BASE_CLOCK_KHZ);
+  // up counting with bit 15 (POLARITY) clear, the first edge of the period
+  // is rising: the output is low while COUNTER < value. 0 keeps the pin high
+  // and COUNTERTOP low for the whole period
+  uint16_t on = (LEDS_ACTIVE_STATE != 0) ? 0 : top;
+  uint16_t off = (LEDS_ACTIVE_STATE != 0) ? top : 0;
+  uint16_t* p_on_values = (uint16_t*)&p_group->values[0];
+  uint16_t* p_off_values = (uint16_t*)&p_group->values[1];
+
+  for(uint8_t i = 0; i < NRF_PWM_CHANNEL_COUNT; i++)
+  {
+    // unused channels have no pin, their values play to nothing
+    p_on_values[i] = on;
+    p_off_values[i] = off;
+    if(i >= p_group->channels) p_group->pins[i] = NRF_PWM_PIN_NOT_CONNECTED;
+  }
+
+  nrf_pwm_sequence_t on_seq =
+  {
+    .values.p_individual = &p_group->values[0],
+    .length = NRF_PWM_VALUES_LENGTH(p_group->values[0]),
+    .repeats = (uint32_t)(p_group->on_ms / p_group->step_ms) - 1,
+    .end_delay = 0
+  };
+  nrf_pwm_sequence_t off_seq =
+  {
+    .values.p_individual = &p_group->values[1],
+    .length = NRF_PWM_VALUES_LENGTH(p_group->values[1]),
+    .repeats = (uint32_t)(p_group->off_ms / p_group->step_ms) - 1,
+    .end_delay = 0
+  };
+
+  nrf_pwm_pins_set(p_pwm, p_group->pins);
+  nrf_pwm_configure(p_pwm, NRF_PWM_CLK_125kHz, NRF_PWM_MODE_UP, top);
+  nrf_pwm_decoder_set(p_pwm, NRF_PWM_LOAD_INDIVIDUAL, NRF_PWM_STEP_AUTO);
+  nrf_pwm_sequence_set(p_pwm, 0, &on_seq);
+  nrf_pwm_sequence_set(p_pwm, 1, &off_seq);
+
+  // both sequences once per loop, the short starts the next loop, forever
+  nrf_pwm_loop_set(p_pwm, 1);
+  nrf_pwm_shorts_set(p_pwm, NRF_PWM_SHORT_LOOPSDONE_SEQSTART0_MASK);
+  nrf_pwm_int_set(p_pwm, 0);
+
+  nrf_pwm_enable(p_pwm);
+  nrf_pwm_task_trigger(p_pwm, NRF_PWM_TASK_SEQSTART0);
+}
+
+ret_code_t hw_blink_start(const uint16_t* const* pp_leds, uint8_t count)
+{
+  if(m_group_count != 0) return NRF_ERROR_INVALID_STATE;
+  if(pp_leds == NULL || count == 0) return NRF_ERROR_INVALID_PARAM;
+
+  for(uint8_t i = 0; i < count; i++)
+  {
+    const uint16_t* p_led = pp_leds[i];
+    group_t* p_group = NULL;
+
+    if(p_led[1] == 0 || p_led[2] == 0)
+    {
+      m_group_count = 0;
+      return NRF_ERROR_INVALID_PARAM;
+    }
+
+    for(uint8_t g = 0; g < m_group_count; g++)
+    {
+      if(m_groups[g].on_ms == p_led[1] && m_groups[g].off_ms == p_led[2] &&
+         m_groups[g].channels < NRF_PWM_CHANNEL_COUNT)
+      {
+        p_group = &m_groups[g];
+        break;
+      }
+    }
+
+    if(p_group == NULL)
+    {
+      if(m_group_count == HW_BLINK_PWM_COUNT)
+      {
+        m_group_count = 0;
+        return NRF_ERROR_NO_MEM;
+      }
+      p_group = &m_groups[m_group_count++];
+      p_group->on_ms = p_led[1];
+      p_group->off_ms = p_led[2];
+      p_group->step_ms = step_ms_get(p_led[1], p_led[2]);
+      p_group->channels = 0;
+    }
+
+    p_group->pins[p_group->channels++] = p_led[0];
+  }
+
+  for(uint8_t g = 0; g < m_group_count; g++)
+  {
+    group_start(k_instances[g], &m_groups[g]);
+  }
+
+  return NRF_SUCCESS;
+}
+
+void hw_blink_report(void)
+{
+  uint32_t task_wakes = 0;  // 1/100 per second
+
+  printf("LED blink in hardware\r\n");
+  for(uint8_t g = 0; g < m_group_count; g++)
+  {
+    const group_t* p_group = &m_groups[g];
+
+    printf("  PWM%u  %u LEDs  on %u ms off %u ms  step %u ms\r\n", (unsigned)g,
+           (unsigned)p_group->channels, (unsigned)p_group->on_ms,
+           (unsigned)p_group->off_ms, (unsigned)p_group->step_ms);
+    // a task wakes at both edges of every period
+    task_wakes += p_group->channels * 200000UL / (p_group->on_ms + p_group->off_ms);
+  }
+
+  // edges of different LEDs in the same tick share a wake, so at most.
+  // SLEEP_PROF_ENABLED measures them
+  printf("  wakes per second: %u.%02u with one task per LED, 0 in hardware, computed\r\n",
+         (unsigned)(task_wakes / 100), (unsigned)(task_wakes % 100));
+}
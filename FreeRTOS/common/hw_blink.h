@@ -0,0 +1,54 @@
+/*
+  LED blinking in hardware with the PWM peripheral
+
+  A task that blinks an LED wakes the CPU at every edge, twice per period,
+  and keeps tickless idle from sleeping longer than the shorter of on and
+  off time. Here each PWM instance plays an on/off pattern from RAM on its
+  own, looping forever, the CPU never wakes for it:
+
+  - the LEDs of one instance share the timing, LEDs with the same on and
+    off time take the channels of one instance, up to 4, each other timing
+    takes the next instance
+  - the PWM period is one step, the largest common divisor of on and off
+    time up to 262 ms, the longest period at the 125 kHz base clock
+  - sequence 0 holds the on level for on_ms / step periods, sequence 1 the
+    off level for off_ms / step periods, LOOPSDONE restarts sequence 0
+
+  The descriptors are the {pin, on_ms, off_ms} arrays the LED tasks of
+  blinky_freertos take. Timing is that of HFCLK, which the PWM keeps
+  running from HFINT while it plays, a few hundred uA against the mA of
+  the LEDs and the wakes it saves.
+*/
+
+#ifndef HW_BLINK_H
+#define HW_BLINK_H
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+// PWM instances used from PWM0 up, fewer leave the others to the application
+#ifndef HW_BLINK_PWM_COUNT
+#define HW_BLINK_PWM_COUNT    4
+#endif
+
+/**
+ * @brief Start blinking the LEDs, runs until reset
+ *
+ * @param pp_leds - {pin, on_ms, off_ms} of each LED, LEDs light at
+ *                  LEDS_ACTIVE_STATE of boards.h
+ * @param count   - number of LEDs
+ *
+ * @return NRF_SUCCESS, NRF_ERROR_INVALID_PARAM on an on or off time of 0,
+ *         NRF_ERROR_NO_MEM when the timings need more instances than
+ *         HW_BLINK_PWM_COUNT, NRF_ERROR_INVALID_STATE if already started
+ */
+ret_code_t hw_blink_start(const uint16_t* const* pp_leds, uint8_t count);
+
+/**
+ * @brief Print the instances in use and the wakes per second the same LEDs
+ *        cost with one task each, computed from the timings. The sleep
+ *        profile of common/sleep_prof.h measures both
+ */
+void hw_blink_report(void);
+
+#endif /* HW_BLINK_H */
@@ -0,0 +1,149 @@
+/*
+  Budgeted background jobs run by the idle task, see idle_work.h
+*/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "idle_work.h"
+#include "cycle_counter.h"
+#include <stdio.h>
+
+#if configUSE_IDLE_HOOK != 1
+#error "idle_work.c needs configUSE_IDLE_HOOK 1, idle_work_run() is called from vApplicationIdleHook()"
+#endif
+
+static idle_work_job_t* m_p_jobs = NULL;
+static idle_work_job_t* m_p_cursor = NULL;  // job the next pass starts with
+static uint32_t m_job_count = 0;
+
+static uint32_t m_sleeps_shortened = 0;
+static uint32_t m_sleeps_skipped = 0;
+
+void idle_work_register(idle_work_job_t* p_job)
+{
+  // slices are timed with CYCCNT
+  if(m_p_jobs == NULL) cycle_counter_init();
+
+  taskENTER_CRITICAL();
+  p_job->p_next = m_p_jobs;
+  m_p_jobs = p_job;
+  m_p_cursor = p_job;
+  m_job_count++;
+  taskEXIT_CRITICAL();
+}
+
+void idle_work_kick(idle_work_job_t* p_job)
+{
+  taskENTER_CRITICAL();
+  if(!p_job->pending)
+  {
+    p_job->kick_tick = xTaskGetTickCount();
+    p_job->pending = true;
+  }
+  taskEXIT_CRITICAL();
+}
+
+void idle_work_kick_from_isr(idle_work_job_t* p_job)
+{
+  UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+  if(!p_job->pending)
+  {
+    p_job->kick_tick = xTaskGetTickCountFromISR();
+    p_job->pending = true;
+  }
+  taskEXIT_CRITICAL_FROM_ISR(saved);
+}
+
+void idle_work_run(void)
+{
+  uint32_t pass_start = cycle_counter_get();
+  uint32_t idle_jobs = 0;
+
+  // stop after the budget or after a full round without pending job
+  while(m_p_cursor != NULL && idle_jobs < m_job_count &&
+        cycle_counter_get() - pass_start < IDLE_WORK_BUDGET_CYCLES)
+  {
+    idle_work_job_t* p_job = m_p_cursor;
+    m_p_cursor = (p_job->p_next != NULL) ? p_job->p_next : m_p_jobs;
+
+    if(!p_job->pending)
+    {
+      idle_jobs++;
+      continue;
+    }
+    idle_jobs = 0;
+
+    // a kick while the slice runs must not be lost, the job is done only
+    // if nothing kicked it meanwhile
+    uint32_t kick_tick = p_job->kick_tick;
+    taskENTER_CRITICAL();
+    p_job->pending = false;
+    taskEXIT_CRITICAL();
+
+    uint32_t slice_start = cycle_counter_get();
+    bool more = p_job->fn(p_job->p_context);
+    uint32_t cycles = cycle_counter_get() - slice_start;
+
+    p_job->slices++;
+    p_job->cycles += cycles;
+    if(cycles > p_job->max_cycles) p_job->max_cycles = cycles;
+
+    if(more)
+    {
+      // keep the first kick time, the deferral runs from there
+      taskENTER_CRITICAL();
+      p_job->kick_tick = kick_tick;
+      p_job->pending = true;
+      taskEXIT_CRITICAL();
+    }
+  }
+}
+
+uint32_t idle_work_sleep_limit(uint32_t expected_ticks)
+{
+  // the scheduler is suspended, the tick count and the job list hold still
+  TickType_t now = xTaskGetTickCount();
+  uint32_t limit = expected_ticks;
+  bool pending = false;
+
+  for(idle_work_job_t* p_job = m_p_jobs; p_job != NULL; p_job = p_job->p_next)
+  {
+    if(!p_job->pending) continue;
+    pending = true;
+
+    uint32_t waited = now - p_job->kick_tick;
+    if(waited >= p_job->defer_ticks)
+    {
+      limit = 0;
+      break;
+    }
+    if(p_job->defer_ticks - waited < limit) limit = p_job->defer_ticks - waited;
+  }
+
+  if(!pending) return expected_ticks;
+
+  if(limit < IDLE_WORK_MIN_SLEEP_TICKS)
+  {
+    m_sleeps_skipped++;
+    return 0;
+  }
+  if(limit < expected_ticks) m_sleeps_shortened++;
+
+  return limit;
+}
+
+void idle_work_print(void)
+{
+  printf("Idle work, budget %u cycles, sleeps shortened %u skipped %u\r\n",
+         (unsigned)IDLE_WORK_BUDGET_CYCLES, (unsigned)m_sleeps_shortened, (unsigned)m_sleeps_skipped);
+
+  for(idle_work_job_t* p_job = m_p_jobs; p_job != NULL; p_job = p_job->p_next)
+  {
+    printf("  %-16s %7u slices %6u avg %6u max cycles%s\r\n",
+           p_job->name,
+           (unsigned)p_job->slices,
+           (unsigned)((p_job->slices == 0) ? 0 : p_job->cycles / p_job->slices),
+           (unsigned)p_job->max_cycles,
+           p_job->pending ? ", pending" : "");
+  }
+}
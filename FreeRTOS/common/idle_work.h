@@ -0,0 +1,129 @@
+/*
+  Budgeted background jobs run by the idle task
+
+  Modules register jobs for work that has no deadline of its own: flushing
+  a log, compacting flash records, scrubbing checksums. A job is a function
+  that does one short slice of its work and tells whether more is left.
+  idle_work_run(), called from vApplicationIdleHook(), runs slices of the
+  pending jobs round robin until IDLE_WORK_BUDGET_CYCLES are used, so one
+  idle pass never holds back the tickless sleep for long. Every other task
+  preempts the slices as usual.
+
+  Pending work only keeps the system awake when it is worth it. A wake
+  costs more than a slice, so a job kicked with a deferral of N ms rides on
+  the wakes that happen anyway for up to N ms:
+
+  - configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING() shortens each tickless
+    sleep so it ends when the oldest pending job runs out of deferral
+  - once a job is past its deferral, or the sleep left would be shorter
+    than IDLE_WORK_MIN_SLEEP_TICKS, the sleep is skipped and the idle task
+    keeps running slices until the work is done
+
+  A job is pending from idle_work_kick() until its function returns false.
+  Kicking a pending job keeps its first kick time.
+
+  This header is included by FreeRTOSConfig.h, it must not include kernel
+  headers.
+*/
+
+#ifndef IDLE_WORK_H
+#define IDLE_WORK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// CPU cycles of slices per idle pass, 6400 is 100 us at 64 MHz. The slice
+// that crosses the budget ends the pass, it is not cut short
+#ifndef IDLE_WORK_BUDGET_CYCLES
+#define IDLE_WORK_BUDGET_CYCLES     6400
+#endif
+
+// sleeps shorter than this are skipped while work is pending
+#ifndef IDLE_WORK_MIN_SLEEP_TICKS
+#define IDLE_WORK_MIN_SLEEP_TICKS   8
+#endif
+
+// kernel hook, expanded in the idle task with the scheduler suspended right
+// before portSUPPRESS_TICKS_AND_SLEEP(), 0 skips the sleep
+#define configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING(xExpectedIdleTime) \
+          (xExpectedIdleTime) = idle_work_sleep_limit((uint32_t)(xExpectedIdleTime))
+
+/**
+ * @brief Do one slice of the work
+ *
+ * @param p_context - context given to IDLE_WORK_JOB_DEF()
+ *
+ * @return true if work is left, false when done
+ */
+typedef bool (*idle_work_fn_t)(void* p_context);
+
+typedef struct idle_work_job_s
+{
+  idle_work_fn_t fn;
+  void* p_context;
+  const char* name;
+  uint32_t defer_ticks;
+  struct idle_work_job_s* p_next;
+  volatile uint32_t kick_tick;
+  volatile bool pending;
+  uint32_t slices;
+  uint32_t cycles;      // total of all slices, wraps
+  uint32_t max_cycles;  // longest slice
+}idle_work_job_t;
+
+/**
+ * @brief Define a job
+ *
+ * @param _name     - job variable name, also printed by idle_work_print()
+ * @param _fn       - slice function
+ * @param _context  - passed to the slice function
+ * @param _defer_ms - how long pending work may wait for a wake that happens
+ *                    anyway
+ */
+#define IDLE_WORK_JOB_DEF(_name, _fn, _context, _defer_ms)  \
+  static idle_work_job_t _name =                            \
+  {                                                         \
+    .fn = (_fn),                                            \
+    .p_context = (_context),                                \
+    .name = #_name,                                         \
+    .defer_ticks = (_defer_ms) * configTICK_RATE_HZ / 1000  \
+  }
+
+/**
+ * @brief Add a job, from main() or a task, before kicking it
+ */
+void idle_work_register(idle_work_job_t* p_job);
+
+/**
+ * @brief Make a job pending, from a task
+ */
+void idle_work_kick(idle_work_job_t* p_job);
+
+/**
+ * @brief Make a job pending, from an ISR
+ */
+void idle_work_kick_from_isr(idle_work_job_t* p_job);
+
+/**
+ * @brief Run slices of the pending jobs within the budget, call from
+ *        vApplicationIdleHook()
+ */
+void idle_work_run(void);
+
+/**
+ * @brief Sleep length allowed with the pending work, called by
+ *        configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING()
+ *
+ * @param expected_ticks - sleep length the kernel is about to ask for
+ *
+ * @return the same or a shorter length, 0 to skip the sleep
+ */
+uint32_t idle_work_sleep_limit(uint32_t expected_ticks);
+
+/**
+ * @brief Print slices and cycles per job and the sleeps shortened or
+ *        skipped, from a task
+ */
+void idle_work_print(void);
+
+#endif /* IDLE_WORK_H */
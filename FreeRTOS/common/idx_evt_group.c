@@ -0,0 +1,311 @@
+/*
+  Event group with waiters indexed by bit, see idx_evt_group.h
+*/
+
+#include "idx_evt_group.h"
+#include "task.h"
+#include <stddef.h>
+
+#if IDX_EVT_GROUP_MAX_WAITERS <= 32
+#define SLOT_FIRST(slots) ((uint32_t)__builtin_ctz(slots))
+#else
+#define SLOT_FIRST(slots) ((uint32_t)__builtin_ctzll(slots))
+#endif
+
+#if IDX_EVT_GROUP_BITS == 32
+#define BIT_FIRST(bits)   ((uint32_t)__builtin_ctz(bits))
+#else
+#define BIT_FIRST(bits)   ((uint32_t)__builtin_ctzll(bits))
+#endif
+
+#define SLOT_MASK(slot)   ((idx_evt_slots_t)1 << (slot))
+
+#define ALL_SLOTS_FREE    (~(idx_evt_slots_t)0 >> (sizeof(idx_evt_slots_t) * 8 - IDX_EVT_GROUP_MAX_WAITERS))
+
+struct idx_evt_waiter_s
+{
+  TaskHandle_t task;
+  idx_evt_bits_t wait_bits;
+  idx_evt_bits_t indexed;       // bits the slot is registered under
+  idx_evt_bits_t result;        // group bits when the condition was met
+  bool wait_all;
+  bool clear_on_exit;
+  volatile bool woken;
+};
+
+static inline bool condition_met(idx_evt_bits_t bits, idx_evt_bits_t wait_bits, bool wait_all)
+{
+  return wait_all ? ((bits & wait_bits) == wait_bits) : ((bits & wait_bits) != 0);
+}
+
+// all helpers below run inside the critical section
+
+static void slot_index(idx_evt_group_t* p_group, uint32_t slot, idx_evt_waiter_t* p_waiter)
+{
+  idx_evt_bits_t bits;
+
+  if(p_waiter->wait_all)
+  {
+    // one missing bit is enough, the others can only matter once it is set
+    idx_evt_bits_t missing = p_waiter->wait_bits & ~p_group->bits;
+    bits = missing & (~missing + 1);
+  }
+  else
+  {
+    bits = p_waiter->wait_bits;
+  }
+
+  p_waiter->indexed = bits;
+  while(bits != 0)
+  {
+    uint32_t bit = BIT_FIRST(bits);
+    bits &= bits - 1;
+    p_group->slots_on_bit[bit] |= SLOT_MASK(slot);
+  }
+}
+
+static void slot_unindex(idx_evt_group_t* p_group, uint32_t slot, idx_evt_waiter_t* p_waiter)
+{
+  idx_evt_bits_t bits = p_waiter->indexed;
+
+  while(bits != 0)
+  {
+    uint32_t bit = BIT_FIRST(bits);
+    bits &= bits - 1;
+    p_group->slots_on_bit[bit] &= ~SLOT_MASK(slot);
+  }
+  p_waiter->indexed = 0;
+}
+
+static void slot_release(idx_evt_group_t* p_group, uint32_t slot, idx_evt_waiter_t* p_waiter)
+{
+  slot_unindex(p_group, slot, p_waiter);
+  p_group->waiters[slot] = NULL;
+  p_group->free_slots |= SLOT_MASK(slot);
+}
+
+void idx_evt_group_init(idx_evt_group_t* p_group)
+{
+  p_group->bits = 0;
+  p_group->free_slots = ALL_SLOTS_FREE;
+  for(uint32_t i = 0; i < IDX_EVT_GROUP_BITS; i++) p_group->slots_on_bit[i] = 0;
+  for(uint32_t i = 0; i < IDX_EVT_GROUP_MAX_WAITERS; i++) p_group->waiters[i] = NULL;
+}
+
+// shared by the task and the ISR variant, p_higher_prio_woken is NULL from a
+// task. Work is bounded by the bits set and the waiters registered under them,
+// at most IDX_EVT_GROUP_MAX_WAITERS notifications.
+static idx_evt_bits_t set_bits_locked(idx_evt_group_t* p_group, idx_evt_bits_t bits,
+                                      BaseType_t* p_higher_prio_woken)
+{
+  idx_evt_bits_t to_clear = 0;
+  idx_evt_slots_t candidates = 0;
+
+  p_group->bits |= bits;
+
+  // only the slots registered under the bits being set can be affected
+  while(bits != 0)
+  {
+    uint32_t bit = BIT_FIRST(bits);
+    bits &= bits - 1;
+    candidates |= p_group->slots_on_bit[bit];
+  }
+
+  while(candidates != 0)
+  {
+    uint32_t slot = SLOT_FIRST(candidates);
+    candidates &= candidates - 1;
+
+    idx_evt_waiter_t* p_waiter = p_group->waiters[slot];
+    if(condition_met(p_group->bits, p_waiter->wait_bits, p_waiter->wait_all))
+    {
+      TaskHandle_t task = p_waiter->task;
+
+      p_waiter->result = p_group->bits;
+      if(p_waiter->clear_on_exit) to_clear |= p_waiter->wait_bits;
+      slot_release(p_group, slot, p_waiter);
+      // waiter may return from here on, don't touch it after woken is set
+      p_waiter->woken = true;
+      if(p_higher_prio_woken == NULL) xTaskNotifyGive(task);
+      else                            vTaskNotifyGiveFromISR(task, p_higher_prio_woken);
+    }
+    else
+    {
+      // wait for all with its indexed bit now set, move to the next missing one
+      slot_unindex(p_group, slot, p_waiter);
+      slot_index(p_group, slot, p_waiter);
+    }
+  }
+
+  // cleared after all waiters were tested, same as the kernel event group
+  p_group->bits &= ~to_clear;
+  return p_group->bits;
+}
+
+idx_evt_bits_t idx_evt_group_set_bits(idx_evt_group_t* p_group, idx_evt_bits_t bits)
+{
+  taskENTER_CRITICAL();
+  idx_evt_bits_t result = set_bits_locked(p_group, bits, NULL);
+  taskEXIT_CRITICAL();
+
+  return result;
+}
+
+idx_evt_bits_t idx_evt_group_set_bits_from_isr(idx_evt_group_t* p_group, idx_evt_bits_t bits,
+                                               BaseType_t* p_higher_prio_woken)
+{
+  UBaseType_t isr_state = taskENTER_CRITICAL_FROM_ISR();
+  idx_evt_bits_t result = set_bits_locked(p_group, bits, p_higher_prio_woken);
+  taskEXIT_CRITICAL_FROM_ISR(isr_state);
+
+  return result;
+}
+
+idx_evt_bits_t idx_evt_group_clear_bits(idx_evt_group_t* p_group, idx_evt_bits_t bits)
+{
+  taskENTER_CRITICAL();
+  idx_evt_bits_t result = p_group->bits;
+  p_group->bits &= ~bits;
+  taskEXIT_CRITICAL();
+
+  // a cleared bit can't unblock anyone and wait for all waiters stay indexed
+  // on a bit that is still missing, nothing to update
+  return result;
+}
+
+idx_evt_bits_t idx_evt_group_clear_bits_from_isr(idx_evt_group_t* p_group, idx_evt_bits_t bits)
+{
+  UBaseType_t isr_state = taskENTER_CRITICAL_FROM_ISR();
+  idx_evt_bits_t result = p_group->bits;
+  p_group->bits &= ~bits;
+  taskEXIT_CRITICAL_FROM_ISR(isr_state);
+
+  return result;
+}
+
+idx_evt_bits_t idx_evt_group_get_bits(idx_evt_group_t* p_group)
+{
+#if IDX_EVT_GROUP_BITS > 32
+  // two loads on Cortex-M4, a set or clear in between would tear the value.
+  // Masking by BASEPRI works from a task and from an ISR alike
+  UBaseType_t isr_state = taskENTER_CRITICAL_FROM_ISR();
+  idx_evt_bits_t bits = p_group->bits;
+  taskEXIT_CRITICAL_FROM_ISR(isr_state);
+
+  return bits;
+#else
+  return p_group->bits;
+#endif
+}
+
+static void waiter_prepare(idx_evt_waiter_t* p_waiter, idx_evt_bits_t bits_to_wait,
+                           bool clear_on_exit, bool wait_for_all)
+{
+  p_waiter->task = xTaskGetCurrentTaskHandle();
+  p_waiter->wait_bits = bits_to_wait;
+  p_waiter->indexed = 0;
+  p_waiter->result = 0;
+  p_waiter->wait_all = wait_for_all;
+  p_waiter->clear_on_exit = clear_on_exit;
+  p_waiter->woken = false;
+}
+
+// entered inside the critical section with the condition not met, leaves it
+static idx_evt_bits_t waiter_block(idx_evt_group_t* p_group, idx_evt_waiter_t* p_waiter,
+                                   TickType_t ticks_to_wait)
+{
+  idx_evt_bits_t result = p_group->bits;
+  uint32_t slot;
+
+  if(ticks_to_wait == 0 || p_group->free_slots == 0)
+  {
+    taskEXIT_CRITICAL();
+    configASSERT(ticks_to_wait == 0);   // IDX_EVT_GROUP_MAX_WAITERS too small
+    return result;
+  }
+
+  slot = SLOT_FIRST(p_group->free_slots);
+  p_group->free_slots &= ~SLOT_MASK(slot);
+  p_group->waiters[slot] = p_waiter;
+  slot_index(p_group, slot, p_waiter);
+
+  taskEXIT_CRITICAL();
+
+  // a notification left over from an earlier wait, or given by something
+  // else, only ends one ulTaskNotifyTake(), woken is what counts
+  TimeOut_t timeout;
+  vTaskSetTimeOutState(&timeout);
+  while(!p_waiter->woken)
+  {
+    if(xTaskCheckForTimeOut(&timeout, &ticks_to_wait) != pdFALSE) break;
+    (void)ulTaskNotifyTake(pdTRUE, ticks_to_wait);
+  }
+
+  taskENTER_CRITICAL();
+  if(p_waiter->woken)
+  {
+    result = p_waiter->result;
+  }
+  else
+  {
+    slot_release(p_group, slot, p_waiter);
+    result = p_group->bits;
+  }
+  taskEXIT_CRITICAL();
+
+  return result;
+}
+
+idx_evt_bits_t idx_evt_group_wait_bits(idx_evt_group_t* p_group,
+                                       idx_evt_bits_t bits_to_wait,
+                                       BaseType_t clear_on_exit,
+                                       BaseType_t wait_for_all,
+                                       TickType_t ticks_to_wait)
+{
+  idx_evt_waiter_t waiter;
+
+  configASSERT(bits_to_wait != 0);
+  waiter_prepare(&waiter, bits_to_wait, clear_on_exit != pdFALSE, wait_for_all != pdFALSE);
+
+  taskENTER_CRITICAL();
+
+  idx_evt_bits_t result = p_group->bits;
+  if(condition_met(result, bits_to_wait, waiter.wait_all))
+  {
+    if(waiter.clear_on_exit) p_group->bits &= ~bits_to_wait;
+    taskEXIT_CRITICAL();
+    return result;
+  }
+
+  return waiter_block(p_group, &waiter, ticks_to_wait);
+}
+
+idx_evt_bits_t idx_evt_group_sync(idx_evt_group_t* p_group,
+                                  idx_evt_bits_t bits_to_set,
+                                  idx_evt_bits_t bits_to_wait,
+                                  TickType_t ticks_to_wait)
+{
+  idx_evt_waiter_t waiter;
+
+  configASSERT(bits_to_wait != 0);
+  waiter_prepare(&waiter, bits_to_wait, true, true);
+
+  // set, test and block in one critical section, no other participant can
+  // see the bits between the set and the wait
+  taskENTER_CRITICAL();
+
+  idx_evt_bits_t original = p_group->bits;
+  (void)set_bits_locked(p_group, bits_to_set, NULL);
+
+  // tested on the bits before the set, other participants unblocked by it
+  // may already have cleared them, same as xEventGroupSync()
+  idx_evt_bits_t result = original | bits_to_set;
+  if((result & bits_to_wait) == bits_to_wait)
+  {
+    p_group->bits &= ~bits_to_wait;
+    taskEXIT_CRITICAL();
+    return result;
+  }
+
+  return waiter_block(p_group, &waiter, ticks_to_wait);
+}
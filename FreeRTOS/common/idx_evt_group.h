@@ -0,0 +1,172 @@
+/*
+  Event group with waiters indexed by bit
+
+  xEventGroupSetBits() walks every task blocked on the group with the
+  scheduler suspended, so the cost of a set grows with the number of waiters
+  even when none of them waits for the bits being set. This event group keeps,
+  for every bit, a bitmap of the waiter slots that must be checked when that
+  bit gets set:
+
+  - wait for any: the waiter is indexed under each of its bits
+  - wait for all: the waiter is indexed under one bit it still misses and
+    moves to the next missing bit when that one is set
+
+  A set only touches the waiters found under the bits it sets, O(bits set +
+  waiters touched) instead of O(all waiters). All bits are usable, the
+  kernel group reserves 8 of its 32 for its own flags.
+
+  IDX_EVT_GROUP_BITS makes the groups 64 bits wide, for rendezvous of more
+  than 24 tasks with one bit per participant. It applies to every group of
+  the project, a 64-bit group costs 32 more index words.
+
+  Same semantics as xEventGroupWaitBits() / xEventGroupSetBits() /
+  xEventGroupSync(): clear on exit, wait for all or any, return value of the
+  bits at unblock or timeout.
+
+  - waiting tasks block on their task notification, don't use it for
+    anything else in a task that waits on an idx_evt_group_t
+  - at most IDX_EVT_GROUP_MAX_WAITERS tasks wait at the same time, more
+    return as timed out at once (configASSERT() in debug builds)
+  - the _from_isr variants set bits and ready the waiters right in the
+    interrupt, unlike xEventGroupSetBitsFromISR() which posts the set to the
+    timer daemon task and fails when its queue is full. They can be called
+    from interrupts at or below configMAX_SYSCALL_INTERRUPT_PRIORITY
+  - get works in both contexts
+*/
+
+#ifndef IDX_EVT_GROUP_H
+#define IDX_EVT_GROUP_H
+
+#include "FreeRTOS.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// tasks that can block on one group at the same time, 1 to 64
+#ifndef IDX_EVT_GROUP_MAX_WAITERS
+#define IDX_EVT_GROUP_MAX_WAITERS 32
+#endif
+
+// width of every group, 32 or 64
+#ifndef IDX_EVT_GROUP_BITS
+#define IDX_EVT_GROUP_BITS        32
+#endif
+
+#if IDX_EVT_GROUP_BITS == 32
+typedef uint32_t idx_evt_bits_t;
+#elif IDX_EVT_GROUP_BITS == 64
+typedef uint64_t idx_evt_bits_t;
+#else
+#error "IDX_EVT_GROUP_BITS must be 32 or 64"
+#endif
+
+// bit n of a group, IDX_EVT_BIT(40) needs the 64-bit width
+#define IDX_EVT_BIT(n)            ((idx_evt_bits_t)1 << (n))
+
+#if IDX_EVT_GROUP_MAX_WAITERS <= 32
+typedef uint32_t idx_evt_slots_t;
+#elif IDX_EVT_GROUP_MAX_WAITERS <= 64
+typedef uint64_t idx_evt_slots_t;
+#else
+#error "IDX_EVT_GROUP_MAX_WAITERS can't be above 64"
+#endif
+
+// lives on the stack of the waiting task while it is blocked
+typedef struct idx_evt_waiter_s idx_evt_waiter_t;
+
+typedef struct
+{
+  idx_evt_bits_t bits;
+  idx_evt_slots_t free_slots;                         // 1 = slot free
+  idx_evt_slots_t slots_on_bit[IDX_EVT_GROUP_BITS];   // slots to check when the bit is set
+  idx_evt_waiter_t* waiters[IDX_EVT_GROUP_MAX_WAITERS];
+}idx_evt_group_t;
+
+/**
+ * @brief Prepare a group, all bits cleared, no waiters
+ */
+void idx_evt_group_init(idx_evt_group_t* p_group);
+
+/**
+ * @brief Set bits and unblock the waiters whose condition is now met
+ *
+ * @return bits value when the call returns, after clear on exit of the
+ *         unblocked waiters
+ */
+idx_evt_bits_t idx_evt_group_set_bits(idx_evt_group_t* p_group, idx_evt_bits_t bits);
+
+/**
+ * @brief Set bits from an interrupt, waiters are readied before it returns
+ *
+ * Interrupts are masked up to configMAX_SYSCALL_INTERRUPT_PRIORITY for the
+ * bits set plus one pass per waiter registered under them, never more than
+ * IDX_EVT_GROUP_MAX_WAITERS waiters.
+ *
+ * @param p_group             - event group
+ * @param bits                - bits to set
+ * @param p_higher_prio_woken - set to pdTRUE if an unblocked task has a higher
+ *                              priority than the interrupted one, pass it to
+ *                              portYIELD_FROM_ISR()
+ *
+ * @return bits value when the call returns
+ */
+idx_evt_bits_t idx_evt_group_set_bits_from_isr(idx_evt_group_t* p_group, idx_evt_bits_t bits,
+                                               BaseType_t* p_higher_prio_woken);
+
+/**
+ * @brief Clear bits
+ *
+ * @return bits value before the clear
+ */
+idx_evt_bits_t idx_evt_group_clear_bits(idx_evt_group_t* p_group, idx_evt_bits_t bits);
+
+/**
+ * @brief Clear bits from an interrupt
+ *
+ * @return bits value before the clear
+ */
+idx_evt_bits_t idx_evt_group_clear_bits_from_isr(idx_evt_group_t* p_group, idx_evt_bits_t bits);
+
+/**
+ * @brief Current bits value, from a task or an ISR
+ */
+idx_evt_bits_t idx_evt_group_get_bits(idx_evt_group_t* p_group);
+
+/**
+ * @brief Block until any or all of the bits are set
+ *
+ * @param p_group       - event group
+ * @param bits_to_wait  - bits to test, not 0
+ * @param clear_on_exit - pdTRUE clears bits_to_wait when the condition is met
+ * @param wait_for_all  - pdTRUE waits for all bits, pdFALSE for any of them
+ * @param ticks_to_wait - timeout
+ *
+ * @return bits value when the condition was met, or at timeout
+ */
+idx_evt_bits_t idx_evt_group_wait_bits(idx_evt_group_t* p_group,
+                                       idx_evt_bits_t bits_to_wait,
+                                       BaseType_t clear_on_exit,
+                                       BaseType_t wait_for_all,
+                                       TickType_t ticks_to_wait);
+
+/**
+ * @brief Set bits then wait for all of another set, as one atomic step
+ *
+ * Rendezvous of several tasks, each one sets its own bit and waits for the
+ * bits of all participants. The set, the test and the block happen in the
+ * same critical section. The bits to wait for are cleared when the
+ * rendezvous completes.
+ *
+ * @param p_group       - event group
+ * @param bits_to_set   - bits of the calling task, can be 0
+ * @param bits_to_wait  - bits of all participants, not 0
+ * @param ticks_to_wait - timeout
+ *
+ * @return bits value when the rendezvous completed, or at timeout. The
+ *         rendezvous completed if all bits_to_wait are set in it
+ */
+idx_evt_bits_t idx_evt_group_sync(idx_evt_group_t* p_group,
+                                  idx_evt_bits_t bits_to_set,
+                                  idx_evt_bits_t bits_to_wait,
+                                  TickType_t ticks_to_wait);
+
+#endif /* IDX_EVT_GROUP_H */
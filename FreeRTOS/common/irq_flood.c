@@ -0,0 +1,97 @@
+/*
+  Synthetic interrupt source, see irq_flood.h
+*/
+
+#include "irq_flood.h"
+#include "app_util_platform.h"
+#include "nrf_timer.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#define TIMER_TICKS_PER_US  16
+
+// the timer counts freely, compare values are compared as signed differences
+#define MAX_PERIOD_US       (INT32_MAX / TIMER_TICKS_PER_US)
+
+static irq_flood_handler_t m_handler = NULL;
+static uint32_t m_period;     // timer ticks
+static uint32_t m_due;        // counter value of the pending compare
+static uint32_t m_skipped;    // periods passed while moving the compare on
+
+// CC registers are written and read directly, the HAL names of these calls
+// differ between nrfx versions
+static uint32_t counter_get(void)
+{
+  nrf_timer_task_trigger(IRQ_FLOOD_TIMER, NRF_TIMER_TASK_CAPTURE1);
+  return IRQ_FLOOD_TIMER->CC[1];
+}
+
+void IRQ_FLOOD_TIMER_IRQHandler(void)
+{
+  uint32_t now = counter_get();
+  uint32_t late = now - m_due;
+  uint32_t missed;
+
+  nrf_timer_event_clear(IRQ_FLOOD_TIMER, NRF_TIMER_EVENT_COMPARE0);
+
+  // a compare written as the counter reached it, already counted as missed
+  if((int32_t)late < 0 || m_handler == NULL) return;
+
+  missed = late / m_period + m_skipped;
+  m_due += (late / m_period) * m_period;
+  m_skipped = 0;
+
+  // the next compare must still be ahead once written, or it only fires
+  // after the 32-bit counter wrapped
+  do
+  {
+    m_due += m_period;
+    IRQ_FLOOD_TIMER->CC[0] = m_due;
+    m_skipped++;
+  } while((int32_t)(m_due - counter_get()) <= 0);
+  m_skipped--;
+
+  m_handler((uint32_t)(((uint64_t)late * 1000ULL) / TIMER_TICKS_PER_US), missed);
+}
+
+ret_code_t irq_flood_start(uint32_t period_us, irq_flood_handler_t handler)
+{
+  if(handler == NULL || period_us < IRQ_FLOOD_MIN_PERIOD_US || period_us > MAX_PERIOD_US)
+  {
+    return NRF_ERROR_INVALID_PARAM;
+  }
+  if(m_handler != NULL) return NRF_ERROR_INVALID_STATE;
+
+  m_handler = handler;
+  m_period = period_us * TIMER_TICKS_PER_US;
+  m_due = m_period;
+  m_skipped = 0;
+
+  nrf_timer_task_trigger(IRQ_FLOOD_TIMER, NRF_TIMER_TASK_STOP);
+  nrf_timer_task_trigger(IRQ_FLOOD_TIMER, NRF_TIMER_TASK_CLEAR);
+  nrf_timer_mode_set(IRQ_FLOOD_TIMER, NRF_TIMER_MODE_TIMER);
+  nrf_timer_bit_width_set(IRQ_FLOOD_TIMER, NRF_TIMER_BIT_WIDTH_32);
+  nrf_timer_frequency_set(IRQ_FLOOD_TIMER, NRF_TIMER_FREQ_16MHz);
+  IRQ_FLOOD_TIMER->CC[0] = m_due;
+  nrf_timer_event_clear(IRQ_FLOOD_TIMER, NRF_TIMER_EVENT_COMPARE0);
+  nrf_timer_int_enable(IRQ_FLOOD_TIMER, NRF_TIMER_INT_COMPARE0_MASK);
+
+  NVIC_SetPriority(IRQ_FLOOD_TIMER_IRQn, IRQ_FLOOD_IRQ_PRIORITY);
+  NVIC_ClearPendingIRQ(IRQ_FLOOD_TIMER_IRQn);
+  NVIC_EnableIRQ(IRQ_FLOOD_TIMER_IRQn);
+
+  nrf_timer_task_trigger(IRQ_FLOOD_TIMER, NRF_TIMER_TASK_START);
+
+  return NRF_SUCCESS;
+}
+
+void irq_flood_stop(void)
+{
+  NVIC_DisableIRQ(IRQ_FLOOD_TIMER_IRQn);
+  nrf_timer_task_trigger(IRQ_FLOOD_TIMER, NRF_TIMER_TASK_STOP);
+  nrf_timer_int_disable(IRQ_FLOOD_TIMER, NRF_TIMER_INT_COMPARE0_MASK);
+  nrf_timer_event_clear(IRQ_FLOOD_TIMER, NRF_TIMER_EVENT_COMPARE0);
+  NVIC_ClearPendingIRQ(IRQ_FLOOD_TIMER_IRQn);
+
+  m_handler = NULL;
+}
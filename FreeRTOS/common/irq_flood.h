@@ -0,0 +1,66 @@
+/*
+  Synthetic interrupt source at a configurable rate
+
+  Calls a handler in interrupt context every period, for stress tests of
+  the ...FromISR paths. The handler gets how late it runs against the time
+  the interrupt was due and how many periods passed without an interrupt,
+  because the previous one was still pending or running:
+
+  - target: a TIMER at 16 MHz, the interrupt moves its own compare value on
+    by one period, the latency is read by capturing the counter on entry
+  - host: a POSIX timer sends a real time signal, blocked in critical
+    sections like the tick signal of the port, missed periods are the
+    timer overruns
+
+  Latency resolves 62.5 ns on target and 1 ns on the host, where it also
+  holds the wake up latency of Linux.
+*/
+
+#ifndef IRQ_FLOOD_H
+#define IRQ_FLOOD_H
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+// TIMER instance, TIMER0 is used by the SoftDevice and TIMER1 by
+// 07-event-group/event-group/evt_isr_bench.c
+#ifndef IRQ_FLOOD_TIMER
+#define IRQ_FLOOD_TIMER             NRF_TIMER2
+#define IRQ_FLOOD_TIMER_IRQn        TIMER2_IRQn
+#define IRQ_FLOOD_TIMER_IRQHandler  TIMER2_IRQHandler
+#endif
+
+// highest priority allowed to call FreeRTOS
+#ifndef IRQ_FLOOD_IRQ_PRIORITY
+#define IRQ_FLOOD_IRQ_PRIORITY      APP_IRQ_PRIORITY_HIGH
+#endif
+
+// shortest period, below it the CPU does nothing but enter the interrupt
+#define IRQ_FLOOD_MIN_PERIOD_US     2
+
+/**
+ * @brief Called in interrupt context once per interrupt
+ *
+ * @param latency_ns - time from when the interrupt was due to the call
+ * @param missed     - periods without an interrupt since the previous call
+ */
+typedef void (*irq_flood_handler_t)(uint32_t latency_ns, uint32_t missed);
+
+/**
+ * @brief Start the interrupts, the first one is due one period from now
+ *
+ * @param period_us - interrupt period, at least IRQ_FLOOD_MIN_PERIOD_US
+ * @param handler   - called in interrupt context
+ *
+ * @return NRF_SUCCESS, NRF_ERROR_INVALID_PARAM on a too short period or no
+ *         handler, NRF_ERROR_INVALID_STATE if already running or
+ *         NRF_ERROR_INTERNAL if the host timer could not be created
+ */
+ret_code_t irq_flood_start(uint32_t period_us, irq_flood_handler_t handler);
+
+/**
+ * @brief Stop the interrupts, no handler call is running or follows on return
+ */
+void irq_flood_stop(void);
+
+#endif /* IRQ_FLOOD_H */
@@ -0,0 +1,248 @@
+/*
+  Interrupt flood stress test of the ...FromISR paths, see isr_stress.h
+
+  The consumers run below the control task, so it stops the flood on time
+  even when they never block. All counters are written with the flood
+  stopped or by one side only, the interrupt or a consumer.
+*/
+
+#include "isr_stress.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "event_groups.h"
+#include "irq_flood.h"
+#include "cycle_counter.h"
+#include <stdio.h>
+
+#define EVENT_BIT         (1UL << 0)
+
+#define CYCLES_PER_US     (SystemCoreClock / 1000000UL)
+
+// time for the consumers to take what is left after the flood stopped
+#define DRAIN_MS          20
+
+#define CONSUMER_PRIORITY 1
+#define CONTROL_PRIORITY  2
+
+typedef enum
+{
+  PATH_QUEUE,
+  PATH_SEMAPHORE,
+  PATH_EVT_GROUP,
+  PATH_COUNT
+}path_t;
+
+static const char* const k_path_names[PATH_COUNT] = { "queue", "semaphore", "evt_group" };
+
+static const uint32_t k_periods_us[] = ISR_STRESS_PERIODS_US;
+
+static QueueHandle_t m_queue;
+static SemaphoreHandle_t m_semaphore;
+static EventGroupHandle_t m_group;
+
+static volatile path_t m_path;
+
+// written by the interrupt
+static volatile uint32_t m_irqs;
+static volatile uint32_t m_missed;
+static volatile uint64_t m_irq_latency_total;
+static volatile uint32_t m_irq_latency_max;
+static volatile uint32_t m_accepted;
+static volatile uint32_t m_overflow;
+static volatile bool m_stamped;         // an event was handed with none outstanding
+static volatile uint32_t m_stamp;       // its cycles
+
+// written by the consumers
+static volatile uint32_t m_taken;
+static volatile uint32_t m_wakes;
+static volatile uint32_t m_wake_max;
+
+static void flood_handler(uint32_t latency_ns, uint32_t missed)
+{
+  BaseType_t higher_prio_woken = pdFALSE;
+  uint32_t now = cycle_counter_get();
+  BaseType_t posted;
+
+  m_irqs++;
+  m_missed += missed;
+  m_irq_latency_total += latency_ns;
+  if(latency_ns > m_irq_latency_max) m_irq_latency_max = latency_ns;
+
+  switch(m_path)
+  {
+    case PATH_QUEUE:
+      posted = xQueueSendFromISR(m_queue, &now, &higher_prio_woken);
+      break;
+
+    case PATH_SEMAPHORE:
+      posted = xSemaphoreGiveFromISR(m_semaphore, &higher_prio_woken);
+      break;
+
+    default:
+      posted = xEventGroupSetBitsFromISR(m_group, EVENT_BIT, &higher_prio_woken);
+      break;
+  }
+
+  if(posted != pdPASS)
+  {
+    m_overflow++;
+  }
+  else
+  {
+    // the next one the consumer takes, the wake latency is measured on it
+    if(m_accepted == m_taken)
+    {
+      m_stamped = true;
+      m_stamp = now;
+    }
+    m_accepted++;
+  }
+
+  portYIELD_FROM_ISR(higher_prio_woken);
+}
+
+static void event_taken(bool all)
+{
+  uint32_t wake = 0;
+
+  taskENTER_CRITICAL();
+  if(m_stamped)
+  {
+    wake = cycle_counter_get() - m_stamp;
+    m_stamped = false;
+  }
+  // an event group wake sees every set accepted so far
+  m_taken = all ? m_accepted : m_taken + 1;
+  m_wakes++;
+  taskEXIT_CRITICAL();
+
+  if(wake > m_wake_max) m_wake_max = wake;
+
+  uint32_t start = cycle_counter_get();
+  while(cycle_counter_get() - start < ISR_STRESS_WORK_US * CYCLES_PER_US);
+}
+
+static void queue_consumer_task(void* pvParameters)
+{
+  uint32_t stamp;
+
+  while(true)
+  {
+    if(xQueueReceive(m_queue, &stamp, portMAX_DELAY) == pdPASS) event_taken(false);
+  }
+}
+
+static void semaphore_consumer_task(void* pvParameters)
+{
+  while(true)
+  {
+    if(xSemaphoreTake(m_semaphore, portMAX_DELAY) == pdPASS) event_taken(false);
+  }
+}
+
+static void evt_group_consumer_task(void* pvParameters)
+{
+  while(true)
+  {
+    (void)xEventGroupWaitBits(m_group, EVENT_BIT, pdTRUE, pdFALSE, portMAX_DELAY);
+    event_taken(true);
+  }
+}
+
+// returns false on lost events
+static bool stress_run(path_t path, uint32_t period_us)
+{
+  ret_code_t err;
+
+  m_path = path;
+  m_irqs = 0;
+  m_missed = 0;
+  m_irq_latency_total = 0;
+  m_irq_latency_max = 0;
+  m_accepted = 0;
+  m_overflow = 0;
+  m_stamped = false;
+  m_taken = 0;
+  m_wakes = 0;
+  m_wake_max = 0;
+
+  err = irq_flood_start(period_us, flood_handler);
+  if(err != NRF_SUCCESS)
+  {
+    printf("%6u %-9s flood start fail %u\r\n", (unsigned)period_us, k_path_names[path], (unsigned)err);
+    return false;
+  }
+
+  vTaskDelay(pdMS_TO_TICKS(ISR_STRESS_WINDOW_MS));
+  irq_flood_stop();
+  vTaskDelay(pdMS_TO_TICKS(DRAIN_MS));
+
+  uint32_t merged = (path == PATH_EVT_GROUP) ? m_accepted - m_wakes : 0;
+  uint32_t lost = m_accepted - m_taken;
+  uint32_t irq_avg = (m_irqs > 0) ? (uint32_t)(m_irq_latency_total / m_irqs) : 0;
+
+  printf("%6u %-9s %7u %6u %8u %8u %8u %6u %4u %8u\r\n",
+         (unsigned)period_us, k_path_names[path],
+         (unsigned)m_irqs, (unsigned)m_missed,
+         (unsigned)m_irq_latency_max, (unsigned)irq_avg,
+         (unsigned)m_overflow, (unsigned)merged, (unsigned)lost,
+         (unsigned)(m_wake_max / CYCLES_PER_US));
+
+  return lost == 0;
+}
+
+static void control_task(void* pvParameters)
+{
+  bool failed = false;
+
+  cycle_counter_init();
+
+  printf("\r\nISR stress, %u ms per run, %u us work per event, depth %u\r\n",
+         (unsigned)ISR_STRESS_WINDOW_MS, (unsigned)ISR_STRESS_WORK_US, (unsigned)ISR_STRESS_DEPTH);
+  printf("period path         irqs missed  irq max  irq avg overflow merged lost wake max\r\n");
+  printf("                                      ns       ns                          us\r\n");
+
+  for(uint32_t i = 0; i < sizeof(k_periods_us) / sizeof(k_periods_us[0]); i++)
+  {
+    for(path_t path = PATH_QUEUE; path < PATH_COUNT; path++)
+    {
+      if(!stress_run(path, k_periods_us[i])) failed = true;
+    }
+  }
+
+  printf("ISR stress %s\r\n", failed ? "FAILED" : "passed");
+  ISR_STRESS_DONE(failed);
+  vTaskDelete(NULL);
+}
+
+BaseType_t isr_stress_start(void)
+{
+  BaseType_t err;
+
+  m_queue = xQueueCreate(ISR_STRESS_DEPTH, sizeof(uint32_t));
+  m_semaphore = xSemaphoreCreateCounting(ISR_STRESS_DEPTH, 0);
+  m_group = xEventGroupCreate();
+  if(m_queue == NULL || m_semaphore == NULL || m_group == NULL) return pdFAIL;
+
+  err = xTaskCreate(queue_consumer_task, "SQC", configMINIMAL_STACK_SIZE + 60, NULL,
+                    CONSUMER_PRIORITY, NULL);
+  if(err != pdPASS) return err;
+
+  err = xTaskCreate(semaphore_consumer_task, "SSC", configMINIMAL_STACK_SIZE + 60, NULL,
+                    CONSUMER_PRIORITY, NULL);
+  if(err != pdPASS) return err;
+
+  err = xTaskCreate(evt_group_consumer_task, "SEC", configMINIMAL_STACK_SIZE + 60, NULL,
+                    CONSUMER_PRIORITY, NULL);
+  if(err != pdPASS) return err;
+
+  return xTaskCreate(
+                      control_task,                   // pointer to the task function
+                      "STR",                          // task name mainly for debugging
+                      configMINIMAL_STACK_SIZE + 200, // task stack depth in words
+                      NULL,                           // task arguments
+                      CONTROL_PRIORITY,               // above the consumers
+                      NULL
+                    );
+}
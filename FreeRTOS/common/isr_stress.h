@@ -0,0 +1,69 @@
+/*
+  Interrupt flood stress test of the ...FromISR paths
+
+  irq_flood.h interrupts at each rate of ISR_STRESS_PERIODS_US in turn, for
+  ISR_STRESS_WINDOW_MS per path. Each interrupt hands one event to a
+  consumer task, which spends ISR_STRESS_WORK_US on it:
+
+  - queue:     xQueueSendFromISR() of the interrupt time stamp
+  - semaphore: xSemaphoreGiveFromISR() of a counting semaphore
+  - evt_group: xEventGroupSetBitsFromISR(), deferred to the timer daemon
+
+  Per path and rate it prints:
+
+  - irqs, missed  interrupts handled, periods that passed while the previous
+                  interrupt was still pending or running
+  - irq max/avg   from when the interrupt was due to the handler running, ns
+  - overflow      events refused because the queue or semaphore was full,
+                  or the timer queue for the deferred event group set
+  - merged        event group sets while the bit was still set
+  - lost          events handed over that the consumer never took
+  - wake max      from the first event not yet taken to the consumer
+                  running, us
+
+  lost must stay 0, anything else is a kernel or port fault and fails the
+  run. An event group can't tell a lost set from a merged one, its losses
+  count as merged.
+
+  Run it instead of the example tasks, not next to them.
+*/
+
+#ifndef ISR_STRESS_H
+#define ISR_STRESS_H
+
+#include "FreeRTOS.h"
+#include <stdbool.h>
+
+// interrupt periods in us, from idle to flood
+#ifndef ISR_STRESS_PERIODS_US
+#define ISR_STRESS_PERIODS_US   { 1000, 100, 20, 10 }
+#endif
+
+#ifndef ISR_STRESS_WINDOW_MS
+#define ISR_STRESS_WINDOW_MS    1000
+#endif
+
+// consumer busy time per event, above the period the objects fill up
+#ifndef ISR_STRESS_WORK_US
+#define ISR_STRESS_WORK_US      15
+#endif
+
+// queue length and semaphore count
+#ifndef ISR_STRESS_DEPTH
+#define ISR_STRESS_DEPTH        8
+#endif
+
+// called with the result after the last run, the host build exits there
+#ifndef ISR_STRESS_DONE
+#define ISR_STRESS_DONE(failed)
+#endif
+
+/**
+ * @brief Create the consumer and the control task, the table is printed as
+ *        the runs finish
+ *
+ * @return pdPASS or pdFAIL on insufficient heap memory
+ */
+BaseType_t isr_stress_start(void);
+
+#endif /* ISR_STRESS_H */
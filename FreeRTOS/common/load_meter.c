@@ -0,0 +1,107 @@
+/*
+  CPU load meter from idle loop passes, see load_meter.h
+*/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "load_meter.h"
+#include "cycle_counter.h"
+#include <stdio.h>
+
+// samples per time constant, 100 ms samples for 100 ms, 1 s and 10 s
+static const uint32_t k_ema_samples[LOAD_METER_WINDOWS] = { 1, 10, 100 };
+
+// averages in 1/65536, for the meter task only
+static int32_t m_ema[LOAD_METER_WINDOWS];
+
+// published averages in 1/1000, a halfword is read in one access
+static volatile uint16_t m_load[LOAD_METER_WINDOWS];
+
+static volatile uint32_t m_idle_passes = 0;
+static volatile bool m_calibrating = true;
+static uint32_t m_last_pass = 0;
+static bool m_last_pass_valid = false;
+static uint32_t m_pass_cycles = UINT32_MAX;
+
+void load_meter_idle_hook(void)
+{
+  uint32_t now = cycle_counter_get();
+
+  if(m_calibrating)
+  {
+    if(m_last_pass_valid && now - m_last_pass < m_pass_cycles) m_pass_cycles = now - m_last_pass;
+    m_last_pass = now;
+    m_last_pass_valid = true;
+  }
+  m_idle_passes++;
+}
+
+static void meter_task(void* pvParameters)
+{
+  TickType_t last_wake;
+  uint32_t last_cycles;
+  uint32_t last_passes;
+  uint32_t cycles_per_tick = SystemCoreClock / configTICK_RATE_HZ;
+
+  cycle_counter_init();
+  vTaskDelay(pdMS_TO_TICKS(LOAD_METER_CAL_MS));
+  m_calibrating = false;
+
+  // the idle task never ran, every cycle counts as load
+  if(m_pass_cycles == UINT32_MAX) m_pass_cycles = 0;
+  printf("Load meter: idle pass %u cycles\r\n", (unsigned)m_pass_cycles);
+
+  last_wake = xTaskGetTickCount();
+  last_cycles = cycle_counter_get();
+  last_passes = m_idle_passes;
+
+  while(true)
+  {
+    vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(LOAD_METER_SAMPLE_MS));
+
+    uint32_t cycles = cycle_counter_get();
+    uint32_t passes = m_idle_passes;
+    uint32_t awake = cycles - last_cycles;
+    uint32_t idle = (passes - last_passes) * m_pass_cycles;
+    uint32_t window = pdMS_TO_TICKS(LOAD_METER_SAMPLE_MS) * cycles_per_tick;
+    int32_t sample;
+
+    last_cycles = cycles;
+    last_passes = passes;
+
+    // busy share of the window in 1/65536
+    uint32_t busy = (awake > idle) ? awake - idle : 0;
+    if(busy > window) busy = window;
+    sample = (int32_t)(((uint64_t)busy << 16) / window);
+
+    for(uint32_t i = 0; i < LOAD_METER_WINDOWS; i++)
+    {
+      m_ema[i] += (sample - m_ema[i]) / (int32_t)k_ema_samples[i];
+      m_load[i] = (uint16_t)(((uint32_t)m_ema[i] * 1000 + 32768) >> 16);
+    }
+  }
+}
+
+bool load_meter_start(void)
+{
+  BaseType_t task_err = xTaskCreate(
+                                     meter_task,                     // pointer to the task function
+                                     "LDM",                          // task name mainly for debugging
+                                     configMINIMAL_STACK_SIZE + 60,  // task stack depth in words
+                                     NULL,                           // task arguments
+                                     configMAX_PRIORITIES - 1,       // samples on time whatever runs
+                                     NULL
+                                   );
+
+  return task_err == pdPASS;
+}
+
+uint32_t load_meter_get(load_meter_window_t window)
+{
+  return m_load[window];
+}
+
+uint32_t load_meter_pass_cycles(void)
+{
+  return m_calibrating ? 0 : m_pass_cycles;
+}
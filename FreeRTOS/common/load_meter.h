@@ -0,0 +1,76 @@
+/*
+  CPU load meter from idle loop passes
+
+  Counting idle hook calls says little on its own: how many of them make a
+  second depends on the CPU, the compiler and, with tickless idle, on how
+  often the idle task sleeps instead of looping. Here the count is
+  calibrated and combined with the awake time of the CPU:
+
+  - calibration: for the first LOAD_METER_CAL_MS after the scheduler
+    starts, load_meter_idle_hook() keeps the shortest CYCCNT distance
+    between two of its calls, the cost of one idle pass with nothing else
+    running
+  - every 100 ms the meter task takes the CYCCNT cycles of the window,
+    which only count while the CPU is awake, and subtracts idle passes
+    times the calibrated pass cost. What is left is the busy time, load is
+    busy time over the window length from the tick count
+  - the 100 ms samples are smoothed into exponential averages with a time
+    constant of 100 ms, 1 s and 10 s
+
+  Reading the load is one halfword load, cheap enough for overload checks
+  in any task or ISR. Passes that run longer than the calibrated one (an
+  idle hook with more work in it) count the extra as load.
+
+  CYCCNT keeps counting during sleep while a debugger is attached, the load
+  then reads too high.
+*/
+
+#ifndef LOAD_METER_H
+#define LOAD_METER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef LOAD_METER_CAL_MS
+#define LOAD_METER_CAL_MS       100
+#endif
+
+#define LOAD_METER_SAMPLE_MS    100
+
+typedef enum
+{
+  LOAD_METER_100MS,
+  LOAD_METER_1S,
+  LOAD_METER_10S,
+  LOAD_METER_WINDOWS
+}load_meter_window_t;
+
+/**
+ * @brief Count an idle pass, call first thing in vApplicationIdleHook()
+ */
+void load_meter_idle_hook(void);
+
+/**
+ * @brief Create the meter task at the highest priority
+ *
+ * @return false on insufficient heap memory
+ */
+bool load_meter_start(void);
+
+/**
+ * @brief Smoothed CPU load, from any context
+ *
+ * @param window - time constant of the average
+ *
+ * @return load in 1/1000, 0 until calibrated
+ */
+uint32_t load_meter_get(load_meter_window_t window);
+
+/**
+ * @brief Calibrated cost of one idle pass
+ *
+ * @return CPU cycles, 0 until calibrated
+ */
+uint32_t load_meter_pass_cycles(void);
+
+#endif /* LOAD_METER_H */
@@ -0,0 +1,98 @@
+/*
+  64-bit monotonic time service, see mono_time.h
+*/
+
+#include "mono_time.h"
+#include "app_util_platform.h"
+#include "nrf_drv_clock.h"
+#include "nrf_rtc.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// RTC COUNTER is 24 bits wide
+#define RTC_COUNTER_BITS  24
+
+// number of COUNTER wraps, written only by the overflow interrupt
+static volatile uint32_t m_overflows = 0;
+static bool m_started = false;
+
+ret_code_t mono_time_init(void)
+{
+  if(m_started) return NRF_ERROR_INVALID_STATE;
+
+  // the RTC only counts while LFCLK runs, FreeRTOS requests it too but only
+  // when the scheduler starts
+  nrf_drv_clock_lfclk_request(NULL);
+
+  nrf_rtc_task_trigger(MONO_TIME_RTC, NRF_RTC_TASK_STOP);
+  nrf_rtc_task_trigger(MONO_TIME_RTC, NRF_RTC_TASK_CLEAR);
+  nrf_rtc_prescaler_set(MONO_TIME_RTC, 0);
+
+  nrf_rtc_event_clear(MONO_TIME_RTC, NRF_RTC_EVENT_OVERFLOW);
+  nrf_rtc_int_enable(MONO_TIME_RTC, NRF_RTC_INT_OVERFLOW_MASK);
+
+  NVIC_SetPriority(MONO_TIME_RTC_IRQn, MONO_TIME_IRQ_PRIORITY);
+  NVIC_ClearPendingIRQ(MONO_TIME_RTC_IRQn);
+  NVIC_EnableIRQ(MONO_TIME_RTC_IRQn);
+
+  m_overflows = 0;
+  m_started = true;
+  nrf_rtc_task_trigger(MONO_TIME_RTC, NRF_RTC_TASK_START);
+
+  return NRF_SUCCESS;
+}
+
+uint64_t mono_time_ticks_get(void)
+{
+  uint32_t overflows;
+  uint32_t counter;
+  bool wrapped;
+
+  // Retry only if the overflow interrupt ran while reading, never wait for it:
+  // callers that preempt the RTC interrupt or run with interrupts masked would
+  // wait forever. A wrap the interrupt has not counted yet is taken from the
+  // pending event, so it is never missed or counted twice.
+  do
+  {
+    overflows = m_overflows;
+    counter = nrf_rtc_counter_get(MONO_TIME_RTC);
+    wrapped = nrf_rtc_event_pending(MONO_TIME_RTC, NRF_RTC_EVENT_OVERFLOW);
+
+    if(wrapped)
+    {
+      // the wrap happened before or right after the first read, re-read so
+      // the counter surely belongs to the new epoch
+      counter = nrf_rtc_counter_get(MONO_TIME_RTC);
+    }
+  } while(overflows != m_overflows);
+
+  if(wrapped) overflows++;
+
+  return ((uint64_t)overflows << RTC_COUNTER_BITS) | counter;
+}
+
+uint64_t mono_time_us_get(void)
+{
+  return mono_time_ticks_to_us(mono_time_ticks_get());
+}
+
+void mono_time_overflow_trigger(void)
+{
+  nrf_rtc_task_trigger(MONO_TIME_RTC, NRF_RTC_TASK_TRIGGER_OVERFLOW);
+}
+
+void MONO_TIME_RTC_IRQHandler(void)
+{
+  // clear and count with interrupts masked, a reader preempting the handler
+  // in between would see neither the event nor the new count
+  CRITICAL_REGION_ENTER();
+  if(nrf_rtc_event_pending(MONO_TIME_RTC, NRF_RTC_EVENT_OVERFLOW))
+  {
+    nrf_rtc_event_clear(MONO_TIME_RTC, NRF_RTC_EVENT_OVERFLOW);
+    // read back so the event is cleared before the interrupt returns,
+    // otherwise the IRQ fires a second time
+    (void)nrf_rtc_event_pending(MONO_TIME_RTC, NRF_RTC_EVENT_OVERFLOW);
+    m_overflows++;
+  }
+  CRITICAL_REGION_EXIT();
+}
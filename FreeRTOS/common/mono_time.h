@@ -0,0 +1,83 @@
+/*
+  64-bit monotonic time service
+
+  The FreeRTOS tick (configTICK_SOURCE == FREERTOS_USE_RTC) runs RTC1 with a
+  prescaler of 31, so TickType_t only resolves 1/1024 s and wraps after about
+  48 days. This module runs a sibling RTC from the same 32.768 kHz LFCLK with
+  no prescaler and extends its 24-bit COUNTER with a software overflow count:
+
+    resolution  = 1 / 32768 s (~30.5 us)
+    wrap period = never (64-bit, ~17 million years)
+
+  The RTC keeps counting while the CPU sleeps in tickless idle, so timestamps
+  need no compensation after vPortSuppressTicksAndSleep() and never drift
+  against the kernel tick. Reads are lock-free and can be done from any task or
+  ISR, including ISRs above configMAX_SYSCALL_INTERRUPT_PRIORITY and code
+  running with interrupts disabled.
+
+  Cost: one RTC overflow interrupt every 512 s.
+*/
+
+#ifndef MONO_TIME_H
+#define MONO_TIME_H
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+// RTC instance used as time base, RTC0 is used by the SoftDevice and RTC1 by
+// the FreeRTOS tick
+#ifndef MONO_TIME_RTC
+#define MONO_TIME_RTC             NRF_RTC2
+#define MONO_TIME_RTC_IRQn        RTC2_IRQn
+#define MONO_TIME_RTC_IRQHandler  RTC2_IRQHandler
+#endif
+
+// priority of the overflow interrupt, it doesn't call any FreeRTOS API
+#ifndef MONO_TIME_IRQ_PRIORITY
+#define MONO_TIME_IRQ_PRIORITY    APP_IRQ_PRIORITY_LOW
+#endif
+
+#define MONO_TIME_TICKS_PER_SEC   32768UL
+
+/**
+ * @brief Start the time base. Call once from main() after nrf_drv_clock_init()
+ *
+ * @return NRF_SUCCESS or NRF_ERROR_INVALID_STATE if already started
+ */
+ret_code_t mono_time_init(void);
+
+/**
+ * @brief Read the 64-bit RTC tick count (1/32768 s), safe from any context
+ */
+uint64_t mono_time_ticks_get(void);
+
+/**
+ * @brief Read the time since mono_time_init() in microseconds, safe from any context
+ */
+uint64_t mono_time_us_get(void);
+
+/**
+ * @brief Convert RTC ticks to microseconds, rounded down
+ */
+static inline uint64_t mono_time_ticks_to_us(uint64_t ticks)
+{
+  // 1000000 / 32768 = 15625 / 512
+  return (ticks * 15625ULL) >> 9;
+}
+
+/**
+ * @brief Convert microseconds to RTC ticks, rounded up
+ */
+static inline uint64_t mono_time_us_to_ticks(uint64_t us)
+{
+  return ((us << 9) + 15624ULL) / 15625ULL;
+}
+
+/**
+ * @brief Force the RTC COUNTER to 0xFFFFF0 so the 24-bit wrap happens 16 ticks
+ *        later, used to exercise the overflow path without waiting 512 s.
+ *        Time stays monotonic but jumps forward, debug use only
+ */
+void mono_time_overflow_trigger(void);
+
+#endif /* MONO_TIME_H */
@@ -0,0 +1,152 @@
+/*
+  Mutex contention profiler, see mutex_prof.h
+*/
+
+#include "mutex_prof.h"
+
+#if MUTEX_PROF_ENABLED
+
+#include "task.h"
+#include "mono_time.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+static mutex_prof_t m_mutexes[MUTEX_PROF_MAX];
+static uint32_t m_count = 0;
+
+static inline uint32_t now(void)
+{
+  // differences of the low 32 bits are right for holds up to 36 hours
+  return (uint32_t)mono_time_ticks_get();
+}
+
+prof_mutex_t mutex_prof_create(const char* name)
+{
+  SemaphoreHandle_t handle;
+  mutex_prof_t* p_prof = NULL;
+
+  handle = xSemaphoreCreateMutex();
+  if(handle == NULL) return NULL;
+
+  taskENTER_CRITICAL();
+  if(m_count < MUTEX_PROF_MAX)
+  {
+    p_prof = &m_mutexes[m_count++];
+    memset(p_prof, 0, sizeof(*p_prof));
+    p_prof->handle = handle;
+    p_prof->name = name;
+  }
+  taskEXIT_CRITICAL();
+
+  if(p_prof == NULL) vSemaphoreDelete(handle);
+  return p_prof;
+}
+
+BaseType_t mutex_prof_take(prof_mutex_t mutex, TickType_t ticks_to_wait)
+{
+  // fast path, nobody holds it
+  if(xSemaphoreTake(mutex->handle, 0) == pdTRUE)
+  {
+    mutex->taken_at = now();
+    mutex->acquisitions++;
+    return pdTRUE;
+  }
+
+  uint32_t start = now();
+  bool inherits = false;
+
+  // blocking on a mutex held by a lower priority task makes the kernel raise
+  // the holder's priority to ours
+  TaskHandle_t holder = xSemaphoreGetMutexHolder(mutex->handle);
+  if(holder != NULL && uxTaskPriorityGet(holder) < uxTaskPriorityGet(NULL))
+  {
+    inherits = true;
+  }
+
+  if(xSemaphoreTake(mutex->handle, ticks_to_wait) != pdTRUE)
+  {
+    // not the holder, the counter update needs its own protection
+    taskENTER_CRITICAL();
+    mutex->timeouts++;
+    if(inherits) mutex->inheritances++;
+    taskEXIT_CRITICAL();
+    return pdFALSE;
+  }
+
+  // counters below are only written by the holder, the mutex protects them
+  uint32_t taken_at = now();
+  uint32_t wait = taken_at - start;
+
+  mutex->taken_at = taken_at;
+  mutex->acquisitions++;
+  mutex->contended++;
+  if(wait > mutex->wait_max) mutex->wait_max = wait;
+  if(inherits)
+  {
+    // a waiter that timed out may count one at the same time
+    taskENTER_CRITICAL();
+    mutex->inheritances++;
+    taskEXIT_CRITICAL();
+    if(wait > mutex->inversion_wait_max) mutex->inversion_wait_max = wait;
+  }
+
+  return pdTRUE;
+}
+
+BaseType_t mutex_prof_give(prof_mutex_t mutex)
+{
+  uint32_t hold = now() - mutex->taken_at;
+
+  mutex->hold_total += hold;
+  if(hold > mutex->hold_max) mutex->hold_max = hold;
+
+  return xSemaphoreGive(mutex->handle);
+}
+
+static inline uint32_t to_us(uint64_t ticks)
+{
+  return (uint32_t)mono_time_ticks_to_us(ticks);
+}
+
+void mutex_prof_print(void)
+{
+  mutex_prof_t snap;
+
+  printf("mutex    acquired contended timeout inherit hold max us  hold avg us  wait max us  inv max us\r\n");
+  for(uint32_t i = 0; i < m_count; i++)
+  {
+    // consistent copy, the holder may update it any time
+    taskENTER_CRITICAL();
+    snap = m_mutexes[i];
+    taskEXIT_CRITICAL();
+
+    uint64_t hold_avg = (snap.acquisitions > 0) ? snap.hold_total / snap.acquisitions : 0;
+    printf("%-8.8s %8u %9u %7u %7u %11u %12u %12u %11u\r\n",
+           snap.name,
+           (unsigned)snap.acquisitions, (unsigned)snap.contended,
+           (unsigned)snap.timeouts, (unsigned)snap.inheritances,
+           (unsigned)to_us(snap.hold_max), (unsigned)to_us(hold_avg),
+           (unsigned)to_us(snap.wait_max), (unsigned)to_us(snap.inversion_wait_max));
+  }
+}
+
+void mutex_prof_reset(void)
+{
+  taskENTER_CRITICAL();
+  for(uint32_t i = 0; i < m_count; i++)
+  {
+    mutex_prof_t* p_prof = &m_mutexes[i];
+    SemaphoreHandle_t handle = p_prof->handle;
+    const char* name = p_prof->name;
+    uint32_t taken_at = p_prof->taken_at;
+
+    memset(p_prof, 0, sizeof(*p_prof));
+    p_prof->handle = handle;
+    p_prof->name = name;
+    p_prof->taken_at = taken_at;
+  }
+  taskEXIT_CRITICAL();
+}
+
+#endif /* MUTEX_PROF_ENABLED */
@@ -0,0 +1,102 @@
+/*
+  Mutex contention profiler
+
+  Drop-in wrappers for xSemaphoreCreateMutex(), xSemaphoreTake() and
+  xSemaphoreGive(). With MUTEX_PROF_ENABLED set to 1 in FreeRTOSConfig.h
+  every profiled mutex keeps:
+
+  - acquisitions and contended acquisitions (mutex was held on entry)
+  - timeouts
+  - max and mean hold time
+  - max wait time
+  - priority inheritance events, a higher priority task blocking on a mutex
+    held by a lower priority task, and the longest such wait
+
+  Times come from mono_time (~30 us resolution, keeps counting in tickless
+  sleep), the project must build mono_time.c and call mono_time_init().
+  mutex_prof_print() dumps a table of all profiled mutexes.
+
+  With MUTEX_PROF_ENABLED 0 the wrappers are plain FreeRTOS calls.
+*/
+
+#ifndef MUTEX_PROF_H
+#define MUTEX_PROF_H
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include <stdint.h>
+
+#ifndef MUTEX_PROF_ENABLED
+#define MUTEX_PROF_ENABLED  0
+#endif
+
+// number of mutexes that can be profiled
+#ifndef MUTEX_PROF_MAX
+#define MUTEX_PROF_MAX      4
+#endif
+
+#if MUTEX_PROF_ENABLED
+
+#if INCLUDE_xSemaphoreGetMutexHolder != 1
+#error "MUTEX_PROF_ENABLED needs INCLUDE_xSemaphoreGetMutexHolder set to 1"
+#endif
+
+typedef struct
+{
+  SemaphoreHandle_t handle;
+  const char* name;
+  uint32_t taken_at;        // mono_time ticks when the holder got it
+  uint32_t acquisitions;
+  uint32_t contended;
+  uint32_t timeouts;
+  uint32_t inheritances;
+  uint32_t hold_max;        // all times in mono_time ticks
+  uint64_t hold_total;
+  uint32_t wait_max;
+  uint32_t inversion_wait_max;
+}mutex_prof_t;
+
+typedef mutex_prof_t* prof_mutex_t;
+
+/**
+ * @brief Create a mutex and register it for profiling
+ *
+ * @param name - shown in the table, must stay valid
+ *
+ * @return handle or NULL on insufficient heap memory or a full registry
+ */
+prof_mutex_t mutex_prof_create(const char* name);
+
+/**
+ * @brief xSemaphoreTake() with contention accounting
+ */
+BaseType_t mutex_prof_take(prof_mutex_t mutex, TickType_t ticks_to_wait);
+
+/**
+ * @brief xSemaphoreGive() with hold time accounting
+ */
+BaseType_t mutex_prof_give(prof_mutex_t mutex);
+
+/**
+ * @brief Print one row per profiled mutex with printf()
+ */
+void mutex_prof_print(void);
+
+/**
+ * @brief Zero the counters of all profiled mutexes
+ */
+void mutex_prof_reset(void);
+
+#else
+
+typedef SemaphoreHandle_t prof_mutex_t;
+
+#define mutex_prof_create(name)         xSemaphoreCreateMutex()
+#define mutex_prof_take(mutex, ticks)   xSemaphoreTake(mutex, ticks)
+#define mutex_prof_give(mutex)          xSemaphoreGive(mutex)
+#define mutex_prof_print()
+#define mutex_prof_reset()
+
+#endif /* MUTEX_PROF_ENABLED */
+
+#endif /* MUTEX_PROF_H */
@@ -0,0 +1,181 @@
+/*
+  Fixed-block pools for kernel objects, see obj_pool.h
+*/
+
+#include "obj_pool.h"
+#include "app_util_platform.h"
+#include <stdio.h>
+
+// the kernel objects are at the start of their block, so the handle the
+// xxxCreateStatic() functions return is the block address
+static inline void* block_storage(obj_pool_t const* p_pool, void* p_block)
+{
+  return (uint8_t*)p_block + p_pool->obj_size;
+}
+
+ret_code_t obj_pool_init(obj_pool_t const* p_pool)
+{
+  obj_pool_stats_t* p_stats = p_pool->p_stats;
+
+  p_stats->allocs = 0;
+  p_stats->frees = 0;
+  p_stats->failures = 0;
+  p_stats->in_use = 0;
+  p_stats->peak = 0;
+
+  return nrf_balloc_init(p_pool->p_balloc);
+}
+
+void* obj_pool_alloc(obj_pool_t const* p_pool)
+{
+  obj_pool_stats_t* p_stats = p_pool->p_stats;
+  void* p_block;
+
+  // nrf_balloc has its own critical region, this one keeps the counters in
+  // step with it
+  CRITICAL_REGION_ENTER();
+  p_block = nrf_balloc_alloc(p_pool->p_balloc);
+  if(p_block != NULL)
+  {
+    p_stats->allocs++;
+    p_stats->in_use++;
+    if(p_stats->in_use > p_stats->peak) p_stats->peak = p_stats->in_use;
+  }
+  else
+  {
+    p_stats->failures++;
+  }
+  CRITICAL_REGION_EXIT();
+
+  return p_block;
+}
+
+void obj_pool_free(obj_pool_t const* p_pool, void* p_block)
+{
+  obj_pool_stats_t* p_stats = p_pool->p_stats;
+
+  if(p_block == NULL) return;
+
+  CRITICAL_REGION_ENTER();
+  nrf_balloc_free(p_pool->p_balloc, p_block);
+  p_stats->frees++;
+  p_stats->in_use--;
+  CRITICAL_REGION_EXIT();
+}
+
+TaskHandle_t obj_pool_task_create(obj_pool_t const* p_pool, TaskFunction_t task_function,
+                                  const char* name, void* p_param, UBaseType_t priority)
+{
+  configASSERT(p_pool->obj_size == sizeof(StaticTask_t));
+
+  void* p_block = obj_pool_alloc(p_pool);
+  if(p_block == NULL) return NULL;
+
+  return xTaskCreateStatic(
+                            task_function,                                // pointer to the task function
+                            name,                                         // task name mainly for debugging
+                            p_pool->elem_count,                           // task stack depth in words
+                            p_param,                                      // task arguments
+                            priority,                                     // task priority
+                            (StackType_t*)block_storage(p_pool, p_block), // stack right after the TCB
+                            (StaticTask_t*)p_block                        // TCB at the start of the block
+                          );
+}
+
+void obj_pool_task_delete(obj_pool_t const* p_pool, TaskHandle_t task)
+{
+  // a task deleting itself keeps running on its stack until the idle task
+  // cleans it up, its block can't be reused before that
+  configASSERT(task != NULL && task != xTaskGetCurrentTaskHandle());
+
+  vTaskDelete(task);
+  obj_pool_free(p_pool, (void*)task);
+}
+
+QueueHandle_t obj_pool_queue_create(obj_pool_t const* p_pool)
+{
+  configASSERT(p_pool->obj_size == sizeof(StaticQueue_t));
+
+  void* p_block = obj_pool_alloc(p_pool);
+  if(p_block == NULL) return NULL;
+
+  return xQueueCreateStatic(p_pool->elem_count,
+                            p_pool->elem_size,
+                            (p_pool->elem_size != 0) ? (uint8_t*)block_storage(p_pool, p_block) : NULL,
+                            (StaticQueue_t*)p_block);
+}
+
+void obj_pool_queue_delete(obj_pool_t const* p_pool, QueueHandle_t queue)
+{
+  vQueueDelete(queue);
+  obj_pool_free(p_pool, (void*)queue);
+}
+
+MessageBufferHandle_t obj_pool_msg_buf_create(obj_pool_t const* p_pool)
+{
+  configASSERT(p_pool->obj_size == sizeof(StaticMessageBuffer_t));
+
+  void* p_block = obj_pool_alloc(p_pool);
+  if(p_block == NULL) return NULL;
+
+  return xMessageBufferCreateStatic(p_pool->elem_count,
+                                    (uint8_t*)block_storage(p_pool, p_block),
+                                    (StaticMessageBuffer_t*)p_block);
+}
+
+void obj_pool_msg_buf_delete(obj_pool_t const* p_pool, MessageBufferHandle_t buffer)
+{
+  vMessageBufferDelete(buffer);
+  obj_pool_free(p_pool, (void*)buffer);
+}
+
+void obj_pool_stats_get(obj_pool_t const* p_pool, obj_pool_stats_t* p_stats)
+{
+  CRITICAL_REGION_ENTER();
+  *p_stats = *p_pool->p_stats;
+  CRITICAL_REGION_EXIT();
+}
+
+void obj_pool_stats_print(obj_pool_t const* p_pool)
+{
+  obj_pool_stats_t stats;
+
+  obj_pool_stats_get(p_pool, &stats);
+  printf("Pool %s: %u x %u bytes, in use %u, peak %u, allocs %u, frees %u, failures %u\r\n",
+         p_pool->name,
+         (unsigned)p_pool->blocks,
+         (unsigned)(p_pool->obj_size + p_pool->elem_size * p_pool->elem_count),
+         (unsigned)stats.in_use,
+         (unsigned)stats.peak,
+         (unsigned)stats.allocs,
+         (unsigned)stats.frees,
+         (unsigned)stats.failures);
+}
+
+// with static allocation enabled the kernel asks the application for the
+// memory of the tasks it creates itself
+void vApplicationGetIdleTaskMemory(StaticTask_t** ppxIdleTaskTCBBuffer,
+                                   StackType_t** ppxIdleTaskStackBuffer,
+                                   uint32_t* pulIdleTaskStackSize)
+{
+  static StaticTask_t idle_tcb;
+  static StackType_t idle_stack[configMINIMAL_STACK_SIZE];
+
+  *ppxIdleTaskTCBBuffer = &idle_tcb;
+  *ppxIdleTaskStackBuffer = idle_stack;
+  *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+#if configUSE_TIMERS == 1
+void vApplicationGetTimerTaskMemory(StaticTask_t** ppxTimerTaskTCBBuffer,
+                                    StackType_t** ppxTimerTaskStackBuffer,
+                                    uint32_t* pulTimerTaskStackSize)
+{
+  static StaticTask_t timer_tcb;
+  static StackType_t timer_stack[configTIMER_TASK_STACK_DEPTH];
+
+  *ppxTimerTaskTCBBuffer = &timer_tcb;
+  *ppxTimerTaskStackBuffer = timer_stack;
+  *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+#endif
@@ -0,0 +1,176 @@
+/*
+  Fixed-block pools for kernel objects
+
+  Typed pools on top of nrf_balloc. A block holds one kernel object followed
+  by its storage and the object is made with the xxxCreateStatic() functions,
+  so tasks, queues and message buffers taken from a pool never touch the heap:
+
+  - OBJ_POOL_TASK_DEF: StaticTask_t + stack
+  - OBJ_POOL_QUEUE_DEF: StaticQueue_t + item storage
+  - OBJ_POOL_MSG_BUF_DEF: StaticMessageBuffer_t + buffer
+  - OBJ_POOL_DEF: plain blocks, e.g. messages passed by pointer in a queue
+
+  nrf_balloc keeps a stack of free block indexes, alloc and free are a pop
+  or a push in a critical region: O(1) and usable from interrupts. All
+  blocks of a pool have the same size so a pool can't fragment, an alloc
+  only fails when every block is in use.
+
+  - up to 255 blocks per pool (nrf_balloc limit)
+  - the pool memory is static data, the pool descriptors go to the
+    .nrf_balloc section of flash_placement.xml
+  - needs configSUPPORT_STATIC_ALLOCATION 1, this module then also supplies
+    the idle and timer task memory the kernel asks for
+  - a task can't give back its own block, delete it from another task
+*/
+
+#ifndef OBJ_POOL_H
+#define OBJ_POOL_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "message_buffer.h"
+#include "nrf_balloc.h"
+#include "sdk_errors.h"
+#include <stdint.h>
+
+#if configSUPPORT_STATIC_ALLOCATION != 1
+#error "obj_pool needs configSUPPORT_STATIC_ALLOCATION 1"
+#endif
+
+typedef struct
+{
+  uint32_t allocs;    // successful allocations
+  uint32_t frees;     // blocks given back
+  uint32_t failures;  // allocations refused, all blocks in use
+  uint16_t in_use;    // blocks allocated now
+  uint16_t peak;      // highest in_use since init
+}obj_pool_stats_t;
+
+typedef struct
+{
+  nrf_balloc_t const* p_balloc;
+  obj_pool_stats_t* p_stats;
+  const char* name;
+  uint16_t blocks;
+  uint16_t obj_size;    // kernel object at the start of a block, 0 for plain blocks
+  uint16_t elem_size;   // stack word, queue item or byte
+  uint16_t elem_count;  // stack depth, queue length or buffer bytes
+}obj_pool_t;
+
+// common part of the typed definitions below
+#define OBJ_POOL_DEF_(_name, _obj_size, _elem_size, _elem_count, _blocks)      \
+  NRF_BALLOC_DEF(_name##_balloc,                                              \
+                 (_obj_size) + (_elem_size) * (_elem_count), _blocks);         \
+  static obj_pool_stats_t _name##_stats;                                      \
+  static const obj_pool_t _name =                                             \
+  {                                                                           \
+    .p_balloc = &_name##_balloc,                                              \
+    .p_stats = &_name##_stats,                                                \
+    .name = #_name,                                                           \
+    .blocks = (_blocks),                                                      \
+    .obj_size = (_obj_size),                                                  \
+    .elem_size = (_elem_size),                                                \
+    .elem_count = (_elem_count)                                               \
+  }
+
+/**
+ * @brief Pool of plain blocks, for obj_pool_alloc() / obj_pool_free()
+ */
+#define OBJ_POOL_DEF(_name, _block_size, _blocks)                             \
+  OBJ_POOL_DEF_(_name, 0, 1, _block_size, _blocks)
+
+/**
+ * @brief Pool of tasks with the same stack depth, in words
+ */
+#define OBJ_POOL_TASK_DEF(_name, _stack_depth, _blocks)                       \
+  OBJ_POOL_DEF_(_name, sizeof(StaticTask_t), sizeof(StackType_t), _stack_depth, _blocks)
+
+/**
+ * @brief Pool of queues with the same length and item size
+ */
+#define OBJ_POOL_QUEUE_DEF(_name, _length, _item_size, _blocks)               \
+  OBJ_POOL_DEF_(_name, sizeof(StaticQueue_t), _item_size, _length, _blocks)
+
+/**
+ * @brief Pool of message buffers with the same size in bytes
+ */
+#define OBJ_POOL_MSG_BUF_DEF(_name, _buffer_size, _blocks)                    \
+  OBJ_POOL_DEF_(_name, sizeof(StaticMessageBuffer_t), 1, _buffer_size, _blocks)
+
+/**
+ * @brief Prepare a pool, all blocks free and statistics cleared
+ *
+ * @return NRF_SUCCESS or the nrf_balloc_init() error
+ */
+ret_code_t obj_pool_init(obj_pool_t const* p_pool);
+
+/**
+ * @brief Take a block, any context
+ *
+ * @return block or NULL if all blocks are in use
+ */
+void* obj_pool_alloc(obj_pool_t const* p_pool);
+
+/**
+ * @brief Give back a block taken from the same pool, any context
+ */
+void obj_pool_free(obj_pool_t const* p_pool, void* p_block);
+
+/**
+ * @brief Create a task in a block of an OBJ_POOL_TASK_DEF pool
+ *
+ * @param p_pool        - task pool, gives the stack depth
+ * @param task_function - pointer to the task function
+ * @param name          - task name mainly for debugging
+ * @param p_param       - task arguments
+ * @param priority      - task priority
+ *
+ * @return task handle or NULL if the pool is empty
+ */
+TaskHandle_t obj_pool_task_create(obj_pool_t const* p_pool, TaskFunction_t task_function,
+                                  const char* name, void* p_param, UBaseType_t priority);
+
+/**
+ * @brief Delete a task of the pool and give back its block, not from the
+ *        task itself
+ */
+void obj_pool_task_delete(obj_pool_t const* p_pool, TaskHandle_t task);
+
+/**
+ * @brief Create a queue in a block of an OBJ_POOL_QUEUE_DEF pool
+ *
+ * @return queue handle or NULL if the pool is empty
+ */
+QueueHandle_t obj_pool_queue_create(obj_pool_t const* p_pool);
+
+/**
+ * @brief Delete a queue of the pool and give back its block, no task may be
+ *        blocked on it
+ */
+void obj_pool_queue_delete(obj_pool_t const* p_pool, QueueHandle_t queue);
+
+/**
+ * @brief Create a message buffer in a block of an OBJ_POOL_MSG_BUF_DEF pool
+ *
+ * @return message buffer handle or NULL if the pool is empty
+ */
+MessageBufferHandle_t obj_pool_msg_buf_create(obj_pool_t const* p_pool);
+
+/**
+ * @brief Delete a message buffer of the pool and give back its block, no
+ *        task may be blocked on it
+ */
+void obj_pool_msg_buf_delete(obj_pool_t const* p_pool, MessageBufferHandle_t buffer);
+
+/**
+ * @brief Consistent copy of the pool statistics
+ */
+void obj_pool_stats_get(obj_pool_t const* p_pool, obj_pool_stats_t* p_stats);
+
+/**
+ * @brief Print the pool statistics with printf()
+ */
+void obj_pool_stats_print(obj_pool_t const* p_pool);
+
+#endif /* OBJ_POOL_H */
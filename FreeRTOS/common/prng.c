@@ -0,0 +1,24 @@
+/*
+  Per-task pseudo random number generator, see prng.h
+*/
+
+#include "prng.h"
+#include "rng_entropy.h"
+
+void prng_seed(prng_t* p_prng, uint64_t seed, uint64_t stream)
+{
+  // reference pcg32_srandom_r() sequence
+  p_prng->state = 0;
+  p_prng->inc = (stream << 1) | 1;
+  (void)prng_next(p_prng);
+  p_prng->state += seed;
+  (void)prng_next(p_prng);
+}
+
+void prng_seed_from_entropy(prng_t* p_prng)
+{
+  uint64_t seed[2];
+
+  rng_entropy_read_blocking(seed, sizeof(seed));
+  prng_seed(p_prng, seed[0], seed[1]);
+}
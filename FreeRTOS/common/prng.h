@@ -0,0 +1,76 @@
+/*
+  Per-task pseudo random number generator
+
+  PCG32 (O'Neill, pcg-random.org): 64-bit LCG state, 32-bit output through
+  a xorshift and a random rotation. Passes the TestU01 and PractRand suites,
+  one 64-bit multiply and a few shifts per number.
+
+  Every task keeps its own prng_t, usually on its stack, so there is no
+  shared state and no locking, unlike rand() that shares one state among
+  all tasks with configUSE_NEWLIB_REENTRANT 0. Two tasks seeded from the
+  entropy pool also get different streams.
+
+  Not for keys or nonces, the output is predictable from a few numbers.
+  Use rng_entropy.h for those.
+*/
+
+#ifndef PRNG_H
+#define PRNG_H
+
+#include <stdint.h>
+
+typedef struct
+{
+  uint64_t state;
+  uint64_t inc;     // stream selector, always odd
+}prng_t;
+
+/**
+ * @brief Seed with known values, same seed and stream give the same numbers
+ */
+void prng_seed(prng_t* p_prng, uint64_t seed, uint64_t stream);
+
+/**
+ * @brief Seed and stream from the entropy pool, may block until the pool has
+ *        16 bytes, task context only. Needs rng_entropy_init().
+ */
+void prng_seed_from_entropy(prng_t* p_prng);
+
+/**
+ * @brief Next 32-bit number
+ */
+static inline uint32_t prng_next(prng_t* p_prng)
+{
+  uint64_t old = p_prng->state;
+  p_prng->state = old * 6364136223846793005ULL + p_prng->inc;
+
+  uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+  uint32_t rot = (uint32_t)(old >> 59);
+  return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+/**
+ * @brief Number in [0, bound), without the bias of prng_next() % bound,
+ *        bound not 0
+ *
+ * Multiply and shift (Lemire), retried only when the low part of the product
+ * falls in the biased zone, at most bound / 2^32 of the time.
+ */
+static inline uint32_t prng_range(prng_t* p_prng, uint32_t bound)
+{
+  uint64_t m = (uint64_t)prng_next(p_prng) * bound;
+  uint32_t low = (uint32_t)m;
+
+  if(low < bound)
+  {
+    uint32_t threshold = -bound % bound;
+    while(low < threshold)
+    {
+      m = (uint64_t)prng_next(p_prng) * bound;
+      low = (uint32_t)m;
+    }
+  }
+  return (uint32_t)(m >> 32);
+}
+
+#endif /* PRNG_H */
@@ -0,0 +1,125 @@
+/*
+  Power-down of the RAM sections nobody uses, see ram_power.h
+*/
+
+#include "ram_power.h"
+#include "heap_tlsf.h"
+#include "nrf.h"
+#include <stdio.h>
+
+#if RAM_POWER_ENABLED
+
+#if !HEAP_TLSF_LINKER_REGIONS
+#error "ram_power needs the heap over all free RAM, HEAP_TLSF_LINKER_REGIONS 1"
+#endif
+
+#define RAM_START             0x20000000UL
+#define RAM_SIZE              (256UL * 1024)
+
+// RAM0 to RAM7
+#define SMALL_BANKS           8
+#define SMALL_SECTIONS        2
+#define SMALL_SECTION_SIZE    0x1000UL
+
+// RAM8
+#define BIG_BANK              8
+#define BIG_SECTIONS          6
+#define BIG_SECTION_SIZE      0x8000UL
+
+#define SECTION_COUNT         (SMALL_BANKS * SMALL_SECTIONS + BIG_SECTIONS)
+
+// both bits of a section in RAM[n].POWER, the retention bits are 16 higher
+#define SECTION_BITS(s)       ((1UL << (s)) | (1UL << ((s) + 16)))
+
+// flash_placement.xml
+extern uint8_t __ram_free_start[];
+extern uint8_t __StackLimit[];
+
+typedef struct
+{
+  uint32_t start;
+  uint32_t size;
+  uint8_t bank;
+  uint8_t section;
+}ram_section_t;
+
+static void section_get(uint32_t index, ram_section_t* p_section)
+{
+  if(index < SMALL_BANKS * SMALL_SECTIONS)
+  {
+    p_section->start = RAM_START + index * SMALL_SECTION_SIZE;
+    p_section->size = SMALL_SECTION_SIZE;
+    p_section->bank = index / SMALL_SECTIONS;
+    p_section->section = index % SMALL_SECTIONS;
+  }
+  else
+  {
+    index -= SMALL_BANKS * SMALL_SECTIONS;
+    p_section->start = RAM_START + SMALL_BANKS * SMALL_SECTIONS * SMALL_SECTION_SIZE + index * BIG_SECTION_SIZE;
+    p_section->size = BIG_SECTION_SIZE;
+    p_section->bank = BIG_BANK;
+    p_section->section = index;
+  }
+}
+
+size_t ram_power_apply(void)
+{
+  ram_section_t section;
+  uint32_t line;
+  uint32_t stack_limit = (uint32_t)(uintptr_t)__StackLimit;
+  uint32_t high_water = (uint32_t)(uintptr_t)heap_tlsf_high_water();
+  size_t off_bytes = 0;
+  uint32_t off_count = 0;
+
+  if(NRF_FICR->INFO.RAM * 1024UL != RAM_SIZE)
+  {
+    printf("RAM power: not an nRF52840 RAM layout, nothing switched off\r\n");
+    return 0;
+  }
+
+  // nothing allocated yet, the heap starts right after the static data
+  if(high_water < (uint32_t)(uintptr_t)__ram_free_start) high_water = (uint32_t)(uintptr_t)__ram_free_start;
+  line = high_water + RAM_POWER_HEAP_RESERVE;
+
+  // the heap keeps the rest of the section the line falls in
+  for(uint32_t i = 0; i < SECTION_COUNT; i++)
+  {
+    section_get(i, &section);
+    if(line <= section.start) break;
+    if(line < section.start + section.size)
+    {
+      line = section.start + section.size;
+      break;
+    }
+  }
+
+  if(line >= stack_limit || heap_tlsf_cap((void*)(uintptr_t)line) == 0)
+  {
+    printf("RAM power: heap needs all RAM up to the main stack, nothing switched off\r\n");
+    return 0;
+  }
+
+  for(uint32_t i = 0; i < SECTION_COUNT; i++)
+  {
+    section_get(i, &section);
+    if(section.start < line || section.start + section.size > stack_limit) continue;
+
+    NRF_POWER->RAM[section.bank].POWERCLR = SECTION_BITS(section.section);
+    off_bytes += section.size;
+    off_count++;
+  }
+
+  // powered sections draw their share of the RAM retention current
+  uint32_t saved_na = (uint32_t)((uint64_t)off_bytes * (RAM_POWER_ION_RAMON_RTC_NA - RAM_POWER_ION_RAMOFF_RTC_NA) / RAM_SIZE);
+
+  printf("RAM power: heap high water 0x%08x, capped at 0x%08x\r\n", (unsigned)high_water, (unsigned)line);
+  printf("  %u sections off, %u KB of %u KB\r\n",
+         (unsigned)off_count, (unsigned)(off_bytes / 1024), (unsigned)(RAM_SIZE / 1024));
+  // typical values of the Product Specification, not measured on this board
+  printf("  sleep current %u nA -> %u nA expected from datasheet typicals, not measured\r\n",
+         (unsigned)RAM_POWER_ION_RAMON_RTC_NA, (unsigned)(RAM_POWER_ION_RAMON_RTC_NA - saved_na));
+
+  return off_bytes;
+}
+
+#endif /* RAM_POWER_ENABLED */
@@ -0,0 +1,75 @@
+/*
+  Power-down of the RAM sections nobody uses
+
+  The nRF52840 RAM is 9 banks, RAM0 to RAM7 with 2 sections of 4 KB and
+  RAM8 with 6 sections of 32 KB. Every powered section adds to the System ON
+  sleep current whether it holds data or not, and these examples use a few
+  KB of the 256 KB.
+
+  ram_power_apply() runs once from app_diag_before_scheduler(), after the
+  example created its tasks and queues and before vTaskStartScheduler():
+
+  - the line is the heap high water (heap_tlsf_high_water()) plus
+    RAM_POWER_HEAP_RESERVE, rounded up to the next section boundary
+  - the heap is capped at the line with heap_tlsf_cap()
+  - every section between the line and the main stack (__StackLimit of
+    flash_placement.xml) is switched off, power and retention
+  - the sections switched off and the expected sleep current saving are
+    printed
+
+  Static data (below __ram_free_start) and the main stack stay powered.
+  RAM_POWER_HEAP_RESERVE is what the heap can still grow by once the
+  scheduler runs: idle and timer task, tasks created by other tasks. It
+  defaults to configTOTAL_HEAP_SIZE, which each example sized for its
+  needs and which the heap itself ignores with HEAP_TLSF_LINKER_REGIONS.
+
+  The saving uses the typical sleep currents of the nRF52840 Product
+  Specification v1.1 (RAM_POWER_ION_RAMON_RTC_NA, RAM_POWER_ION_RAMOFF_RTC_NA),
+  spread evenly over the 256 KB.
+
+  With RAM_POWER_ENABLED 0, the default, ram_power_apply() does nothing.
+  blinky_freertos enables it. Once applied the heap cannot grow past the
+  line, so enable it only where RAM_POWER_HEAP_RESERVE covers all later
+  allocations.
+*/
+
+#ifndef RAM_POWER_H
+#define RAM_POWER_H
+
+#include "FreeRTOS.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef RAM_POWER_ENABLED
+#define RAM_POWER_ENABLED             0
+#endif
+
+#ifndef RAM_POWER_HEAP_RESERVE
+#define RAM_POWER_HEAP_RESERVE        configTOTAL_HEAP_SIZE
+#endif
+
+// System ON, RTC running, full 256 KB retained / no RAM retained, in nA
+#ifndef RAM_POWER_ION_RAMON_RTC_NA
+#define RAM_POWER_ION_RAMON_RTC_NA    3160
+#endif
+
+#ifndef RAM_POWER_ION_RAMOFF_RTC_NA
+#define RAM_POWER_ION_RAMOFF_RTC_NA   1500
+#endif
+
+#if RAM_POWER_ENABLED
+
+/**
+ * @brief Cap the heap and switch off the sections above it, print a report
+ *
+ * @return bytes of RAM switched off
+ */
+size_t ram_power_apply(void);
+
+#else
+
+#define ram_power_apply()             0
+
+#endif /* RAM_POWER_ENABLED */
+
+#endif /* RAM_POWER_H */
@@ -0,0 +1,121 @@
+/*
+  Entropy pool fed by the RNG peripheral, see rng_entropy.h
+*/
+
+#include "rng_entropy.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "app_util_platform.h"
+#include "nrf.h"
+#include <stdbool.h>
+
+#define POOL_MASK (RNG_ENTROPY_POOL_SIZE - 1)
+
+#if (RNG_ENTROPY_POOL_SIZE & POOL_MASK) != 0
+#error "RNG_ENTROPY_POOL_SIZE must be a power of 2"
+#endif
+
+static uint8_t m_pool[RNG_ENTROPY_POOL_SIZE];
+
+// free running indexes, head moved by the interrupt, tail by the readers
+// inside the critical section
+static volatile uint32_t m_head = 0;
+static volatile uint32_t m_tail = 0;
+
+static bool m_started = false;
+
+static inline void rng_start(void)
+{
+  NRF_RNG->TASKS_START = 1;
+}
+
+void RNG_IRQHandler(void)
+{
+  if(NRF_RNG->EVENTS_VALRDY)
+  {
+    NRF_RNG->EVENTS_VALRDY = 0;
+    // read back so the event is cleared before the interrupt returns
+    (void)NRF_RNG->EVENTS_VALRDY;
+
+    // a value can still arrive right after the stop, never overwrite
+    // unread bytes with it
+    if(m_head - m_tail < RNG_ENTROPY_POOL_SIZE)
+    {
+      m_pool[m_head & POOL_MASK] = (uint8_t)NRF_RNG->VALUE;
+      m_head++;
+    }
+
+    if(m_head - m_tail == RNG_ENTROPY_POOL_SIZE)
+    {
+      // full, restarted by the next read
+      NRF_RNG->TASKS_STOP = 1;
+    }
+  }
+}
+
+ret_code_t rng_entropy_init(void)
+{
+  if(m_started) return NRF_ERROR_INVALID_STATE;
+
+  NRF_RNG->TASKS_STOP = 1;
+  NRF_RNG->CONFIG = RNG_CONFIG_DERCEN_Enabled << RNG_CONFIG_DERCEN_Pos;
+  NRF_RNG->SHORTS = 0;
+  NRF_RNG->EVENTS_VALRDY = 0;
+  NRF_RNG->INTENSET = RNG_INTENSET_VALRDY_Msk;
+
+  NVIC_SetPriority(RNG_IRQn, RNG_ENTROPY_IRQ_PRIORITY);
+  NVIC_ClearPendingIRQ(RNG_IRQn);
+  NVIC_EnableIRQ(RNG_IRQn);
+
+  m_head = 0;
+  m_tail = 0;
+  m_started = true;
+  rng_start();
+
+  return NRF_SUCCESS;
+}
+
+size_t rng_entropy_read(void* p_buf, size_t len)
+{
+  uint8_t* p_out = p_buf;
+  size_t count = 0;
+  UBaseType_t isr_state = 0;
+  bool isr = (__get_IPSR() != 0);
+
+  if(isr) isr_state = taskENTER_CRITICAL_FROM_ISR();
+  else    taskENTER_CRITICAL();
+
+  // every byte leaves the pool once, two readers never get the same bytes
+  while(count < len && m_tail != m_head)
+  {
+    p_out[count++] = m_pool[m_tail & POOL_MASK];
+    m_tail++;
+  }
+
+  if(count > 0) rng_start();
+
+  if(isr) taskEXIT_CRITICAL_FROM_ISR(isr_state);
+  else    taskEXIT_CRITICAL();
+
+  return count;
+}
+
+void rng_entropy_read_blocking(void* p_buf, size_t len)
+{
+  uint8_t* p_out = p_buf;
+
+  while(len > 0)
+  {
+    size_t count = rng_entropy_read(p_out, len);
+    p_out += count;
+    len -= count;
+
+    // ~120 us per byte, a tick refills 8 of them
+    if(len > 0) vTaskDelay(1);
+  }
+}
+
+size_t rng_entropy_available(void)
+{
+  return m_head - m_tail;
+}
@@ -0,0 +1,58 @@
+/*
+  Entropy pool fed by the RNG peripheral
+
+  The RNG interrupt moves one byte at a time into a small ring buffer with
+  the bias correction on, ~120 us per byte. When the pool is full the RNG
+  stops and draws no more current until a read makes room again, so the pool
+  is normally full and a seed is read at once.
+
+  Meant for seeding (prng.h), keys and nonces. It is far too slow to be the
+  random source of a loop, use a prng_t for that.
+
+  Reads are safe from any task and from interrupts up to
+  configMAX_SYSCALL_INTERRUPT_PRIORITY.
+*/
+
+#ifndef RNG_ENTROPY_H
+#define RNG_ENTROPY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+// pool size in bytes, power of 2
+#ifndef RNG_ENTROPY_POOL_SIZE
+#define RNG_ENTROPY_POOL_SIZE     64
+#endif
+
+// the interrupt doesn't call any FreeRTOS API
+#ifndef RNG_ENTROPY_IRQ_PRIORITY
+#define RNG_ENTROPY_IRQ_PRIORITY  APP_IRQ_PRIORITY_LOWEST
+#endif
+
+/**
+ * @brief Start filling the pool, call once from main()
+ *
+ * @return NRF_SUCCESS or NRF_ERROR_INVALID_STATE if already started
+ */
+ret_code_t rng_entropy_init(void);
+
+/**
+ * @brief Copy pool bytes without waiting
+ *
+ * @return number of bytes copied, less than len when the pool runs dry
+ */
+size_t rng_entropy_read(void* p_buf, size_t len);
+
+/**
+ * @brief Copy len pool bytes, blocking the calling task while the pool
+ *        refills, task context only
+ */
+void rng_entropy_read_blocking(void* p_buf, size_t len);
+
+/**
+ * @brief Bytes currently in the pool
+ */
+size_t rng_entropy_available(void);
+
+#endif /* RNG_ENTROPY_H */
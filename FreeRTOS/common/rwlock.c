@@ -0,0 +1,117 @@
+/*
+  Reader-writer lock with writer preference, see rwlock.h
+*/
+
+#include "rwlock.h"
+#include "task.h"
+
+BaseType_t rwlock_init(rwlock_t* p_lock)
+{
+  p_lock->readers = 0;
+  p_lock->writers = 0;
+  p_lock->draining = false;
+
+  p_lock->writer_mutex = xSemaphoreCreateMutex();
+  if(p_lock->writer_mutex == NULL) return pdFAIL;
+
+  p_lock->drained = xSemaphoreCreateBinary();
+  if(p_lock->drained == NULL)
+  {
+    vSemaphoreDelete(p_lock->writer_mutex);
+    return pdFAIL;
+  }
+
+  return pdPASS;
+}
+
+BaseType_t rwlock_read_lock(rwlock_t* p_lock, TickType_t ticks_to_wait)
+{
+  // fast path, no writer inside or waiting
+  taskENTER_CRITICAL();
+  if(p_lock->writers == 0)
+  {
+    p_lock->readers++;
+    taskEXIT_CRITICAL();
+    return pdTRUE;
+  }
+  taskEXIT_CRITICAL();
+
+  // queue behind the writer on its mutex, the kernel lends the writer our
+  // priority while we wait
+  if(xSemaphoreTake(p_lock->writer_mutex, ticks_to_wait) != pdTRUE) return pdFALSE;
+
+  taskENTER_CRITICAL();
+  p_lock->readers++;
+  taskEXIT_CRITICAL();
+
+  xSemaphoreGive(p_lock->writer_mutex);
+  return pdTRUE;
+}
+
+void rwlock_read_unlock(rwlock_t* p_lock)
+{
+  bool wake_writer;
+
+  taskENTER_CRITICAL();
+  p_lock->readers--;
+  wake_writer = (p_lock->readers == 0) && p_lock->draining;
+  if(wake_writer) p_lock->draining = false;
+  taskEXIT_CRITICAL();
+
+  if(wake_writer) xSemaphoreGive(p_lock->drained);
+}
+
+BaseType_t rwlock_write_lock(rwlock_t* p_lock, TickType_t ticks_to_wait)
+{
+  TimeOut_t timeout;
+  vTaskSetTimeOutState(&timeout);
+
+  // from here on new readers take the slow path
+  taskENTER_CRITICAL();
+  p_lock->writers++;
+  taskEXIT_CRITICAL();
+
+  if(xSemaphoreTake(p_lock->writer_mutex, ticks_to_wait) != pdTRUE)
+  {
+    taskENTER_CRITICAL();
+    p_lock->writers--;
+    taskEXIT_CRITICAL();
+    return pdFALSE;
+  }
+
+  // wait for readers already inside, re-check after every wake up since a
+  // give left behind by an earlier timed out writer may still be pending
+  while(true)
+  {
+    taskENTER_CRITICAL();
+    if(p_lock->readers == 0)
+    {
+      p_lock->draining = false;
+      taskEXIT_CRITICAL();
+      return pdTRUE;
+    }
+    p_lock->draining = true;
+    taskEXIT_CRITICAL();
+
+    if(xTaskCheckForTimeOut(&timeout, &ticks_to_wait) == pdTRUE ||
+       xSemaphoreTake(p_lock->drained, ticks_to_wait) != pdTRUE)
+    {
+      taskENTER_CRITICAL();
+      p_lock->draining = false;
+      p_lock->writers--;
+      taskEXIT_CRITICAL();
+      xSemaphoreGive(p_lock->writer_mutex);
+      return pdFALSE;
+    }
+  }
+}
+
+void rwlock_write_unlock(rwlock_t* p_lock)
+{
+  // a queued writer keeps the count above 0, readers stay behind it
+  taskENTER_CRITICAL();
+  p_lock->writers--;
+  taskEXIT_CRITICAL();
+
+  xSemaphoreGive(p_lock->writer_mutex);
+}
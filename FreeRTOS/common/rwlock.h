@@ -0,0 +1,67 @@
+/*
+  Reader-writer lock with writer preference
+
+  Any number of readers share the lock, a writer gets it alone. Once a writer
+  asks for the lock new readers queue behind it, so a steady stream of
+  readers can't starve writers.
+
+  The writer side is built on a FreeRTOS mutex: readers and writers that have
+  to wait for a writer block on that mutex, so the kernel raises the writer's
+  priority to the highest waiter, the same priority inheritance a plain mutex
+  gives. A writer waiting for active readers to leave does not boost them.
+
+  - the read fast path is one short critical section, no kernel call
+  - not recursive, taking the write lock while holding the read lock of the
+    same rwlock deadlocks
+  - task context only
+*/
+
+#ifndef RWLOCK_H
+#define RWLOCK_H
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct
+{
+  SemaphoreHandle_t writer_mutex; // held by the active writer or the next one
+  SemaphoreHandle_t drained;      // given by the last reader to a draining writer
+  volatile uint32_t readers;      // readers inside
+  volatile uint32_t writers;      // writers inside or waiting
+  volatile bool draining;         // the writer waits for readers to leave
+}rwlock_t;
+
+/**
+ * @brief Create the kernel objects of a lock
+ *
+ * @return pdPASS or pdFAIL on insufficient heap memory
+ */
+BaseType_t rwlock_init(rwlock_t* p_lock);
+
+/**
+ * @brief Take the lock shared
+ *
+ * @return pdTRUE or pdFALSE on timeout
+ */
+BaseType_t rwlock_read_lock(rwlock_t* p_lock, TickType_t ticks_to_wait);
+
+/**
+ * @brief Release a shared lock
+ */
+void rwlock_read_unlock(rwlock_t* p_lock);
+
+/**
+ * @brief Take the lock exclusive, waits for readers inside to leave
+ *
+ * @return pdTRUE or pdFALSE on timeout
+ */
+BaseType_t rwlock_write_lock(rwlock_t* p_lock, TickType_t ticks_to_wait);
+
+/**
+ * @brief Release an exclusive lock
+ */
+void rwlock_write_unlock(rwlock_t* p_lock);
+
+#endif /* RWLOCK_H */
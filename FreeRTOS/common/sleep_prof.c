@@ -0,0 +1,257 @@
+/*
+  Tickless idle sleep profiler, see sleep_prof.h
+*/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "sleep_prof.h"
+#include "nrf.h"
+#include "nrf_rtc.h"
+#include <stdio.h>
+#include <string.h>
+
+#if SLEEP_PROF_ENABLED
+
+#if (configUSE_TICKLESS_IDLE != 1) || (configTICK_SOURCE != FREERTOS_USE_RTC)
+#error "sleep_prof.c needs configUSE_TICKLESS_IDLE 1 with the RTC tick source"
+#endif
+
+// tick source of the nRF5 port, see xPortSysTickHandler in FreeRTOSConfig.h
+#define TICK_RTC          NRF_RTC1
+#define TICK_RTC_IRQn     RTC1_IRQn
+
+// RTC COUNTER is 24 bits wide
+#define COUNTER_MASK      0x00ffffffUL
+
+// IRQs covered by NVIC->ISPR[0] and ISPR[1]
+#define IRQ_COUNT         64
+
+typedef enum
+{
+  WAKE_TICK,
+  WAKE_TIMER,
+  WAKE_GPIOTE,
+  WAKE_OTHER,
+  WAKE_NONE,        // nothing pending, an event without interrupt
+  WAKE_SOURCES
+}wake_source_t;
+
+static const char* const k_source_names[WAKE_SOURCES] =
+{
+  "tick", "timer", "gpiote", "other", "none"
+};
+
+typedef struct
+{
+  void* task;
+  char name[configMAX_TASK_NAME_LEN];
+  uint32_t wakes;
+}task_wakes_t;
+
+typedef struct
+{
+  uint32_t sleeps;
+  uint32_t asleep_ticks;
+  uint32_t awake_ticks;
+  uint32_t requested_ticks;
+  uint32_t actual[WAKE_SOURCES][SLEEP_PROF_BUCKETS];
+  uint32_t requested[SLEEP_PROF_BUCKETS];
+  uint32_t irq_wakes[IRQ_COUNT];
+  task_wakes_t tasks[SLEEP_PROF_TASKS];
+  uint32_t other_task_wakes;    // tasks beyond SLEEP_PROF_TASKS
+  uint32_t no_task_wakes;
+}profile_t;
+
+static profile_t m_profile;
+
+static uint32_t m_enter;            // RTC1 COUNTER at the start of the sleep
+static uint32_t m_exit;             // and at the end of the last one
+static bool m_exit_valid = false;
+static bool m_wake_pending = false; // no task made ready since the last wake
+
+// bucket 0 for 0 ticks, bucket n for 2^(n-1) to 2^n - 1 ticks
+static uint32_t bucket_get(uint32_t ticks)
+{
+  uint32_t bucket = (ticks == 0) ? 0 : 32 - (uint32_t)__builtin_clz(ticks);
+
+  return (bucket < SLEEP_PROF_BUCKETS) ? bucket : SLEEP_PROF_BUCKETS - 1;
+}
+
+static wake_source_t source_get(IRQn_Type irq)
+{
+  switch(irq)
+  {
+    case RTC1_IRQn:
+      return WAKE_TICK;
+
+    case TIMER0_IRQn:
+    case TIMER1_IRQn:
+    case TIMER2_IRQn:
+    case TIMER3_IRQn:
+    case TIMER4_IRQn:
+    case RTC0_IRQn:
+    case RTC2_IRQn:
+      return WAKE_TIMER;
+
+    case GPIOTE_IRQn:
+      return WAKE_GPIOTE;
+
+    default:
+      return WAKE_OTHER;
+  }
+}
+
+// lowest pending IRQ other than the tick, -1 if none
+static int32_t pending_irq_get(void)
+{
+  for(uint32_t i = 0; i < 2; i++)
+  {
+    uint32_t pending = NVIC->ISPR[i];
+
+    if(i == (uint32_t)TICK_RTC_IRQn / 32) pending &= ~(1UL << ((uint32_t)TICK_RTC_IRQn % 32));
+    if(pending != 0) return (int32_t)(i * 32 + (uint32_t)__builtin_ctz(pending));
+  }
+  return -1;
+}
+
+void sleep_prof_pre(uint32_t expected_ticks)
+{
+  m_enter = nrf_rtc_counter_get(TICK_RTC);
+  if(m_exit_valid) m_profile.awake_ticks += (m_enter - m_exit) & COUNTER_MASK;
+
+  // the last wake made no task ready
+  if(m_wake_pending)
+  {
+    m_profile.no_task_wakes++;
+    m_wake_pending = false;
+  }
+}
+
+void sleep_prof_post(uint32_t expected_ticks)
+{
+  int32_t irq = -1;
+  wake_source_t source;
+  uint32_t actual;
+
+  m_exit = nrf_rtc_counter_get(TICK_RTC);
+  m_exit_valid = true;
+  actual = (m_exit - m_enter) & COUNTER_MASK;
+
+  // an early wake comes from another interrupt, even if COMPARE0 got
+  // pending meanwhile
+  if(actual < expected_ticks) irq = pending_irq_get();
+  if(irq < 0 && NVIC_GetPendingIRQ(TICK_RTC_IRQn)) irq = TICK_RTC_IRQn;
+  if(irq < 0) irq = pending_irq_get();
+
+  source = (irq < 0) ? WAKE_NONE : source_get((IRQn_Type)irq);
+  if(irq >= 0) m_profile.irq_wakes[irq]++;
+
+  m_profile.sleeps++;
+  m_profile.asleep_ticks += actual;
+  m_profile.requested_ticks += expected_ticks;
+  m_profile.actual[source][bucket_get(actual)]++;
+  m_profile.requested[bucket_get(expected_ticks)]++;
+  m_wake_pending = true;
+}
+
+void sleep_prof_task_ready(void* task)
+{
+  uint32_t i;
+
+  if(!m_wake_pending) return;
+  m_wake_pending = false;
+
+  for(i = 0; i < SLEEP_PROF_TASKS; i++)
+  {
+    if(m_profile.tasks[i].task == task) break;
+    if(m_profile.tasks[i].task == NULL)
+    {
+      // the name is kept, the task may be deleted before the report
+      m_profile.tasks[i].task = task;
+      strncpy(m_profile.tasks[i].name, pcTaskGetName((TaskHandle_t)task), configMAX_TASK_NAME_LEN);
+      break;
+    }
+  }
+
+  if(i < SLEEP_PROF_TASKS) m_profile.tasks[i].wakes++;
+  else m_profile.other_task_wakes++;
+}
+
+static void histogram_print(const char* name, const uint32_t* p_counts)
+{
+  printf("%-9s", name);
+  for(uint32_t i = 0; i < SLEEP_PROF_BUCKETS; i++) printf(" %6u", (unsigned)p_counts[i]);
+  printf("\r\n");
+}
+
+void sleep_prof_report(void)
+{
+  // too big for the stack of the report task
+  static profile_t profile;
+  uint32_t total;
+
+  taskENTER_CRITICAL();
+  profile = m_profile;
+  memset(&m_profile, 0, sizeof(m_profile));
+  taskEXIT_CRITICAL();
+
+  total = profile.asleep_ticks + profile.awake_ticks;
+  printf("\r\nSleep profile, %u sleeps, asleep %u of %u ticks (%u%%), requested %u\r\n",
+         (unsigned)profile.sleeps, (unsigned)profile.asleep_ticks, (unsigned)total,
+         (unsigned)((total == 0) ? 0 : (uint64_t)profile.asleep_ticks * 100 / total),
+         (unsigned)profile.requested_ticks);
+
+  // every sleep ends in a wake, in 1/100 per second
+  uint32_t wakes = (total == 0) ? 0 : (uint32_t)((uint64_t)profile.sleeps * configTICK_RATE_HZ * 100 / total);
+  printf("Wakes per second: %u.%02u\r\n", (unsigned)(wakes / 100), (unsigned)(wakes % 100));
+
+  // lower bound of each bucket
+  printf("ticks    ");
+  for(uint32_t i = 0; i < SLEEP_PROF_BUCKETS; i++) printf(" %6u", (unsigned)((i == 0) ? 0 : 1UL << (i - 1)));
+  printf("\r\n");
+
+  histogram_print("requested", profile.requested);
+  for(uint32_t i = 0; i < WAKE_SOURCES; i++) histogram_print(k_source_names[i], profile.actual[i]);
+
+  printf("Wakes by IRQ:");
+  for(uint32_t i = 0; i < IRQ_COUNT; i++)
+  {
+    if(profile.irq_wakes[i] != 0) printf(" %u:%u", (unsigned)i, (unsigned)profile.irq_wakes[i]);
+  }
+  printf("\r\n");
+
+  printf("Wakes by task:");
+  for(uint32_t i = 0; i < SLEEP_PROF_TASKS && profile.tasks[i].task != NULL; i++)
+  {
+    printf(" %.*s:%u", (int)configMAX_TASK_NAME_LEN, profile.tasks[i].name, (unsigned)profile.tasks[i].wakes);
+  }
+  if(profile.other_task_wakes != 0) printf(" others:%u", (unsigned)profile.other_task_wakes);
+  printf(" no task:%u\r\n", (unsigned)profile.no_task_wakes);
+}
+
+static void report_task(void* pvParameters)
+{
+  TickType_t last_wake = xTaskGetTickCount();
+
+  while(true)
+  {
+    vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(SLEEP_PROF_REPORT_MS));
+    sleep_prof_report();
+  }
+}
+
+bool sleep_prof_start(void)
+{
+  BaseType_t task_err = xTaskCreate(
+                                     report_task,                    // pointer to the task function
+                                     "SLP",                          // task name mainly for debugging
+                                     configMINIMAL_STACK_SIZE + 100, // task stack depth in words
+                                     NULL,                           // task arguments
+                                     1,                              // lowest above idle
+                                     NULL
+                                   );
+
+  return task_err == pdPASS;
+}
+
+#endif /* SLEEP_PROF_ENABLED */
@@ -0,0 +1,119 @@
+/*
+  Tickless idle sleep profiler
+
+  With configUSE_TICKLESS_IDLE 1 the idle task calls
+  vPortSuppressTicksAndSleep(), which stops the RTC1 tick, sets RTC1
+  COMPARE0 at the expected wake time and waits with WFE. How long the
+  system really sleeps and what cuts the sleep short is not visible, but
+  it sets the average current far more than the active code.
+
+  With SLEEP_PROF_ENABLED set to 1 in FreeRTOSConfig.h the
+  configPRE_SLEEP_PROCESSING() and configPOST_SLEEP_PROCESSING() hooks of
+  the port record every sleep:
+
+  - requested and actual length in ticks, from the RTC1 COUNTER
+  - wake source, from the pending interrupts in the NVIC while the port
+    still has them masked:
+      tick    RTC1 COMPARE0, the sleep lasted as long as requested
+      timer   TIMER0-4, RTC0 or RTC2
+      gpiote  GPIOTE
+      other   any other interrupt
+  - the interrupt number behind the wake
+  - the first task made ready after the wake (traceMOVED_TASK_TO_READY_STATE()),
+    for tick wakes that is the task whose delay or timeout ended, for the
+    timers of timers.c the timer service task. A wake after which no task
+    became ready before the next sleep is counted as "no task"
+
+  Lengths are collected in log2 histograms per wake source, bucket n holds
+  the sleeps of 2^(n-1) to 2^n - 1 ticks, bucket 0 the ones that ended in
+  the tick they started. A task at priority 1 prints the histograms, the
+  wakes per second, per interrupt and per task every SLEEP_PROF_REPORT_MS
+  and starts over. Tasks and interrupts with many wakes in the low buckets are the
+  ones to look at.
+
+  Cost per sleep is a few register reads and a short scan of the task
+  table, the report task wakes the system once per report itself.
+
+  With SLEEP_PROF_ENABLED 0 nothing is recorded and sleep_prof_start() does
+  nothing. This header is included by FreeRTOSConfig.h, it must not include
+  kernel headers.
+*/
+
+#ifndef SLEEP_PROF_H
+#define SLEEP_PROF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef SLEEP_PROF_ENABLED
+#define SLEEP_PROF_ENABLED        0
+#endif
+
+#ifndef SLEEP_PROF_REPORT_MS
+#define SLEEP_PROF_REPORT_MS      10000
+#endif
+
+// log2 histogram buckets, the last one collects everything longer
+#ifndef SLEEP_PROF_BUCKETS
+#define SLEEP_PROF_BUCKETS        12
+#endif
+
+// tasks told apart, wakes of further tasks are counted together
+#ifndef SLEEP_PROF_TASKS
+#define SLEEP_PROF_TASKS          8
+#endif
+
+#if SLEEP_PROF_ENABLED
+
+// port hooks, expanded inside vPortSuppressTicksAndSleep() with interrupts
+// masked, right before and right after the WFE
+#define configPRE_SLEEP_PROCESSING(xExpectedIdleTime)   sleep_prof_pre((uint32_t)(xExpectedIdleTime))
+#define configPOST_SLEEP_PROCESSING(xExpectedIdleTime)  sleep_prof_post((uint32_t)(xExpectedIdleTime))
+
+// kernel hook, expanded in tasks.c each time a task is moved to the ready list
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB)           sleep_prof_task_ready((void*)(pxTCB))
+
+/**
+ * @brief Note the start of a sleep, called by configPRE_SLEEP_PROCESSING()
+ *
+ * @param expected_ticks - sleep length asked for by the kernel
+ */
+void sleep_prof_pre(uint32_t expected_ticks);
+
+/**
+ * @brief Record the sleep that just ended, called by
+ *        configPOST_SLEEP_PROCESSING()
+ *
+ * @param expected_ticks - sleep length asked for by the kernel
+ */
+void sleep_prof_post(uint32_t expected_ticks);
+
+/**
+ * @brief Blame the pending wake on a task, called by
+ *        traceMOVED_TASK_TO_READY_STATE()
+ *
+ * @param task - handle of the task made ready
+ */
+void sleep_prof_task_ready(void* task);
+
+/**
+ * @brief Create the report task
+ *
+ * @return false on insufficient heap memory
+ */
+bool sleep_prof_start(void);
+
+/**
+ * @brief Print the profile collected since the last report with printf()
+ *        and start over, from a task. Also called by the report task
+ */
+void sleep_prof_report(void);
+
+#else
+
+#define sleep_prof_start()        true
+#define sleep_prof_report()
+
+#endif /* SLEEP_PROF_ENABLED */
+
+#endif /* SLEEP_PROF_H */
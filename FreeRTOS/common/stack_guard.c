@@ -0,0 +1,103 @@
+/*
+  MPU stack guard, see stack_guard.h
+*/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stack_guard.h"
+#include "nrf.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+#if STACK_GUARD_ENABLED
+
+#if configCHECK_FOR_STACK_OVERFLOW > 1
+#error "configCHECK_FOR_STACK_OVERFLOW 2 reads the guarded stack bottom, use 0 or 1"
+#endif
+
+#if (STACK_GUARD_SIZE < 32) || ((STACK_GUARD_SIZE & (STACK_GUARD_SIZE - 1)) != 0)
+#error "STACK_GUARD_SIZE must be a power of 2 from 32"
+#endif
+
+// no access, not executable, normal memory like the rest of the RAM
+#define GUARD_RASR        (MPU_RASR_XN_Msk                                       \
+                          | (0UL << MPU_RASR_AP_Pos)                             \
+                          | MPU_RASR_S_Msk | MPU_RASR_C_Msk                      \
+                          | ((uint32_t)(__builtin_ctz(STACK_GUARD_SIZE) - 1) << MPU_RASR_SIZE_Pos) \
+                          | MPU_RASR_ENABLE_Msk)
+
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char* pcTaskName);
+
+static uint32_t m_guard_base = 0;
+
+void stack_guard_init(void)
+{
+  configASSERT(((MPU->TYPE & MPU_TYPE_DREGION_Msk) >> MPU_TYPE_DREGION_Pos) > STACK_GUARD_REGION);
+
+  // guard region off until the first switch
+  MPU->RNR = STACK_GUARD_REGION;
+  MPU->RASR = 0;
+
+  SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk;
+  MPU->CTRL = MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+  __DSB();
+  __ISB();
+}
+
+void stack_guard_switch(void* stack_start)
+{
+  // first guard boundary inside the stack buffer
+  uint32_t base = ((uint32_t)(uintptr_t)stack_start + STACK_GUARD_SIZE - 1) & ~(uint32_t)(STACK_GUARD_SIZE - 1);
+
+  m_guard_base = base;
+
+  // RBAR with VALID selects the region, two writes move it. The size never
+  // changes so the region in between the writes is still a valid guard
+  MPU->RBAR = base | MPU_RBAR_VALID_Msk | STACK_GUARD_REGION;
+  MPU->RASR = GUARD_RASR;
+  // PendSV returns to the task right after, the barriers make sure its
+  // first access already sees the new region
+  __DSB();
+  __ISB();
+}
+
+// name in the vector table of ses_startup_nrf52840.s
+void MemoryManagement_Handler(void)
+{
+  uint32_t cfsr = SCB->CFSR;
+  uint32_t address = SCB->MMFAR;
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+
+  // the task can't continue, let the hook print and use its stack freely
+  MPU->CTRL = 0;
+
+  if(cfsr & SCB_CFSR_MMARVALID_Msk)
+  {
+    printf("MPU fault at 0x%08x, guard 0x%08x\r\n", (unsigned)address, (unsigned)m_guard_base);
+  }
+  else if(cfsr & SCB_CFSR_MSTKERR_Msk)
+  {
+    // the exception entry itself pushed into the guard
+    printf("MPU fault stacking the exception, guard 0x%08x\r\n", (unsigned)m_guard_base);
+  }
+
+  vApplicationStackOverflowHook(task, pcTaskGetName(task));
+
+  // the hook must not return, nothing to resume
+  while(true)
+  {
+  }
+}
+
+// replaced by the application's own hook if it has one
+__attribute__((weak)) void vApplicationStackOverflowHook(TaskHandle_t xTask, char* pcTaskName)
+{
+  (void)xTask;
+  printf("Stack overflow in task %s\r\n", pcTaskName);
+  __disable_irq();
+  while(true)
+  {
+  }
+}
+
+#endif /* STACK_GUARD_ENABLED */
@@ -0,0 +1,75 @@
+/*
+  MPU stack guard
+
+  configCHECK_FOR_STACK_OVERFLOW 2 compares the last 16 bytes of the stack
+  with the fill pattern on every context switch and only notices an
+  overflow after it happened, if the overflow wrote over the pattern at all.
+  Here MPU region STACK_GUARD_REGION is moved over the bottom
+  STACK_GUARD_SIZE bytes of the stack of the task being switched in, with
+  no access allowed. The first push into it raises a MemManage fault while
+  the task is still running, the fault handler calls
+  vApplicationStackOverflowHook() with that task.
+
+  - the guard lies inside the stack buffer, at the first STACK_GUARD_SIZE
+    boundary above its start: a task loses up to 2 * STACK_GUARD_SIZE - 8
+    bytes of stack. Nothing outside the stacks is ever blocked
+  - a frame with locals bigger than the guard can jump over it, raise
+    STACK_GUARD_SIZE for tasks with big arrays on the stack
+  - the first task runs without guard until its first switch, V10.0.0
+    doesn't call traceTASK_SWITCHED_IN() when the scheduler starts
+  - the running task can't read its own stack bottom, so
+    uxTaskGetStackHighWaterMark(NULL) and configCHECK_FOR_STACK_OVERFLOW 2
+    can't be used with it. Checking another task is fine
+  - all code runs privileged, PRIVDEFENA keeps the default memory map for
+    everything else
+
+  This header is included by FreeRTOSConfig.h, it must not include kernel
+  headers.
+*/
+
+#ifndef STACK_GUARD_H
+#define STACK_GUARD_H
+
+#include <stdint.h>
+
+#ifndef STACK_GUARD_ENABLED
+#define STACK_GUARD_ENABLED   0
+#endif
+
+// bytes, power of 2 from 32
+#ifndef STACK_GUARD_SIZE
+#define STACK_GUARD_SIZE      32
+#endif
+
+// highest numbered region wins where regions overlap
+#ifndef STACK_GUARD_REGION
+#define STACK_GUARD_REGION    7
+#endif
+
+#if STACK_GUARD_ENABLED
+
+// kernel hook, expanded in vTaskSwitchContext() where pxCurrentTCB is the
+// task about to run
+#define traceTASK_SWITCHED_IN()   stack_guard_switch((void*)pxCurrentTCB->pxStack)
+
+/**
+ * @brief Turn on the MPU and the MemManage fault, call from main() before
+ *        vTaskStartScheduler()
+ */
+void stack_guard_init(void);
+
+/**
+ * @brief Move the guard to the bottom of a stack, called by
+ *        traceTASK_SWITCHED_IN()
+ *
+ * @param stack_start - lowest address of the stack buffer
+ */
+void stack_guard_switch(void* stack_start);
+
+#else
+
+#define stack_guard_init()
+
+#endif /* STACK_GUARD_ENABLED */
+
+#endif /* STACK_GUARD_H */
@@ -0,0 +1,81 @@
+/*
+  FreeRTOSConfig.h of the host build
+
+  Takes the configuration of the example being built, the Makefile passes
+  its path in HOST_EXAMPLE_CONFIG, so kernel features, priorities, tick rate
+  and module settings stay the ones of the board build. Only what the POSIX
+  port or a Linux process cannot do is changed here:
+
+  - no tickless idle, the port has no vPortSuppressTicksAndSleep()
+  - generic task selection, the priority bitmap of the port is not needed
+  - task stacks become pthread stacks, so they need PTHREAD_STACK_MIN bytes
+    and room for glibc printf()
+  - the heap is a static array, malloc() stays the one of glibc
+  - RAM power-down, the sleep profiler and the MPU stack guard are off,
+    their calls in main() compile to nothing
+  - configASSERT() reports and aborts, so a failed assert stops a CI run
+  - common/bench.h results name the monotonic clock, the process exits
+    after a suite and after common/isr_stress.h with its result
+*/
+
+#ifndef HOST_FREERTOS_CONFIG_H
+#define HOST_FREERTOS_CONFIG_H
+
+#include HOST_EXAMPLE_CONFIG
+
+#undef configUSE_TICKLESS_IDLE
+#define configUSE_TICKLESS_IDLE                                                   0
+
+#undef configUSE_PORT_OPTIMISED_TASK_SELECTION
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION                                   0
+
+/* 32 kB stacks, configMINIMAL_STACK_SIZE + 200 still fits in uint16_t */
+#undef configMINIMAL_STACK_SIZE
+#define configMINIMAL_STACK_SIZE                                                  ( 4096 )
+
+#undef configTIMER_TASK_STACK_DEPTH
+#define configTIMER_TASK_STACK_DEPTH                                              ( configMINIMAL_STACK_SIZE )
+
+/* largest region common/heap_tlsf.c manages */
+#undef configTOTAL_HEAP_SIZE
+#define configTOTAL_HEAP_SIZE                                                     ( 512 * 1024 )
+
+#undef HEAP_TLSF_LINKER_REGIONS
+#define HEAP_TLSF_LINKER_REGIONS                                                  0
+#undef HEAP_TLSF_MALLOC
+#define HEAP_TLSF_MALLOC                                                          0
+
+#undef RAM_POWER_ENABLED
+#define RAM_POWER_ENABLED                                                         0
+
+/* stack_guard.h and sleep_prof.h were already read with the board values */
+#if STACK_GUARD_ENABLED
+#undef traceTASK_SWITCHED_IN
+#define stack_guard_init()
+#endif
+#undef STACK_GUARD_ENABLED
+#define STACK_GUARD_ENABLED                                                       0
+
+#if SLEEP_PROF_ENABLED
+#undef configPRE_SLEEP_PROCESSING
+#undef configPOST_SLEEP_PROCESSING
+#undef traceMOVED_TASK_TO_READY_STATE
+#define sleep_prof_start()        true
+#define sleep_prof_report()
+#endif
+#undef SLEEP_PROF_ENABLED
+#define SLEEP_PROF_ENABLED                                                        0
+
+/* Benchmark harness, see common/bench.h */
+#define BENCH_CLOCK                                                               "monotonic"
+#define BENCH_DONE()                                                              exit(0)
+
+/* Interrupt flood stress test, see common/isr_stress.h */
+#define ISR_STRESS_DONE(failed)                                                   exit((failed) ? 1 : 0)
+
+void host_assert_failed(const char* file, int line);
+
+#undef configASSERT
+#define configASSERT( x )                                                         if(!(x)) host_assert_failed(__FILE__, __LINE__)
+
+#endif /* HOST_FREERTOS_CONFIG_H */
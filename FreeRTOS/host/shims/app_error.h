@@ -0,0 +1,24 @@
+/*
+  Host stand-in for app_error.h, an error stops the process
+*/
+
+#ifndef APP_ERROR_H
+#define APP_ERROR_H
+
+#include "sdk_errors.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define APP_ERROR_CHECK(err_code)                                             \
+  do                                                                          \
+  {                                                                           \
+    ret_code_t app_err_ = (err_code);                                         \
+    if(app_err_ != NRF_SUCCESS)                                               \
+    {                                                                         \
+      fprintf(stderr, "error %u at %s:%d\r\n",                                \
+              (unsigned)app_err_, __FILE__, __LINE__);                        \
+      exit(1);                                                                \
+    }                                                                         \
+  } while(0)
+
+#endif /* APP_ERROR_H */
@@ -0,0 +1,43 @@
+/*
+  Host stand-in for app_util_platform.h
+
+  Critical regions are the ones of the POSIX port, they block the tick
+  signal. There are no interrupt handlers, the priorities only need to
+  exist for the configurations that name them.
+*/
+
+#ifndef APP_UTIL_PLATFORM_H
+#define APP_UTIL_PLATFORM_H
+
+#include "nrf.h"
+#include "nrf_assert.h"
+#include "app_error.h"
+#include <stdint.h>
+
+typedef enum
+{
+  _PRIO_SD_HIGH    = 0,
+  _PRIO_SD_MID     = 1,
+  _PRIO_APP_HIGH   = 2,
+  _PRIO_APP_MID    = 3,
+  _PRIO_SD_LOW     = 4,
+  _PRIO_SD_LOWEST  = 5,
+  _PRIO_APP_LOW    = 6,
+  _PRIO_APP_LOWEST = 7,
+  _PRIO_THREAD     = 15
+}app_irq_priority_t;
+
+#define APP_IRQ_PRIORITY_HIGHEST  _PRIO_APP_HIGH
+#define APP_IRQ_PRIORITY_HIGH     _PRIO_APP_HIGH
+#define APP_IRQ_PRIORITY_MID      _PRIO_APP_MID
+#define APP_IRQ_PRIORITY_LOW      _PRIO_APP_LOW
+#define APP_IRQ_PRIORITY_LOWEST   _PRIO_APP_LOWEST
+
+// included by FreeRTOSConfig.h ahead of the kernel headers
+void vPortEnterCritical(void);
+void vPortExitCritical(void);
+
+#define CRITICAL_REGION_ENTER()   { vPortEnterCritical();
+#define CRITICAL_REGION_EXIT()    vPortExitCritical(); }
+
+#endif /* APP_UTIL_PLATFORM_H */
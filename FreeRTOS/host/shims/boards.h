@@ -0,0 +1,27 @@
+/*
+  Host stand-in for boards.h, the LEDs and buttons of the PCA10056 DevKit
+
+  There are no buttons on the host, common/button_input.c is left out of the
+  build, the pins are here for the examples that name them.
+*/
+
+#ifndef BOARDS_H
+#define BOARDS_H
+
+#include "nrf_gpio.h"
+
+#define LEDS_NUMBER           4
+#define LED_1                 NRF_GPIO_PIN_MAP(0, 13)
+#define LED_2                 NRF_GPIO_PIN_MAP(0, 14)
+#define LED_3                 NRF_GPIO_PIN_MAP(0, 15)
+#define LED_4                 NRF_GPIO_PIN_MAP(0, 16)
+#define LEDS_ACTIVE_STATE     0
+
+#define BUTTONS_NUMBER        4
+#define BUTTON_1              NRF_GPIO_PIN_MAP(0, 11)
+#define BUTTON_2              NRF_GPIO_PIN_MAP(0, 12)
+#define BUTTON_3              NRF_GPIO_PIN_MAP(0, 24)
+#define BUTTON_4              NRF_GPIO_PIN_MAP(0, 25)
+#define BUTTONS_ACTIVE_STATE  0
+
+#endif /* BOARDS_H */
@@ -0,0 +1,96 @@
+/*
+  Synthetic interrupt source of the host build, see irq_flood.h
+
+  A POSIX timer on CLOCK_MONOTONIC sends SIGRTMIN. The port blocks all
+  signals in critical sections, in the threads of tasks that don't run and
+  in the scheduler thread, so the signal interrupts the running task like
+  the SIGALRM of the tick. The handler calls the ...FromISR functions there,
+  as on target.
+*/
+
+#include "irq_flood.h"
+#include <signal.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+#define FLOOD_SIGNAL  SIGRTMIN
+
+static volatile irq_flood_handler_t m_handler = NULL;
+static timer_t m_timer;
+static uint64_t m_period_ns;
+static uint64_t m_due_ns;     // due time of the next expiry
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void flood_signal_handler(int sig, siginfo_t* p_info, void* p_context)
+{
+  uint64_t now = now_ns();
+  irq_flood_handler_t handler = m_handler;
+
+  (void)sig;
+  (void)p_context;
+
+  // queued before irq_flood_stop() deleted the timer
+  if(handler == NULL) return;
+
+  // expiries that came while the signal was still queued
+  uint32_t missed = (uint32_t)p_info->si_overrun;
+
+  m_due_ns += (uint64_t)missed * m_period_ns;
+  uint64_t late = (now > m_due_ns) ? now - m_due_ns : 0;
+  m_due_ns += m_period_ns;
+
+  handler(late > UINT32_MAX ? UINT32_MAX : (uint32_t)late, missed);
+}
+
+ret_code_t irq_flood_start(uint32_t period_us, irq_flood_handler_t handler)
+{
+  struct sigaction action;
+  struct sigevent event;
+  struct itimerspec spec;
+
+  if(handler == NULL || period_us < IRQ_FLOOD_MIN_PERIOD_US) return NRF_ERROR_INVALID_PARAM;
+  if(m_handler != NULL) return NRF_ERROR_INVALID_STATE;
+
+  memset(&action, 0, sizeof(action));
+  action.sa_sigaction = flood_signal_handler;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigfillset(&action.sa_mask);
+  if(sigaction(FLOOD_SIGNAL, &action, NULL) != 0) return NRF_ERROR_INTERNAL;
+
+  memset(&event, 0, sizeof(event));
+  event.sigev_notify = SIGEV_SIGNAL;
+  event.sigev_signo = FLOOD_SIGNAL;
+  if(timer_create(CLOCK_MONOTONIC, &event, &m_timer) != 0) return NRF_ERROR_INTERNAL;
+
+  m_period_ns = (uint64_t)period_us * 1000ULL;
+  spec.it_interval.tv_sec = period_us / 1000000UL;
+  spec.it_interval.tv_nsec = (long)(period_us % 1000000UL) * 1000L;
+  spec.it_value = spec.it_interval;
+
+  m_handler = handler;
+  m_due_ns = now_ns() + m_period_ns;
+  if(timer_settime(m_timer, 0, &spec, NULL) != 0)
+  {
+    m_handler = NULL;
+    timer_delete(m_timer);
+    return NRF_ERROR_INTERNAL;
+  }
+
+  return NRF_SUCCESS;
+}
+
+void irq_flood_stop(void)
+{
+  if(m_handler == NULL) return;
+
+  timer_delete(m_timer);
+  m_handler = NULL;
+}
@@ -0,0 +1,53 @@
+/*
+  64-bit monotonic time of the host build, see mono_time.h
+
+  Same 32768 Hz ticks, counted from mono_time_init() on CLOCK_MONOTONIC.
+*/
+
+#include "mono_time.h"
+#include <stdbool.h>
+#include <time.h>
+
+#define RTC_COUNTER_BITS  24
+
+static struct timespec m_start;
+static uint64_t m_offset = 0;   // ticks skipped by mono_time_overflow_trigger()
+static bool m_started = false;
+
+ret_code_t mono_time_init(void)
+{
+  if(m_started) return NRF_ERROR_INVALID_STATE;
+
+  clock_gettime(CLOCK_MONOTONIC, &m_start);
+  m_offset = 0;
+  m_started = true;
+
+  return NRF_SUCCESS;
+}
+
+uint64_t mono_time_ticks_get(void)
+{
+  struct timespec now;
+
+  if(!m_started) return 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  uint64_t ns = (uint64_t)(now.tv_sec - m_start.tv_sec) * 1000000000ULL + (uint64_t)now.tv_nsec - (uint64_t)m_start.tv_nsec;
+
+  return (ns / 1000000000ULL) * MONO_TIME_TICKS_PER_SEC
+         + (ns % 1000000000ULL) * MONO_TIME_TICKS_PER_SEC / 1000000000ULL
+         + m_offset;
+}
+
+uint64_t mono_time_us_get(void)
+{
+  return mono_time_ticks_to_us(mono_time_ticks_get());
+}
+
+// jumps to the next wrap of the 24-bit RTC COUNTER, as the RTC task does
+void mono_time_overflow_trigger(void)
+{
+  uint64_t ticks = mono_time_ticks_get();
+  m_offset += (1ULL << RTC_COUNTER_BITS) - (ticks & ((1ULL << RTC_COUNTER_BITS) - 1));
+}
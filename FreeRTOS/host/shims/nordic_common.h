@@ -0,0 +1,11 @@
+/*
+  Host stand-in for nordic_common.h
+*/
+
+#ifndef NORDIC_COMMON_H
+#define NORDIC_COMMON_H
+
+#define UNUSED_PARAMETER(X)       (void)(X)
+#define UNUSED_VARIABLE(X)        (void)(X)
+
+#endif /* NORDIC_COMMON_H */
@@ -0,0 +1,71 @@
+/*
+  Host stand-in for the nRF52840 device header
+
+  Only the core registers the examples and common modules touch outside
+  their hardware drivers. SCB and CoreDebug are plain memory, DWT->CYCCNT
+  counts SystemCoreClock cycles of CLOCK_MONOTONIC, so cycle_counter.h,
+  idle_work.c and load_meter.c measure host time scaled to 64 MHz.
+*/
+
+#ifndef NRF_H
+#define NRF_H
+
+#include <stdint.h>
+
+#define __NVIC_PRIO_BITS              3
+
+extern uint32_t SystemCoreClock;
+
+typedef struct
+{
+  volatile uint32_t SCR;
+}host_scb_t;
+
+typedef struct
+{
+  volatile uint32_t CTRL;
+  volatile uint32_t CYCCNT;
+}host_dwt_t;
+
+typedef struct
+{
+  volatile uint32_t DEMCR;
+}host_core_debug_t;
+
+typedef struct
+{
+  struct
+  {
+    uint32_t RAM;           // kB
+  }INFO;
+}host_ficr_t;
+
+extern host_scb_t host_scb;
+extern host_core_debug_t host_core_debug;
+extern host_ficr_t host_ficr;
+
+/**
+ * @brief DWT with CYCCNT moved on to now, writes to CYCCNT are kept
+ */
+host_dwt_t* host_dwt_get(void);
+
+#define SCB                           (&host_scb)
+#define DWT                           (host_dwt_get())
+#define CoreDebug                     (&host_core_debug)
+#define NRF_FICR                      (&host_ficr)
+
+#define SCB_SCR_SLEEPDEEP_Msk         (1UL << 2)
+#define DWT_CTRL_CYCCNTENA_Msk        (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk    (1UL << 24)
+
+#define __DMB()                       __sync_synchronize()
+#define __DSB()                       __sync_synchronize()
+#define __ISB()                       __sync_synchronize()
+
+// tasks only, there are no interrupt handlers on the host
+static inline uint32_t __get_IPSR(void)
+{
+  return 0;
+}
+
+#endif /* NRF_H */
@@ -0,0 +1,12 @@
+/*
+  Host stand-in for nrf_assert.h, always checked
+*/
+
+#ifndef NRF_ASSERT_H
+#define NRF_ASSERT_H
+
+void host_assert_failed(const char* file, int line);
+
+#define ASSERT(expr)              if(!(expr)) host_assert_failed(__FILE__, __LINE__)
+
+#endif /* NRF_ASSERT_H */
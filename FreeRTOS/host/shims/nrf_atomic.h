@@ -0,0 +1,28 @@
+/*
+  Host stand-in for nrf_atomic.h, on the GCC builtins
+*/
+
+#ifndef NRF_ATOMIC_H
+#define NRF_ATOMIC_H
+
+#include <stdint.h>
+
+typedef volatile uint32_t nrf_atomic_u32_t;
+
+// new value, as the SDK version
+static inline uint32_t nrf_atomic_u32_add(nrf_atomic_u32_t* p_data, uint32_t value)
+{
+  return __atomic_add_fetch(p_data, value, __ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t nrf_atomic_u32_sub(nrf_atomic_u32_t* p_data, uint32_t value)
+{
+  return __atomic_sub_fetch(p_data, value, __ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t nrf_atomic_u32_store(nrf_atomic_u32_t* p_data, uint32_t value)
+{
+  return __atomic_exchange_n(p_data, value, __ATOMIC_SEQ_CST);
+}
+
+#endif /* NRF_ATOMIC_H */
@@ -0,0 +1,50 @@
+/*
+  Host stand-in for nrf_balloc.h
+
+  Same fixed-size block pool API, a stack of free block indexes in a
+  critical region. Blocks are 16-byte aligned, they hold task stacks that
+  become pthread stacks.
+*/
+
+#ifndef NRF_BALLOC_H
+#define NRF_BALLOC_H
+
+#include "sdk_errors.h"
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct
+{
+  uint32_t free_count;      // entries in the free index stack
+}nrf_balloc_cb_t;
+
+typedef struct
+{
+  nrf_balloc_cb_t* p_cb;
+  uint8_t* p_memory_begin;
+  uint32_t* p_free;         // free block indexes
+  size_t block_size;
+  uint32_t block_count;
+}nrf_balloc_t;
+
+#define NRF_BALLOC_BLOCK_SIZE_(_element_size)  (((_element_size) + 15) & ~(size_t)15)
+
+#define NRF_BALLOC_DEF(_name, _element_size, _pool_size)                      \
+  static uint8_t _name##_memory[NRF_BALLOC_BLOCK_SIZE_(_element_size) * (_pool_size)] \
+    __attribute__((aligned(16)));                                             \
+  static uint32_t _name##_free[(_pool_size)];                                 \
+  static nrf_balloc_cb_t _name##_cb;                                          \
+  static const nrf_balloc_t _name =                                           \
+  {                                                                           \
+    .p_cb = &_name##_cb,                                                      \
+    .p_memory_begin = _name##_memory,                                         \
+    .p_free = _name##_free,                                                   \
+    .block_size = NRF_BALLOC_BLOCK_SIZE_(_element_size),                      \
+    .block_count = (_pool_size)                                               \
+  }
+
+ret_code_t nrf_balloc_init(nrf_balloc_t const* p_pool);
+void* nrf_balloc_alloc(nrf_balloc_t const* p_pool);
+void nrf_balloc_free(nrf_balloc_t const* p_pool, void* p_element);
+
+#endif /* NRF_BALLOC_H */
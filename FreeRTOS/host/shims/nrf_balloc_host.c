@@ -0,0 +1,48 @@
+/*
+  Fixed-size block pools of the host build, see nrf_balloc.h
+*/
+
+#include "nrf_balloc.h"
+#include "app_util_platform.h"
+#include "nrf_assert.h"
+
+ret_code_t nrf_balloc_init(nrf_balloc_t const* p_pool)
+{
+  if(p_pool == NULL) return NRF_ERROR_NULL;
+
+  // popped from the end, block 0 goes out first as with the SDK pool
+  for(uint32_t i = 0; i < p_pool->block_count; i++)
+  {
+    p_pool->p_free[i] = p_pool->block_count - 1 - i;
+  }
+  p_pool->p_cb->free_count = p_pool->block_count;
+
+  return NRF_SUCCESS;
+}
+
+void* nrf_balloc_alloc(nrf_balloc_t const* p_pool)
+{
+  void* p_block = NULL;
+
+  CRITICAL_REGION_ENTER();
+  if(p_pool->p_cb->free_count != 0)
+  {
+    uint32_t index = p_pool->p_free[--p_pool->p_cb->free_count];
+    p_block = p_pool->p_memory_begin + index * p_pool->block_size;
+  }
+  CRITICAL_REGION_EXIT();
+
+  return p_block;
+}
+
+void nrf_balloc_free(nrf_balloc_t const* p_pool, void* p_element)
+{
+  size_t offset = (size_t)((uint8_t*)p_element - p_pool->p_memory_begin);
+
+  ASSERT(offset % p_pool->block_size == 0 && offset / p_pool->block_size < p_pool->block_count);
+
+  CRITICAL_REGION_ENTER();
+  ASSERT(p_pool->p_cb->free_count < p_pool->block_count);
+  p_pool->p_free[p_pool->p_cb->free_count++] = (uint32_t)(offset / p_pool->block_size);
+  CRITICAL_REGION_EXIT();
+}
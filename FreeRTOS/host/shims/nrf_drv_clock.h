@@ -0,0 +1,42 @@
+/*
+  Host stand-in for the nrf_drv_clock driver
+
+  Requests are counted as by the driver, but both clocks start at once:
+  the handler of a request runs before the request returns, the way the
+  driver calls it when the clock already runs.
+*/
+
+#ifndef NRF_DRV_CLOCK_H
+#define NRF_DRV_CLOCK_H
+
+#include "sdk_errors.h"
+#include <stdbool.h>
+
+typedef enum
+{
+  NRF_DRV_CLOCK_EVT_HFCLK_STARTED,
+  NRF_DRV_CLOCK_EVT_LFCLK_STARTED,
+  NRF_DRV_CLOCK_EVT_CAL_DONE,
+  NRF_DRV_CLOCK_EVT_CAL_ABORTED
+}nrf_drv_clock_evt_type_t;
+
+typedef void (*nrf_drv_clock_event_handler_t)(nrf_drv_clock_evt_type_t event);
+
+typedef struct nrf_drv_clock_handler_item_s
+{
+  struct nrf_drv_clock_handler_item_s* p_next;
+  nrf_drv_clock_event_handler_t event_handler;
+}nrf_drv_clock_handler_item_t;
+
+ret_code_t nrf_drv_clock_init(void);
+bool nrf_drv_clock_init_check(void);
+
+void nrf_drv_clock_lfclk_request(nrf_drv_clock_handler_item_t* p_handler_item);
+void nrf_drv_clock_lfclk_release(void);
+bool nrf_drv_clock_lfclk_is_running(void);
+
+void nrf_drv_clock_hfclk_request(nrf_drv_clock_handler_item_t* p_handler_item);
+void nrf_drv_clock_hfclk_release(void);
+bool nrf_drv_clock_hfclk_is_running(void);
+
+#endif /* NRF_DRV_CLOCK_H */
@@ -0,0 +1,65 @@
+/*
+  Simulated clock driver of the host build, see nrf_drv_clock.h
+*/
+
+#include "nrf_drv_clock.h"
+#include "app_util_platform.h"
+#include <stddef.h>
+#include <stdint.h>
+
+static bool m_initialised = false;
+static uint32_t m_lfclk_requests = 0;
+static uint32_t m_hfclk_requests = 0;
+
+ret_code_t nrf_drv_clock_init(void)
+{
+  m_initialised = true;
+  return NRF_SUCCESS;
+}
+
+bool nrf_drv_clock_init_check(void)
+{
+  return m_initialised;
+}
+
+void nrf_drv_clock_lfclk_request(nrf_drv_clock_handler_item_t* p_handler_item)
+{
+  CRITICAL_REGION_ENTER();
+  m_lfclk_requests++;
+  CRITICAL_REGION_EXIT();
+
+  if(p_handler_item != NULL) p_handler_item->event_handler(NRF_DRV_CLOCK_EVT_LFCLK_STARTED);
+}
+
+void nrf_drv_clock_lfclk_release(void)
+{
+  CRITICAL_REGION_ENTER();
+  if(m_lfclk_requests != 0) m_lfclk_requests--;
+  CRITICAL_REGION_EXIT();
+}
+
+bool nrf_drv_clock_lfclk_is_running(void)
+{
+  return m_lfclk_requests != 0;
+}
+
+void nrf_drv_clock_hfclk_request(nrf_drv_clock_handler_item_t* p_handler_item)
+{
+  CRITICAL_REGION_ENTER();
+  m_hfclk_requests++;
+  CRITICAL_REGION_EXIT();
+
+  if(p_handler_item != NULL) p_handler_item->event_handler(NRF_DRV_CLOCK_EVT_HFCLK_STARTED);
+}
+
+void nrf_drv_clock_hfclk_release(void)
+{
+  CRITICAL_REGION_ENTER();
+  if(m_hfclk_requests != 0) m_hfclk_requests--;
+  CRITICAL_REGION_EXIT();
+}
+
+bool nrf_drv_clock_hfclk_is_running(void)
+{
+  return m_hfclk_requests != 0;
+}
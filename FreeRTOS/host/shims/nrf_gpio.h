@@ -0,0 +1,29 @@
+/*
+  Host stand-in for nrf_gpio.h
+
+  Pins are an array, every change of a pin configured as output prints a
+  line with the tick it happened at:
+
+    [   1024] P0.13 low
+
+  The LEDs of the DevKit are on P0.13 to P0.16 and light up while low.
+*/
+
+#ifndef NRF_GPIO_H
+#define NRF_GPIO_H
+
+#include <stdint.h>
+
+#define NRF_GPIO_PIN_MAP(port, pin)   (((port) << 5) | ((pin) & 0x1F))
+#define NUMBER_OF_PINS                48
+
+void nrf_gpio_cfg_output(uint32_t pin_number);
+void nrf_gpio_cfg_input(uint32_t pin_number, uint32_t pull_config);
+void nrf_gpio_pin_write(uint32_t pin_number, uint32_t value);
+void nrf_gpio_pin_set(uint32_t pin_number);
+void nrf_gpio_pin_clear(uint32_t pin_number);
+void nrf_gpio_pin_toggle(uint32_t pin_number);
+uint32_t nrf_gpio_pin_read(uint32_t pin_number);
+uint32_t nrf_gpio_pin_out_read(uint32_t pin_number);
+
+#endif /* NRF_GPIO_H */
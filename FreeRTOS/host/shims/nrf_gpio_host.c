@@ -0,0 +1,62 @@
+/*
+  Simulated GPIO of the host build, see nrf_gpio.h
+*/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "nrf_gpio.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+static uint8_t m_out[NUMBER_OF_PINS];
+static bool m_output[NUMBER_OF_PINS];
+
+void nrf_gpio_cfg_output(uint32_t pin_number)
+{
+  m_output[pin_number] = true;
+}
+
+void nrf_gpio_cfg_input(uint32_t pin_number, uint32_t pull_config)
+{
+  m_output[pin_number] = false;
+}
+
+void nrf_gpio_pin_write(uint32_t pin_number, uint32_t value)
+{
+  uint8_t level = (value != 0);
+
+  if(m_out[pin_number] == level) return;
+  m_out[pin_number] = level;
+
+  if(m_output[pin_number])
+  {
+    printf("[%7u] P%u.%02u %s\r\n", (unsigned)xTaskGetTickCount(),
+           (unsigned)(pin_number >> 5), (unsigned)(pin_number & 0x1F), level ? "high" : "low");
+  }
+}
+
+void nrf_gpio_pin_set(uint32_t pin_number)
+{
+  nrf_gpio_pin_write(pin_number, 1);
+}
+
+void nrf_gpio_pin_clear(uint32_t pin_number)
+{
+  nrf_gpio_pin_write(pin_number, 0);
+}
+
+void nrf_gpio_pin_toggle(uint32_t pin_number)
+{
+  nrf_gpio_pin_write(pin_number, !m_out[pin_number]);
+}
+
+// inputs read back the output latch, nothing drives them
+uint32_t nrf_gpio_pin_read(uint32_t pin_number)
+{
+  return m_out[pin_number];
+}
+
+uint32_t nrf_gpio_pin_out_read(uint32_t pin_number)
+{
+  return m_out[pin_number];
+}
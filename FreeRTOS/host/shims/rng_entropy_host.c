@@ -0,0 +1,42 @@
+/*
+  Entropy of the host build, see rng_entropy.h
+
+  getrandom() stands in for the RNG peripheral, the pool never runs dry.
+*/
+
+#include "rng_entropy.h"
+#include <stdbool.h>
+#include <sys/random.h>
+
+static bool m_started = false;
+
+ret_code_t rng_entropy_init(void)
+{
+  if(m_started) return NRF_ERROR_INVALID_STATE;
+
+  m_started = true;
+  return NRF_SUCCESS;
+}
+
+size_t rng_entropy_read(void* p_buf, size_t len)
+{
+  ssize_t count = getrandom(p_buf, len, 0);
+  return (count < 0) ? 0 : (size_t)count;
+}
+
+void rng_entropy_read_blocking(void* p_buf, size_t len)
+{
+  uint8_t* p_out = p_buf;
+
+  while(len > 0)
+  {
+    size_t count = rng_entropy_read(p_out, len);
+    p_out += count;
+    len -= count;
+  }
+}
+
+size_t rng_entropy_available(void)
+{
+  return RNG_ENTROPY_POOL_SIZE;
+}
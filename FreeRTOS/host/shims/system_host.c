@@ -0,0 +1,62 @@
+/*
+  Simulated core of the host build, see nrf.h
+*/
+
+#include "nrf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+uint32_t SystemCoreClock = 64000000UL;
+
+host_scb_t host_scb;
+host_core_debug_t host_core_debug;
+
+// more than the 256 kB of the board, the host heap is 512 kB
+host_ficr_t host_ficr = { .INFO = { .RAM = 1024 } };
+
+static host_dwt_t m_dwt;
+static uint64_t m_cyccnt_base_ns;
+static uint32_t m_cyccnt_base;
+static uint32_t m_cyccnt_last;    // as last returned, a write changes it
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+host_dwt_t* host_dwt_get(void)
+{
+  uint64_t now = now_ns();
+
+  // a single task runs at a time on the POSIX port, no lock needed. Counts
+  // from a base so short reads lose no rounding
+  if(m_dwt.CYCCNT != m_cyccnt_last || !(m_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk))
+  {
+    m_cyccnt_base = m_dwt.CYCCNT;
+    m_cyccnt_base_ns = now;
+  }
+  else
+  {
+    m_dwt.CYCCNT = m_cyccnt_base + (uint32_t)((now - m_cyccnt_base_ns) * (SystemCoreClock / 1000000UL) / 1000ULL);
+  }
+  m_cyccnt_last = m_dwt.CYCCNT;
+
+  return &m_dwt;
+}
+
+void host_assert_failed(const char* file, int line)
+{
+  fprintf(stderr, "assert failed at %s:%d\r\n", file, line);
+  abort();
+}
+
+// printf() is the UART of the board, unbuffered so the output of a run
+// killed by timeout or abort() is complete
+__attribute__((constructor)) static void host_stdout_init(void)
+{
+  setvbuf(stdout, NULL, _IONBF, 0);
+}
@@ -0,0 +1,200 @@
+/*
+  Fragmentation stress of common/heap_tlsf.c against MemMang/heap_4.c
+
+  Built twice from this file, once with each heap, "make heap-stress" runs
+  both and prints them one line each. The same seeded sequence of
+  pvPortMalloc() and vPortFree() calls goes to both heaps:
+
+  - STRESS_SLOTS live pointers, each step frees or fills one slot at random
+  - sizes as in the examples: 70 % control blocks and messages of 8 to
+    128 bytes, 25 % queues and stacks up to 4 kB, 5 % buffers up to 32 kB
+  - sized to run the 512 kB host heap close to full, so requests fail once
+    free memory is split into pieces too small for them
+
+  Every STRESS_SAMPLE_EVERY steps the share of free bytes outside the
+  largest free block is sampled, as heap_tlsf_stats_t.fragmentation counts
+  it. At the end the largest request that still succeeds is found by trying.
+  Malloc and free times are CLOCK_MONOTONIC around the call.
+
+  Single threaded, the kernel calls of the heaps are stubbed here and only
+  the headers and MemMang/heap_4.c of FREERTOS_KERNEL are used.
+*/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "prng.h"
+#if HEAP_STRESS_TLSF
+#include "heap_tlsf.h"
+#endif
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define STRESS_STEPS          1000000UL
+#define STRESS_SLOTS          1024
+#define STRESS_SAMPLE_EVERY   1000
+#define STRESS_SEED           0x5EEDULL
+
+#if HEAP_STRESS_TLSF
+#define HEAP_NAME             "tlsf"
+#else
+#define HEAP_NAME             "heap_4"
+#endif
+
+typedef struct
+{
+  uint64_t count;
+  uint64_t sum_ns;
+  uint64_t max_ns;
+}timing_t;
+
+static void* m_slots[STRESS_SLOTS];
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void timing_add(timing_t* p_timing, uint64_t ns)
+{
+  p_timing->count++;
+  p_timing->sum_ns += ns;
+  if(ns > p_timing->max_ns) p_timing->max_ns = ns;
+}
+
+static size_t size_draw(prng_t* p_prng)
+{
+  uint32_t kind = prng_range(p_prng, 100);
+
+  if(kind < 70) return 8 + prng_range(p_prng, 121);
+  if(kind < 95) return 128 + prng_range(p_prng, 4096 - 128 + 1);
+  return 4096 + prng_range(p_prng, 32768 - 4096 + 1);
+}
+
+void vTaskSuspendAll(void)
+{
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+  return pdFALSE;
+}
+
+void vPortEnterCritical(void)
+{
+}
+
+void vPortExitCritical(void)
+{
+}
+
+// share of free bytes outside the largest free block, headers included
+static uint32_t fragmentation_get(void)
+{
+#if HEAP_STRESS_TLSF
+  heap_tlsf_stats_t stats;
+
+  heap_tlsf_stats_get(&stats);
+  return stats.fragmentation;
+#else
+  HeapStats_t stats;
+
+  vPortGetHeapStats(&stats);
+  return (stats.xAvailableHeapSpaceInBytes > 0)
+         ? (uint32_t)(100 - (uint64_t)stats.xSizeOfLargestFreeBlockInBytes * 100 / stats.xAvailableHeapSpaceInBytes)
+         : 0;
+#endif
+}
+
+// largest request served now, by bisection
+static size_t largest_request_get(void)
+{
+  size_t low = 0;
+  size_t high = configTOTAL_HEAP_SIZE;
+
+  while(low < high)
+  {
+    size_t mid = (low + high + 1) / 2;
+    void* ptr = pvPortMalloc(mid);
+
+    if(ptr != NULL)
+    {
+      vPortFree(ptr);
+      low = mid;
+    }
+    else
+    {
+      high = mid - 1;
+    }
+  }
+  return low;
+}
+
+int main(int argc, char** argv)
+{
+  prng_t prng;
+  timing_t malloc_time = {0};
+  timing_t free_time = {0};
+  uint32_t failures = 0;
+  uint64_t frag_sum = 0;
+  uint32_t frag_max = 0;
+  uint32_t samples = 0;
+
+  if(argc > 1 && strcmp(argv[1], "--header") == 0)
+  {
+    printf("%-7s %9s %8s %6s %7s %7s %8s %8s %9s %9s %7s %7s %7s\r\n", "heap", "mallocs",
+           "failed", "", "frag", "max", "free", "min free", "largest", "malloc ns", "max",
+           "free ns", "max");
+    return 0;
+  }
+
+  prng_seed(&prng, STRESS_SEED, 0);
+
+  for(uint32_t step = 0; step < STRESS_STEPS; step++)
+  {
+    void** pp_slot = &m_slots[prng_range(&prng, STRESS_SLOTS)];
+    uint64_t start = now_ns();
+
+    if(*pp_slot != NULL)
+    {
+      vPortFree(*pp_slot);
+      timing_add(&free_time, now_ns() - start);
+      *pp_slot = NULL;
+    }
+    else
+    {
+      size_t size = size_draw(&prng);
+
+      start = now_ns();
+      *pp_slot = pvPortMalloc(size);
+      timing_add(&malloc_time, now_ns() - start);
+      if(*pp_slot == NULL) failures++;
+    }
+
+    if(step % STRESS_SAMPLE_EVERY == STRESS_SAMPLE_EVERY - 1)
+    {
+      uint32_t frag = fragmentation_get();
+
+      frag_sum += frag;
+      if(frag > frag_max) frag_max = frag;
+      samples++;
+    }
+  }
+
+  size_t free = xPortGetFreeHeapSize();
+  size_t min_ever_free = xPortGetMinimumEverFreeHeapSize();
+
+  printf("%-7s %9u %8u %5.2f%% %6u%% %6u%% %8u %8u %9u %9u %7u %7u %7u\r\n", HEAP_NAME,
+         (unsigned)malloc_time.count, (unsigned)failures, 100.0 * failures / malloc_time.count,
+         (unsigned)(frag_sum / samples), (unsigned)frag_max, (unsigned)free, (unsigned)min_ever_free,
+         (unsigned)largest_request_get(),
+         (unsigned)(malloc_time.sum_ns / malloc_time.count), (unsigned)malloc_time.max_ns,
+         (unsigned)(free_time.sum_ns / free_time.count), (unsigned)free_time.max_ns);
+
+  return 0;
+}
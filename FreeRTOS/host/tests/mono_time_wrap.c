@@ -0,0 +1,204 @@
+/*
+  Wrap test of common/mono_time.c against a fake RTC
+
+  The host build of the examples replaces mono_time.c, so the epoch logic
+  is only run here. The 24-bit COUNTER moves on one tick at every register
+  read, the fastest it can against the code, and the overflow interrupt
+  runs at a chosen read or not at all, as for a caller with interrupts
+  masked or at or above MONO_TIME_IRQ_PRIORITY.
+
+  For reads starting up to WRAP_MARGIN ticks before a wrap, with the
+  interrupt at each point of the read, mono_time_ticks_get() must return a
+  time the counter had during the read, never less than the one before, and
+  must not spin waiting for the interrupt. The handler must clear the
+  event and count the wrap with interrupts masked.
+*/
+
+#include "mono_time.h"
+#include "nrf_drv_clock.h"
+#include "nrf_rtc.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define COUNTER_MASK      0xFFFFFFUL
+
+// reads before a wrap the test starts at, and interrupt positions
+#define WRAP_MARGIN       8
+#define IRQ_POSITIONS     8
+
+// a read takes 3 register reads, a few retries when the interrupt runs
+#define MAX_READS         32
+
+void RTC2_IRQHandler(void);
+
+NRF_RTC_Type fake_rtc2;
+
+static uint64_t m_now;          // true ticks since the RTC started
+static bool m_running;
+static bool m_overflow;         // OVERFLOW event
+static bool m_in_irq;
+static bool m_masked;           // inside CRITICAL_REGION_ENTER()
+static uint32_t m_reads;        // register reads of the current mono_time read
+static uint32_t m_irq_at;       // register read the interrupt runs before, 0 masked
+
+static void tick(void)
+{
+  if(!m_running) return;
+  m_now++;
+  if((m_now & COUNTER_MASK) == 0) m_overflow = true;
+}
+
+static void irq_run(void)
+{
+  m_in_irq = true;
+  RTC2_IRQHandler();
+  m_in_irq = false;
+}
+
+// the interrupt preempts the reader between two register reads
+static void register_read(void)
+{
+  if(m_in_irq) return;
+
+  m_reads++;
+  if(m_reads > MAX_READS)
+  {
+    printf("FAIL  read spins, %u register reads at counter 0x%06X\r\n",
+           (unsigned)m_reads, (unsigned)(m_now & COUNTER_MASK));
+    exit(1);
+  }
+  if(m_reads == m_irq_at) irq_run();
+}
+
+// the fake RTC counts from its START task, no clock driver or kernel needed
+void nrf_drv_clock_lfclk_request(nrf_drv_clock_handler_item_t* p_handler_item)
+{
+}
+
+// CRITICAL_REGION_ENTER() of the host app_util_platform.h
+void vPortEnterCritical(void)
+{
+  m_masked = true;
+}
+
+void vPortExitCritical(void)
+{
+  m_masked = false;
+}
+
+void nrf_rtc_task_trigger(NRF_RTC_Type* p_reg, nrf_rtc_task_t task)
+{
+  switch(task)
+  {
+    case NRF_RTC_TASK_START: m_running = true; break;
+    case NRF_RTC_TASK_STOP: m_running = false; break;
+    case NRF_RTC_TASK_CLEAR: m_now = 0; break;
+    case NRF_RTC_TASK_TRIGGER_OVERFLOW: m_now = (m_now & ~(uint64_t)COUNTER_MASK) | 0xFFFFF0UL; break;
+  }
+}
+
+void nrf_rtc_prescaler_set(NRF_RTC_Type* p_reg, uint32_t val)
+{
+}
+
+void nrf_rtc_event_clear(NRF_RTC_Type* p_reg, nrf_rtc_event_t event)
+{
+  // a reader preempting the handler here would lose the wrap
+  if(m_in_irq && !m_masked)
+  {
+    printf("FAIL  overflow event cleared with interrupts unmasked\r\n");
+    exit(1);
+  }
+  m_overflow = false;
+}
+
+bool nrf_rtc_event_pending(NRF_RTC_Type* p_reg, nrf_rtc_event_t event)
+{
+  register_read();
+  bool pending = m_overflow;
+  if(!m_in_irq) tick();
+  return pending;
+}
+
+void nrf_rtc_int_enable(NRF_RTC_Type* p_reg, uint32_t mask)
+{
+}
+
+uint32_t nrf_rtc_counter_get(NRF_RTC_Type* p_reg)
+{
+  register_read();
+  uint32_t counter = (uint32_t)(m_now & COUNTER_MASK);
+  if(!m_in_irq) tick();
+  return counter;
+}
+
+// interrupts unmasked, a pending overflow is counted
+static void settle(void)
+{
+  if(m_overflow) irq_run();
+}
+
+// moves the counter on without reads, counting every wrap on the way
+static void advance_to(uint64_t ticks)
+{
+  while(m_now < ticks)
+  {
+    uint64_t next_wrap = (m_now | COUNTER_MASK) + 1;
+
+    m_now = (ticks < next_wrap) ? ticks : next_wrap;
+    if((m_now & COUNTER_MASK) == 0) m_overflow = true;
+    settle();
+  }
+}
+
+int main(void)
+{
+  uint32_t cases = 0;
+  uint32_t failed = 0;
+  uint64_t last = 0;
+
+  if(mono_time_init() != NRF_SUCCESS)
+  {
+    printf("FAIL  mono_time_init\r\n");
+    return 1;
+  }
+
+  for(uint32_t margin = 0; margin <= WRAP_MARGIN; margin++)
+  {
+    for(uint32_t irq_at = 0; irq_at <= IRQ_POSITIONS; irq_at++)
+    {
+      // next wrap at least a few reads ahead
+      uint64_t wrap = ((m_now + WRAP_MARGIN + 4) | COUNTER_MASK) + 1;
+
+      advance_to(wrap - margin);
+
+      m_reads = 0;
+      m_irq_at = irq_at;
+      uint64_t before = m_now;
+      uint64_t ticks = mono_time_ticks_get();
+      uint64_t after = m_now;
+      m_irq_at = 0;
+
+      cases++;
+      if(ticks < before || ticks >= after || ticks < last)
+      {
+        printf("FAIL  %u ticks before the wrap, interrupt at read %u: got 0x%llX, "
+               "counter 0x%llX..0x%llX, last 0x%llX\r\n",
+               (unsigned)margin, (unsigned)irq_at, (unsigned long long)ticks,
+               (unsigned long long)before, (unsigned long long)(after - 1),
+               (unsigned long long)last);
+        failed++;
+      }
+      last = ticks;
+
+      settle();
+    }
+  }
+
+  printf("mono_time wrap: %u cases, %u failed, %llu wraps\r\n",
+         (unsigned)cases, (unsigned)failed, (unsigned long long)(m_now >> 24));
+
+  return (failed == 0) ? 0 : 1;
+}
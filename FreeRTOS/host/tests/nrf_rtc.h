@@ -0,0 +1,52 @@
+/*
+  Fake RTC of tests/mono_time_wrap.c
+
+  Only what common/mono_time.c touches. The COUNTER, the OVERFLOW event and
+  the interrupt are simulated by the test, every register read moves the
+  counter on by one tick.
+*/
+
+#ifndef NRF_RTC_H
+#define NRF_RTC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct
+{
+  uint32_t unused;
+}NRF_RTC_Type;
+
+typedef enum
+{
+  NRF_RTC_TASK_START,
+  NRF_RTC_TASK_STOP,
+  NRF_RTC_TASK_CLEAR,
+  NRF_RTC_TASK_TRIGGER_OVERFLOW
+}nrf_rtc_task_t;
+
+typedef enum
+{
+  NRF_RTC_EVENT_OVERFLOW
+}nrf_rtc_event_t;
+
+#define NRF_RTC_INT_OVERFLOW_MASK     (1UL << 1)
+
+extern NRF_RTC_Type fake_rtc2;
+
+#define NRF_RTC2                      (&fake_rtc2)
+#define RTC2_IRQn                     36
+
+void nrf_rtc_task_trigger(NRF_RTC_Type* p_reg, nrf_rtc_task_t task);
+void nrf_rtc_prescaler_set(NRF_RTC_Type* p_reg, uint32_t val);
+void nrf_rtc_event_clear(NRF_RTC_Type* p_reg, nrf_rtc_event_t event);
+bool nrf_rtc_event_pending(NRF_RTC_Type* p_reg, nrf_rtc_event_t event);
+void nrf_rtc_int_enable(NRF_RTC_Type* p_reg, uint32_t mask);
+uint32_t nrf_rtc_counter_get(NRF_RTC_Type* p_reg);
+
+// the interrupt runs when the test calls the handler
+static inline void NVIC_SetPriority(int irq, uint32_t priority) {}
+static inline void NVIC_ClearPendingIRQ(int irq) {}
+static inline void NVIC_EnableIRQ(int irq) {}
+
+#endif /* NRF_RTC_H */
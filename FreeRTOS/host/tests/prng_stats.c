@@ -0,0 +1,184 @@
+/*
+  Statistical tests of common/prng.h
+
+  - known answers: the first numbers of the pcg32-demo of the reference
+    implementation, seed 42 and stream 54
+  - chi-square of the bytes of prng_next()
+  - chi-square of prng_range() for a small bound and for 3 * 2^30, where
+    prng_next() % bound would return the lower third twice as often
+  - two generators seeded from the entropy pool give different streams
+
+  Seeds are fixed, a run gives the same statistics every time. The limits
+  are the chi-square values a uniform source exceeds once in 1000 runs.
+
+  For the long tests, stream the raw output into PractRand:
+
+    build/tests/prng_stats --raw | RNG_test stdin32
+*/
+
+#include "prng.h"
+#include "rng_entropy.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SAMPLES           (1UL << 22)
+
+// chi-square at p = 0.001 for 255, 9 and 15 degrees of freedom
+#define CHI2_LIMIT_BYTES  330.5
+#define CHI2_LIMIT_SMALL  27.88
+#define CHI2_LIMIT_LARGE  37.70
+
+#define SMALL_BOUND       10UL
+#define LARGE_BOUND       0xC0000000UL
+#define LARGE_BINS        16
+
+static const uint32_t k_reference[] =
+{
+  0xa15c02b7, 0x7b47f409, 0xba1d3330, 0x83d2f293, 0xbfa4784b, 0xcbed606e
+};
+
+static uint32_t m_failed = 0;
+
+static void check(bool ok, const char* name, double value, double limit)
+{
+  printf("%-4s  %-28s %10.2f  limit %.2f\r\n", ok ? "ok" : "FAIL", name, value, limit);
+  if(!ok) m_failed++;
+}
+
+static double chi_square(const uint32_t* p_counts, uint32_t bins, double expected)
+{
+  double chi2 = 0;
+
+  for(uint32_t i = 0; i < bins; i++)
+  {
+    double d = (double)p_counts[i] - expected;
+    chi2 += d * d / expected;
+  }
+  return chi2;
+}
+
+static void test_reference(void)
+{
+  prng_t prng;
+  uint32_t mismatches = 0;
+
+  prng_seed(&prng, 42, 54);
+  for(uint32_t i = 0; i < sizeof(k_reference) / sizeof(k_reference[0]); i++)
+  {
+    uint32_t value = prng_next(&prng);
+    if(value != k_reference[i])
+    {
+      printf("      number %u: 0x%08x, reference 0x%08x\r\n", (unsigned)i, (unsigned)value,
+             (unsigned)k_reference[i]);
+      mismatches++;
+    }
+  }
+  check(mismatches == 0, "pcg32 reference sequence", mismatches, 0);
+}
+
+static void test_bytes(void)
+{
+  static uint32_t counts[256];
+  prng_t prng;
+
+  prng_seed(&prng, 1, 1);
+  memset(counts, 0, sizeof(counts));
+  for(uint32_t i = 0; i < SAMPLES / 4; i++)
+  {
+    uint32_t value = prng_next(&prng);
+    for(uint32_t b = 0; b < 4; b++) counts[(value >> (8 * b)) & 0xFF]++;
+  }
+
+  double chi2 = chi_square(counts, 256, SAMPLES / 256.0);
+  check(chi2 < CHI2_LIMIT_BYTES, "prng_next() bytes", chi2, CHI2_LIMIT_BYTES);
+}
+
+static void test_range(void)
+{
+  uint32_t small[SMALL_BOUND] = {0};
+  uint32_t large[LARGE_BINS] = {0};
+  uint32_t modulo[LARGE_BINS] = {0};
+  prng_t prng;
+
+  prng_seed(&prng, 2, 2);
+  for(uint32_t i = 0; i < SAMPLES; i++)
+  {
+    uint32_t value = prng_range(&prng, SMALL_BOUND);
+    if(value >= SMALL_BOUND)
+    {
+      printf("FAIL  prng_range(%lu) returned %u\r\n", SMALL_BOUND, (unsigned)value);
+      m_failed++;
+      return;
+    }
+    small[value]++;
+  }
+
+  prng_seed(&prng, 3, 3);
+  for(uint32_t i = 0; i < SAMPLES; i++)
+  {
+    uint32_t value = prng_range(&prng, LARGE_BOUND);
+    if(value >= LARGE_BOUND)
+    {
+      printf("FAIL  prng_range(0x%lX) returned 0x%X\r\n", LARGE_BOUND, (unsigned)value);
+      m_failed++;
+      return;
+    }
+    large[(uint64_t)value * LARGE_BINS / LARGE_BOUND]++;
+    modulo[(uint64_t)(prng_next(&prng) % LARGE_BOUND) * LARGE_BINS / LARGE_BOUND]++;
+  }
+
+  double chi2 = chi_square(small, SMALL_BOUND, (double)SAMPLES / SMALL_BOUND);
+  check(chi2 < CHI2_LIMIT_SMALL, "prng_range(10)", chi2, CHI2_LIMIT_SMALL);
+
+  chi2 = chi_square(large, LARGE_BINS, (double)SAMPLES / LARGE_BINS);
+  check(chi2 < CHI2_LIMIT_LARGE, "prng_range(3 * 2^30)", chi2, CHI2_LIMIT_LARGE);
+
+  // the same test must see the bias of the modulo, or it proves nothing
+  chi2 = chi_square(modulo, LARGE_BINS, (double)SAMPLES / LARGE_BINS);
+  check(chi2 >= CHI2_LIMIT_LARGE, "modulo 3 * 2^30, biased", chi2, CHI2_LIMIT_LARGE);
+}
+
+static void test_entropy_seed(void)
+{
+  prng_t a;
+  prng_t b;
+  uint32_t equal = 0;
+
+  prng_seed_from_entropy(&a);
+  prng_seed_from_entropy(&b);
+  for(uint32_t i = 0; i < 64; i++)
+  {
+    if(prng_next(&a) == prng_next(&b)) equal++;
+  }
+  check(equal == 0, "entropy seeded streams equal", equal, 0);
+}
+
+static int raw_output(void)
+{
+  static uint32_t buf[4096];
+  prng_t prng;
+
+  prng_seed_from_entropy(&prng);
+  while(true)
+  {
+    for(uint32_t i = 0; i < sizeof(buf) / sizeof(buf[0]); i++) buf[i] = prng_next(&prng);
+    if(fwrite(buf, sizeof(buf), 1, stdout) != 1) return 0;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  (void)rng_entropy_init();
+
+  if(argc > 1 && strcmp(argv[1], "--raw") == 0) return raw_output();
+
+  test_reference();
+  test_bytes();
+  test_range();
+  test_entropy_seed();
+
+  printf("prng: %u failed\r\n", (unsigned)m_failed);
+  return (m_failed == 0) ? 0 : 1;
+}
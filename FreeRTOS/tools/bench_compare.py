@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""Compare the JSON lines of common/bench.h with a stored baseline.
+
+The console capture can hold any other text, only lines with a JSON object
+are read. A case regresses when its median or p99 cycles grew by more than
+the threshold over the baseline, then the exit status is 1. Runs on a
+different clock or clock rate than the baseline are not compared, and
+without a baseline nothing is, both exit with 2. Save one with --update.
+
+    bench_compare.py console.log --baseline bench_baseline.jsonl
+    bench_compare.py console.log --baseline bench_baseline.jsonl --update
+    bench_compare.py console.log --threshold 5 --p99-threshold 20
+"""
+
+import argparse
+import json
+import os
+import sys
+
+FIELDS = ("min", "median", "p99", "max")
+
+
+def parse(stream):
+    """Results keyed by (suite, case) and the done count of each suite."""
+    results = {}
+    done = {}
+    for raw in stream:
+        line = raw.decode("latin-1") if isinstance(raw, bytes) else raw
+        start = line.find("{")
+        if start < 0:
+            continue
+        try:
+            obj = json.loads(line[start:])
+        except ValueError:
+            continue
+        if not isinstance(obj, dict) or "suite" not in obj:
+            continue
+        if "done" in obj:
+            done[obj["suite"]] = obj["done"]
+        elif "case" in obj and all(f in obj for f in FIELDS):
+            # a repeated case keeps the last run of the capture
+            results[(obj["suite"], obj["case"])] = obj
+    return results, done
+
+
+def load(path):
+    with open(path, "rb") as f:
+        return parse(f)[0]
+
+
+def save(path, results):
+    with open(path, "w") as f:
+        for key in sorted(results):
+            f.write(json.dumps(results[key], sort_keys=True) + "\n")
+
+
+def change(new, old):
+    if old == 0:
+        return 0.0 if new == 0 else float("inf")
+    return (new - old) * 100.0 / old
+
+
+def compare(results, baseline, threshold, p99_threshold):
+    """Table lines and the number of regressions."""
+    out = []
+    regressions = 0
+    out.append("%-12s %-16s %10s %10s %8s %10s %10s %8s"
+               % ("suite", "case", "median", "base", "change", "p99", "base", "change"))
+    for key in sorted(set(results) | set(baseline)):
+        suite, case = key
+        new = results.get(key)
+        old = baseline.get(key)
+        if new is None:
+            out.append("%-12s %-16s %s" % (suite, case, "not in this run"))
+            continue
+        if old is None:
+            out.append("%-12s %-16s %10u %10s %8s %10u %10s %8s  new"
+                       % (suite, case, new["median"], "-", "-", new["p99"], "-", "-"))
+            continue
+        median = change(new["median"], old["median"])
+        p99 = change(new["p99"], old["p99"])
+        flags = []
+        if median > threshold:
+            flags.append("median")
+        if p99 > p99_threshold:
+            flags.append("p99")
+        if flags:
+            regressions += 1
+        out.append("%-12s %-16s %10u %10u %+7.1f%% %10u %10u %+7.1f%%%s"
+                   % (suite, case, new["median"], old["median"], median,
+                      new["p99"], old["p99"], p99,
+                      "  REGRESSED " + ",".join(flags) if flags else ""))
+    return out, regressions
+
+
+def clock_mismatch(results, baseline):
+    clocks = {(r.get("clock"), r.get("hz")) for r in results.values()}
+    base_clocks = {(r.get("clock"), r.get("hz")) for r in baseline.values()}
+    if base_clocks and clocks and clocks != base_clocks:
+        return "clock %s of the run, %s of the baseline" % (sorted(clocks), sorted(base_clocks))
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", nargs="?", default="-", help="console capture, default stdin")
+    parser.add_argument("--baseline", default="bench_baseline.jsonl",
+                        help="baseline results, one JSON line per case")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="allowed median growth in percent, default 10")
+    parser.add_argument("--p99-threshold", type=float, default=25.0,
+                        help="allowed p99 growth in percent, default 25, p99 also "
+                             "carries the tick and other tasks")
+    parser.add_argument("--update", action="store_true",
+                        help="write the results of this run as the new baseline")
+    args = parser.parse_args()
+
+    stream = sys.stdin.buffer if args.input == "-" else open(args.input, "rb")
+    try:
+        results, done = parse(stream)
+    finally:
+        if stream is not sys.stdin.buffer:
+            stream.close()
+
+    if not results:
+        print("no benchmark results in the capture", file=sys.stderr)
+        return 2
+
+    # a suite without its done line stopped early, the cases it still had
+    # would show up as missing instead of failing the run
+    suites = {suite for suite, _ in results}
+    incomplete = sorted(suite for suite in suites
+                        if done.get(suite) != sum(1 for s, _ in results if s == suite))
+    for suite in incomplete:
+        print("warning: suite %s did not complete" % suite, file=sys.stderr)
+
+    if args.update:
+        merged = load(args.baseline) if os.path.exists(args.baseline) else {}
+        # a baseline on another clock is replaced, not mixed
+        if clock_mismatch(results, merged):
+            merged = {}
+        merged.update(results)
+        save(args.baseline, merged)
+        print("%u cases saved to %s" % (len(results), args.baseline))
+        return 1 if incomplete else 0
+
+    baseline = load(args.baseline) if os.path.exists(args.baseline) else {}
+    if not baseline:
+        print("no baseline in %s, save one with --update" % args.baseline, file=sys.stderr)
+        return 2
+    mismatch = clock_mismatch(results, baseline)
+    if mismatch:
+        print("not comparable, %s" % mismatch, file=sys.stderr)
+        return 2
+
+    lines, regressions = compare(results, baseline, args.threshold, args.p99_threshold)
+    print("\n".join(lines))
+    if regressions:
+        print("\n%u of %u cases regressed" % (regressions, len(results)))
+    return 1 if regressions or incomplete else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,238 @@
+#!/usr/bin/env python3
+"""Decode the BIN_LOG() stream of common/bin_log.h on the host.
+
+The format strings are read from the .bin_log_fmt section of the ELF file the
+target runs. Text written with printf() or async_log_printf() in the same
+stream is passed through unchanged.
+
+    bin_log_decode.py app.elf /dev/ttyACM0      # after stty -F ... raw 115200
+    bin_log_decode.py app.elf capture.bin --stats
+    bin_log_decode.py app.elf --list
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+HEADER_SIZE = 4
+TIMESTAMP_FLAG = 0x80
+NARGS_MASK = 0x0F
+MAX_ARGS = 8
+TICKS_PER_SEC = 32768
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 0x2
+
+CONVERSION = re.compile(
+    r"%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<prec>\*|\d*))?"
+    r"(?P<length>hh|h|ll|l|j|z|t|L)?(?P<conv>[diouxXcspfFeEgGaAn%])")
+
+
+class Elf:
+    """Minimal ELF32 little endian reader, enough for section contents."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError("%s is not a 32-bit little endian ELF file" % path)
+        shoff, = struct.unpack_from("<I", self.data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x2E)
+        headers = [struct.unpack_from("<IIIIIIIIII", self.data, shoff + i * shentsize)
+                   for i in range(shnum)]
+        strtab = headers[shstrndx]
+        self.sections = []
+        for name, stype, flags, addr, offset, size in (h[:6] for h in headers):
+            start = strtab[4] + name
+            sname = self.data[start:self.data.index(b"\0", start)].decode()
+            self.sections.append((sname, stype, flags, addr, offset, size))
+
+    def section(self, name):
+        for sname, _, _, addr, offset, size in self.sections:
+            if sname == name:
+                return addr, self.data[offset:offset + size]
+        return None, None
+
+    def string_at(self, address):
+        """NUL terminated string at a target address in a loaded section."""
+        for _, stype, flags, addr, offset, size in self.sections:
+            if stype == SHT_PROGBITS and flags & SHF_ALLOC and addr <= address < addr + size:
+                start = offset + address - addr
+                end = self.data.find(b"\0", start, offset + size)
+                return self.data[start:end if end >= 0 else offset + size].decode("latin-1")
+        return None
+
+
+def count_args(fmt):
+    count = 0
+    for m in CONVERSION.finditer(fmt):
+        if m.group("conv") == "%":
+            continue
+        count += 1 + (m.group("width") == "*") + (m.group("prec") == "*")
+    return count
+
+
+def to_signed(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def format_message(fmt, args, elf):
+    """printf() the way the target would have, from raw 32-bit arguments."""
+    args = list(args)
+    out = []
+    pos = 0
+    for m in CONVERSION.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        conv = m.group("conv")
+        if conv == "%":
+            out.append("%")
+            continue
+        width = m.group("width") or ""
+        prec = m.group("prec")
+        if width == "*":
+            width = str(to_signed(args.pop(0)))
+        if prec == "*":
+            prec = str(to_signed(args.pop(0)))
+        spec = "%" + m.group("flags") + width + ("." + prec if prec is not None else "")
+        value = args.pop(0)
+        if m.group("length") in ("ll", "j", "L") or conv in "fFeEgGaAn":
+            out.append("<%%%s unsupported>" % ((m.group("length") or "") + conv))
+        elif conv in "di":
+            out.append((spec + "d") % to_signed(value))
+        elif conv in "uoxX":
+            out.append((spec + ("d" if conv == "u" else conv)) % value)
+        elif conv == "c":
+            out.append((spec + "c") % chr(value & 0xFF))
+        elif conv == "p":
+            out.append("0x%08x" % value)
+        else:
+            text = elf.string_at(value)
+            out.append((spec + "s") % (text if text is not None else "<0x%08x>" % value))
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+class Decoder:
+    def __init__(self, elf):
+        self.elf = elf
+        _, self.table = elf.section(".bin_log_fmt")
+        if self.table is None:
+            raise ValueError("no .bin_log_fmt section, check flash_placement.xml")
+        self.buffer = bytearray()
+        self.last_ticks = None
+        self.last_full = 0
+        self.frames = 0
+        self.frame_bytes = 0
+        self.text_bytes = 0
+        self.decoded_bytes = 0
+        self.resyncs = 0
+
+    def format_for(self, fmt_id):
+        # an id must point at the first character of one of the strings
+        if fmt_id >= len(self.table) or (fmt_id > 0 and self.table[fmt_id - 1] != 0):
+            return None
+        end = self.table.index(b"\0", fmt_id)
+        return self.table[fmt_id:end].decode("latin-1")
+
+    def timestamp(self, ticks):
+        # target sends the low 32 bits of the 64-bit tick count. The step from
+        # the last frame is signed 32-bit: a wrap steps forward, a frame queued
+        # out of order steps back and is shown as it is
+        full = ticks
+        if self.last_ticks is not None:
+            step = ((ticks - self.last_ticks + (1 << 31)) & 0xFFFFFFFF) - (1 << 31)
+            full = self.last_full + step
+        self.last_ticks = ticks
+        self.last_full = full
+        return "[%6u.%06u] " % (full // TICKS_PER_SEC, (full % TICKS_PER_SEC) * 1000000 // TICKS_PER_SEC)
+
+    def feed(self, data):
+        """Decode as much of the buffered stream as possible, return the text."""
+        self.buffer += data
+        out = []
+        while self.buffer:
+            sync = self.buffer.find(SYNC)
+            if sync != 0:
+                text = self.buffer if sync < 0 else self.buffer[:sync]
+                out.append(text.decode("latin-1"))
+                self.text_bytes += len(text)
+                del self.buffer[:len(text)]
+                continue
+            if len(self.buffer) < HEADER_SIZE:
+                break
+            fmt_id = self.buffer[1] | (self.buffer[2] << 8)
+            nargs = self.buffer[3] & NARGS_MASK
+            has_time = bool(self.buffer[3] & TIMESTAMP_FLAG)
+            fmt = self.format_for(fmt_id)
+            if fmt is None or nargs > MAX_ARGS or count_args(fmt) != nargs \
+                    or self.buffer[3] & ~(NARGS_MASK | TIMESTAMP_FLAG):
+                # not a frame start, drop the sync byte and look again
+                self.resyncs += 1
+                del self.buffer[0]
+                continue
+            size = HEADER_SIZE + 4 * has_time + 4 * nargs
+            if len(self.buffer) < size:
+                break
+            words = struct.unpack_from("<%dI" % (has_time + nargs), self.buffer, HEADER_SIZE)
+            prefix = self.timestamp(words[0]) if has_time else ""
+            text = prefix + format_message(fmt, words[has_time:], self.elf)
+            out.append(text)
+            self.frames += 1
+            self.frame_bytes += size
+            self.decoded_bytes += len(text) - len(prefix)
+            del self.buffer[:size]
+        return "".join(out)
+
+    def stats(self):
+        ratio = self.decoded_bytes / self.frame_bytes if self.frame_bytes else 0.0
+        return ("%u frames, %u bytes on the wire for %u bytes of text (%.1fx), "
+                "%u bytes plain text, %u resyncs"
+                % (self.frames, self.frame_bytes, self.decoded_bytes, ratio,
+                   self.text_bytes, self.resyncs))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="ELF file of the running firmware")
+    parser.add_argument("input", nargs="?", default="-",
+                        help="captured stream or serial device, default stdin")
+    parser.add_argument("--list", action="store_true", help="print the format string table")
+    parser.add_argument("--stats", action="store_true", help="print bandwidth figures at the end")
+    args = parser.parse_args()
+
+    decoder = Decoder(Elf(args.elf))
+
+    if args.list:
+        fmt_id = 0
+        while fmt_id < len(decoder.table):
+            fmt = decoder.format_for(fmt_id)
+            if fmt:
+                print("%5u  %r" % (fmt_id, fmt))
+                fmt_id += len(fmt)
+            fmt_id += 1
+        return 0
+
+    stream = sys.stdin.buffer if args.input == "-" else open(args.input, "rb", buffering=0)
+    try:
+        while True:
+            chunk = stream.read(256)
+            if not chunk:
+                break
+            sys.stdout.write(decoder.feed(chunk))
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if stream is not sys.stdin.buffer:
+            stream.close()
+
+    if args.stats:
+        sys.stderr.write(decoder.stats() + "\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
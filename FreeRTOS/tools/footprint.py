@@ -0,0 +1,415 @@
+#!/usr/bin/env python3
+"""Split the flash and RAM of an example into kernel, nRF SDK and application.
+
+Reads the GNU ld map file or the ELF file of a SES build. Each input section
+or symbol goes to a component by the emProject folder of its object: Third
+Parties is the kernel, Common the common/ modules, Application the example
+and the other folders the nRF5 SDK. Library members are the toolchain, and
+what no object claims, fill, heap and stack reservations, is other. Without
+an emProject the object names decide.
+
+The ELF file only names the object of static symbols, global symbols go to
+the kernel or the SDK by their naming and to other elsewhere, the map file
+gives the full split.
+
+    footprint.py Output/Release/Exe/queue_pca10056.map --top 20
+    footprint.py queue_pca10056.elf --project queue_pca10056.emProject
+    footprint.py --examples Release --save before.json
+    footprint.py --examples Release --compare before.json    # after a config change
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import struct
+import sys
+
+from bin_log_decode import Elf
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+COMPONENTS = ("kernel", "nrf", "common", "app", "toolchain", "other")
+
+FOLDER_COMPONENTS = {
+    "Third Parties": "kernel",
+    "Common": "common",
+    "Application": "app",
+    "Segger Startup Files": "toolchain",
+}
+
+# object names of the kernel and the SDK, for builds without an emProject
+KERNEL_OBJECTS = {"croutine", "event_groups", "list", "port", "port_cmsis", "port_cmsis_systick",
+                  "queue", "stream_buffer", "tasks", "timers",
+                  "heap_1", "heap_2", "heap_3", "heap_4", "heap_5"}
+NRF_OBJECT = re.compile(r"^(nrf|nrfx|app|bsp|boards|system_nrf|ses_startup|SEGGER)")
+
+# global symbols of an ELF file, by the FreeRTOS and nRF5 SDK naming
+KERNEL_SYMBOL = re.compile(r"^(x|v|ux|pv|pc|ul|uc|px|e)(Task|Queue|Timer|EventGroup|List|Port|"
+                           r"StreamBuffer|CoRoutine)|^pxCurrentTCB$|^(SVC|PendSV|SysTick)_Handler$")
+NRF_SYMBOL = re.compile(r"^(nrf_|nrfx_|app_|bsp_|m_nrf|NRF_|SystemInit$|SystemCoreClock$)")
+TOOLCHAIN_SYMBOL = re.compile(r"^_")
+
+# input sections by where they cost, everything else allocated is flash
+RAM_ONLY = (".bss", "COMMON", ".tbss", ".non_init", ".noinit", ".heap", ".stack", ".vectors_ram")
+RAM_INIT = (".data", ".fast", ".tdata", ".log_dynamic_data", ".log_filter_data")
+NOT_LOADED = (".debug", ".comment", ".ARM.attributes", ".stab", ".note", ".gnu.attributes")
+
+RAM_START = 0x20000000
+
+SHT_SYMTAB = 2
+PT_LOAD = 1
+STT_OBJECT = 1
+STT_FUNC = 2
+STT_FILE = 4
+STB_LOCAL = 0
+SHN_UNDEF = 0
+SHN_LORESERVE = 0xFF00
+
+MAP_START = "Linker script and memory map"
+INPUT_LINE = re.compile(r"^ (\*fill\*|[.\w][^\s]*|COMMON)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(\S.*?))?)?\s*$")
+OUTPUT_LINE = re.compile(r"^([.\w][^\s]*)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)"
+                         r"(?:\s+load address\s+0x([0-9a-fA-F]+))?)?\s*$")
+CONTINUATION = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(\S.*?))?\s*$")
+LOAD_ADDRESS = re.compile(r"load address\s+0x([0-9a-fA-F]+)")
+
+
+def cost(section, size):
+    """(flash, ram) bytes of an allocated section."""
+    if section.startswith(RAM_ONLY):
+        return 0, size
+    if section.startswith(RAM_INIT):
+        return size, size
+    return size, 0
+
+
+def stem(path):
+    # lib.a(member.o) is shown as the member
+    m = re.search(r"\(([^)]+)\)$", path)
+    return os.path.splitext(os.path.basename(m.group(1) if m else path))[0]
+
+
+def project_folders(path):
+    """Object name -> emProject folder."""
+    with open(path) as f:
+        text = f.read()
+    folders = {}
+    for m in re.finditer(r'<folder Name="([^"]+)">(.*?)</folder>', text, re.S):
+        for name in re.findall(r'file_name="([^"]+)"', m.group(2)):
+            folders[stem(name)] = m.group(1)
+    return folders
+
+
+def find_project(path):
+    """emProject in the directories above a build output."""
+    directory = os.path.dirname(os.path.abspath(path))
+    for _ in range(5):
+        found = glob.glob(os.path.join(directory, "*.emProject"))
+        if len(found) == 1:
+            return found[0]
+        directory = os.path.dirname(directory)
+    return None
+
+
+class Classifier:
+    def __init__(self, folders):
+        self.folders = folders
+        self.common = {stem(p) for p in glob.glob(os.path.join(ROOT, "common", "*.c"))}
+
+    def object(self, obj):
+        if obj is None:
+            return "other"
+        if "(" in obj or obj.endswith(".a"):
+            return "toolchain"
+        name = stem(obj)
+        if self.folders is not None:
+            folder = self.folders.get(name)
+            if folder is not None:
+                return FOLDER_COMPONENTS.get(folder, "nrf")
+            return "toolchain" if obj.endswith(".o") else "other"
+        if name in KERNEL_OBJECTS:
+            return "kernel"
+        if NRF_OBJECT.match(name):
+            return "nrf"
+        if name in self.common:
+            return "common"
+        return "app" if obj.endswith(".o") else "other"
+
+    def symbol(self, name):
+        if KERNEL_SYMBOL.match(name):
+            return "kernel"
+        if NRF_SYMBOL.match(name):
+            return "nrf"
+        if TOOLCHAIN_SYMBOL.match(name):
+            return "toolchain"
+        return "other"
+
+
+class Footprint:
+    def __init__(self):
+        self.flash = 0
+        self.ram = 0
+        self.items = {}             # "object\tname" -> [component, flash, ram]
+
+    def add(self, component, obj, name, flash, ram):
+        key = "%s\t%s" % (obj or "", name)
+        item = self.items.setdefault(key, [component, 0, 0])
+        item[1] += flash
+        item[2] += ram
+
+    def components(self):
+        totals = {c: [0, 0] for c in COMPONENTS}
+        for component, flash, ram in self.items.values():
+            totals[component][0] += flash
+            totals[component][1] += ram
+        # fill, alignment and reservations no object claims
+        totals["other"][0] += self.flash - sum(t[0] for t in totals.values())
+        totals["other"][1] += self.ram - sum(t[1] for t in totals.values())
+        return totals
+
+    def to_json(self):
+        return {"flash": self.flash, "ram": self.ram, "items": self.items}
+
+    @staticmethod
+    def from_json(obj):
+        fp = Footprint()
+        fp.flash = obj["flash"]
+        fp.ram = obj["ram"]
+        fp.items = obj["items"]
+        return fp
+
+
+def item_name(section):
+    for prefix in (".text.", ".rodata.", ".data.", ".bss.", ".tbss.", ".tdata."):
+        if section.startswith(prefix):
+            return section[len(prefix):]
+    return section
+
+
+def parse_map(path, classifier):
+    fp = Footprint()
+    output = None
+    pending = None              # (name, is_output) of a name on a line of its own
+    started = False
+    with open(path, encoding="latin-1") as f:
+        for line in f:
+            line = line.rstrip("\r\n")
+            if not started:
+                started = line.startswith(MAP_START)
+                continue
+            if not line.strip() or line.startswith(("LOAD ", "OUTPUT(", "START GROUP", "END GROUP")):
+                continue
+
+            if pending is not None:
+                m = CONTINUATION.match(line)
+                name, is_output = pending
+                pending = None
+                if m is not None:
+                    fields = (name, m.group(1), m.group(2), m.group(3))
+                    if is_output:
+                        load = LOAD_ADDRESS.search(line)
+                        output = section_total(fp, fields[:3] + (load.group(1) if load else None,))
+                    else:
+                        input_section(fp, classifier, output, fields)
+                    continue
+
+            if not line[0].isspace():
+                m = OUTPUT_LINE.match(line)
+                if m is None:
+                    continue
+                if m.group(2) is None:
+                    pending = (m.group(1), True)
+                else:
+                    output = section_total(fp, m.groups())
+                continue
+
+            m = INPUT_LINE.match(line)
+            if m is None:
+                continue
+            if m.group(2) is None:
+                pending = (m.group(1), False)
+            else:
+                input_section(fp, classifier, output, m.groups())
+    return fp
+
+
+def section_total(fp, fields):
+    """Add an output section to the totals, returns its name if allocated."""
+    name, address, size, load = fields[0], int(fields[1], 16), int(fields[2], 16), fields[3]
+    if name.startswith(NOT_LOADED) or size == 0:
+        return None if name.startswith(NOT_LOADED) else name
+    if address >= RAM_START:
+        fp.ram += size
+        # initialised RAM of a single output section, its image is in flash
+        if load is not None and int(load, 16) < RAM_START:
+            fp.flash += size
+    else:
+        fp.flash += size
+    return name
+
+
+def input_section(fp, classifier, output, fields):
+    name, size, obj = fields[0], int(fields[2], 16), fields[3]
+    if output is None or size == 0:
+        return
+    if name == "*fill*":
+        return
+    flash, ram = cost(name, size)
+    fp.add(classifier.object(obj), stem(obj) if obj else None, item_name(name), flash, ram)
+
+
+def parse_elf(path, classifier):
+    elf = Elf(path)
+    data = elf.data
+    fp = Footprint()
+
+    # loaded images in flash, and RAM of every segment that lives there
+    phoff, = struct.unpack_from("<I", data, 0x1C)
+    phentsize, phnum = struct.unpack_from("<HH", data, 0x2A)
+    for i in range(phnum):
+        ptype, _, vaddr, paddr, filesz, memsz, _, _ = struct.unpack_from("<IIIIIIII", data, phoff + i * phentsize)
+        if ptype != PT_LOAD:
+            continue
+        if paddr < RAM_START:
+            fp.flash += filesz
+        if vaddr >= RAM_START:
+            fp.ram += memsz
+
+    symtab = next((s for s in elf.sections if s[1] == SHT_SYMTAB), None)
+    if symtab is None:
+        return fp
+    _, strtab = elf.section(".strtab")
+    obj = None
+    for offset in range(symtab[4], symtab[4] + symtab[5] - 15, 16):
+        name, value, size, info, _, shndx = struct.unpack_from("<IIIBBH", data, offset)
+        end = strtab.index(b"\0", name)
+        sname = strtab[name:end].decode("latin-1")
+        stype, bind = info & 0xF, info >> 4
+        if stype == STT_FILE:
+            obj = sname
+            continue
+        if stype not in (STT_FUNC, STT_OBJECT) or size == 0 or shndx == SHN_UNDEF or shndx >= SHN_LORESERVE:
+            continue
+        section = elf.sections[shndx][0]
+        flash, ram = cost(section, size)
+        if bind == STB_LOCAL and obj is not None:
+            fp.add(classifier.object(stem(obj) + ".o"), stem(obj), sname, flash, ram)
+        else:
+            fp.add(classifier.symbol(sname), None, sname, flash, ram)
+    return fp
+
+
+def load(path, project):
+    folders = project_folders(project) if project else None
+    classifier = Classifier(folders)
+    with open(path, "rb") as f:
+        is_elf = f.read(4) == b"\x7fELF"
+    return parse_elf(path, classifier) if is_elf else parse_map(path, classifier)
+
+
+def delta(new, old):
+    if old is None:
+        return ""
+    return "%+d" % (new - old) if new != old else ""
+
+
+def report(name, fp, base, top):
+    out = []
+    totals = fp.components()
+    base_totals = base.components() if base else {}
+    out.append("%s" % name)
+    out.append("  %-10s %8s %8s %8s %8s" % ("", "flash", "", "RAM", ""))
+    for component in COMPONENTS + ("total",):
+        if component == "total":
+            flash, ram = fp.flash, fp.ram
+            old = (base.flash, base.ram) if base else (None, None)
+        else:
+            flash, ram = totals[component]
+            old = base_totals.get(component, (None, None))
+        out.append("  %-10s %8u %8s %8u %8s" % (component, flash, delta(flash, old[0]), ram, delta(ram, old[1])))
+
+    if base:
+        # what a configuration change added or removed, by size of the change
+        keys = set(fp.items) | set(base.items)
+        changes = []
+        for key in keys:
+            new = fp.items.get(key, [None, 0, 0])
+            old = base.items.get(key, [None, 0, 0])
+            if new[1:] != old[1:]:
+                changes.append((abs(new[1] - old[1]) + abs(new[2] - old[2]), key,
+                                new[0] or old[0], new[1] - old[1], new[2] - old[2]))
+        changes.sort(key=lambda c: (-c[0], c[1]))
+        if changes:
+            out.append("  changed:")
+        for _, key, component, dflash, dram in changes[:top]:
+            obj, sym = key.split("\t")
+            out.append("    %-9s %-16s %-32s %+7d %+7d" % (component, obj, sym, dflash, dram))
+    elif top:
+        items = sorted(fp.items.items(), key=lambda i: (-(i[1][1] + i[1][2]), i[0]))
+        out.append("  largest:")
+        for key, (component, flash, ram) in items[:top]:
+            obj, sym = key.split("\t")
+            out.append("    %-9s %-16s %-32s %7u %7u" % (component, obj, sym, flash, ram))
+    return "\n".join(out)
+
+
+def examples(configuration):
+    """(example name, build output, emProject) of every example built."""
+    found = []
+    for project in sorted(glob.glob(os.path.join(ROOT, "*", "*", "pca10056", "blank", "ses", "*.emProject"))):
+        exe = os.path.join(os.path.dirname(project), "Output", configuration, "Exe")
+        for ext in (".map", ".elf"):
+            path = os.path.join(exe, stem(project) + ext)
+            if os.path.exists(path):
+                found.append((os.path.relpath(project, ROOT).split(os.sep)[1], path, project))
+                break
+    return found
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", nargs="?", help="map or ELF file of one build")
+    parser.add_argument("--project", help="emProject of the build, default the one above the input")
+    parser.add_argument("--examples", metavar="CONFIGURATION",
+                        help="every example built in this configuration, Release or Debug")
+    parser.add_argument("--top", type=int, default=10,
+                        help="largest items, or largest changes with --compare, default 10")
+    parser.add_argument("--save", help="write the footprint as JSON to this file")
+    parser.add_argument("--compare", help="JSON of an earlier --save to diff against")
+    args = parser.parse_args()
+
+    if args.examples:
+        builds = examples(args.examples)
+        if not builds:
+            print("no example built in Output/%s/Exe" % args.examples, file=sys.stderr)
+            return 1
+    elif args.input:
+        project = args.project or find_project(args.input)
+        builds = [(stem(args.input), args.input, project)]
+    else:
+        parser.error("give a map or ELF file or --examples")
+
+    base = {}
+    if args.compare:
+        with open(args.compare) as f:
+            base = {name: Footprint.from_json(obj) for name, obj in json.load(f).items()}
+
+    results = {}
+    for name, path, project in builds:
+        results[name] = load(path, project)
+
+    # a single build compares with a single saved one whatever their names
+    if len(results) == 1 and len(base) == 1:
+        base = {next(iter(results)): next(iter(base.values()))}
+
+    print("\n\n".join(report(name, fp, base.get(name), args.top) for name, fp in results.items()))
+
+    if args.save:
+        with open(args.save, "w") as f:
+            json.dump({name: fp.to_json() for name, fp in results.items()}, f, indent=1, sort_keys=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,238 @@
+#!/usr/bin/env python3
+"""Rebuild heap usage from the HT lines of common/heap_trace.h.
+
+The console capture can hold any other text, only lines starting with "HT "
+are read. Caller addresses are shown as function+offset when the ELF file of
+the firmware is given.
+
+    heap_trace.py console.log --elf app.elf
+    heap_trace.py console.log --elf app.elf --min-age 600     # soak test leaks
+    heap_trace.py console.log --timeline heap.csv
+"""
+
+import argparse
+import bisect
+import re
+import struct
+import sys
+from collections import defaultdict
+
+from bin_log_decode import Elf
+
+LINE = re.compile(r"HT ([SAFL])((?: [0-9a-fA-F]+)+)\s*$")
+DEFAULT_TICK_RATE = 1024
+
+STT_FUNC = 2
+
+
+class Symbols:
+    """Function symbols of an ELF file, for caller addresses."""
+
+    def __init__(self, elf):
+        self.starts = []
+        self.entries = []
+        _, symtab = elf.section(".symtab")
+        _, strtab = elf.section(".strtab")
+        if symtab is None or strtab is None:
+            return
+        funcs = []
+        for offset in range(0, len(symtab) - 15, 16):
+            name, value, size, info, _, _ = struct.unpack_from("<IIIBBH", symtab, offset)
+            if info & 0xF != STT_FUNC or value == 0:
+                continue
+            end = strtab.index(b"\0", name)
+            # Thumb functions have bit 0 set in their symbol value
+            funcs.append((value & ~1, max(size, 1), strtab[name:end].decode("latin-1")))
+        funcs.sort()
+        self.starts = [start for start, _, _ in funcs]
+        self.entries = funcs
+
+    def name(self, address):
+        ret = address & ~1
+        # a return address points after the call, look up the byte before it
+        i = bisect.bisect_right(self.starts, ret - 1) - 1
+        if i >= 0:
+            start, size, name = self.entries[i]
+            if ret - 1 < start + size:
+                return "%s+0x%x" % (name, ret - start)
+        return "0x%08x" % address
+
+
+class NoSymbols:
+    def name(self, address):
+        return "0x%08x" % address
+
+
+class Trace:
+    def __init__(self):
+        self.tick_rate = DEFAULT_TICK_RATE
+        self.live = {}              # ptr -> (tick, caller, size)
+        self.in_use = 0
+        self.peak = 0
+        self.peak_tick = 0
+        self.events = []            # (tick, caller, ptr, size, is_alloc) in order
+        self.peak_index = 0
+        self.allocs = 0
+        self.frees = 0
+        self.failures = []          # (tick, caller, size, in_use)
+        self.lost = 0
+        self.unmatched_frees = 0
+        self.timeline = []          # (tick, in_use)
+        self.last_tick = None
+        self.last_full = 0
+
+    def full_tick(self, tick):
+        # the target sends a 32-bit tick count. The step from the last record
+        # is signed 32-bit: a wrap steps forward, a record out of order steps
+        # back and keeps its own time
+        full = tick
+        if self.last_tick is not None:
+            step = ((tick - self.last_tick + (1 << 31)) & 0xFFFFFFFF) - (1 << 31)
+            full = self.last_full + step
+        self.last_tick = tick
+        self.last_full = full
+        return full
+
+    def feed(self, kind, fields):
+        if kind == "S":
+            self.tick_rate = fields[1]
+            return
+        if kind == "L":
+            self.lost += fields[0]
+            return
+        tick, caller, ptr, size = self.full_tick(fields[0]), fields[1], fields[2], fields[3]
+        if kind == "A":
+            if ptr == 0:
+                self.failures.append((tick, caller, size, self.in_use))
+                return
+            self.allocs += 1
+            self.live[ptr] = (tick, caller, size)
+            self.in_use += size
+            self.events.append((tick, caller, ptr, size, True))
+            if self.in_use > self.peak:
+                # the live blocks are rebuilt later, copying them at every
+                # new peak would be quadratic for a leaking capture
+                self.peak = self.in_use
+                self.peak_tick = tick
+                self.peak_index = len(self.events)
+        else:
+            self.events.append((tick, caller, ptr, size, False))
+            self.frees += 1
+            block = self.live.pop(ptr, None)
+            if block is None:
+                # allocated before the capture started or in a lost record
+                self.unmatched_frees += 1
+                return
+            self.in_use -= block[2]
+        self.timeline.append((tick, self.in_use))
+
+    def live_at_peak(self):
+        live = {}
+        for tick, caller, ptr, size, is_alloc in self.events[:self.peak_index]:
+            if is_alloc:
+                live[ptr] = (tick, caller, size)
+            else:
+                live.pop(ptr, None)
+        return live
+
+    def seconds(self, tick):
+        return tick / self.tick_rate
+
+
+def parse(stream, trace):
+    for raw in stream:
+        line = raw.decode("latin-1") if isinstance(raw, bytes) else raw
+        start = line.find("HT ")
+        if start < 0:
+            continue
+        m = LINE.match(line[start:])
+        if m is None:
+            continue
+        kind = m.group(1)
+        words = m.group(2).split()
+        if kind in "AF":
+            if len(words) != 4:
+                continue
+            fields = [int(w, 16) for w in words[:3]] + [int(words[3])]
+        else:
+            fields = [int(w) for w in words]
+        trace.feed(kind, fields)
+
+
+def by_caller(blocks, symbols):
+    groups = defaultdict(lambda: [0, 0, None])
+    for tick, caller, size in blocks.values():
+        group = groups[caller]
+        group[0] += 1
+        group[1] += size
+        group[2] = tick if group[2] is None else min(group[2], tick)
+    return sorted(((symbols.name(caller), count, size, oldest)
+                   for caller, (count, size, oldest) in groups.items()),
+                  key=lambda g: -g[2])
+
+
+def report(trace, symbols, min_age):
+    out = []
+    out.append("%u allocations, %u frees, %u failures, %u records lost"
+               % (trace.allocs, trace.frees, len(trace.failures), trace.lost))
+    if trace.lost or trace.unmatched_frees:
+        out.append("warning: %u frees of unknown blocks, figures below only cover "
+                   "what was captured" % trace.unmatched_frees)
+
+    out.append("")
+    out.append("Peak %u bytes at %.3f s, live blocks by caller:"
+               % (trace.peak, trace.seconds(trace.peak_tick)))
+    for name, count, size, _ in by_caller(trace.live_at_peak(), symbols):
+        out.append("  %-40s %5u blocks %8u bytes" % (name, count, size))
+
+    end = trace.last_full
+    leaks = {ptr: block for ptr, block in trace.live.items()
+             if trace.seconds(end - block[0]) >= min_age}
+    out.append("")
+    out.append("Still allocated at %.3f s%s, by caller:"
+               % (trace.seconds(end), " and older than %g s" % min_age if min_age else ""))
+    for name, count, size, oldest in by_caller(leaks, symbols):
+        out.append("  %-40s %5u blocks %8u bytes, oldest from %.3f s"
+                   % (name, count, size, trace.seconds(oldest)))
+
+    if trace.failures:
+        out.append("")
+        out.append("Failed allocations:")
+        for tick, caller, size, in_use in trace.failures:
+            out.append("  %10.3f s  %-40s %6u bytes, %u in use"
+                       % (trace.seconds(tick), symbols.name(caller), size, in_use))
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", nargs="?", default="-", help="console capture, default stdin")
+    parser.add_argument("--elf", help="ELF file of the firmware, to name the callers")
+    parser.add_argument("--min-age", type=float, default=0.0,
+                        help="only report blocks allocated at least this many seconds "
+                             "before the end of the capture as leaks")
+    parser.add_argument("--timeline", help="write time,bytes in use as CSV to this file")
+    args = parser.parse_args()
+
+    symbols = Symbols(Elf(args.elf)) if args.elf else NoSymbols()
+    trace = Trace()
+
+    stream = sys.stdin.buffer if args.input == "-" else open(args.input, "rb")
+    try:
+        parse(stream, trace)
+    finally:
+        if stream is not sys.stdin.buffer:
+            stream.close()
+
+    if args.timeline:
+        with open(args.timeline, "w") as f:
+            f.write("time,bytes\n")
+            for tick, in_use in trace.timeline:
+                f.write("%.4f,%u\n" % (trace.seconds(tick), in_use))
+
+    print(report(trace, symbols, args.min_age))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())